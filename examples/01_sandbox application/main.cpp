@@ -22,6 +22,8 @@ DemoApplication::DemoApplication(const LaunchOptions& options) : Application(opt
 
 	// Initialize Event Handler
 	m_event_handler.Register(&DemoApplication::OnWindowResize, this);
+	m_event_handler.Register(&DemoApplication::OnFilesChanged, this);
+	File::Manager::Watch("assets/shaders/");
 
 	// Initialize UI
 	CreateSimpleUI();
@@ -36,6 +38,10 @@ DemoApplication::DemoApplication(const LaunchOptions& options) : Application(opt
 }
 
 void DemoApplication::ReloadShaders(ActionMap::Key) {
+	CompileShaders();
+}
+
+void DemoApplication::CompileShaders() {
 	m_panel_shader.Compile();
 	m_text_shader.Compile();
 	m_compute_shader.Compile();
@@ -79,6 +85,7 @@ void DemoApplication::Run() {
 		//Editor::ShowDemoWindow();
 		Editor::EndFrame();
 		Window::Update();
+		File::Manager::PollChanges();
 	}
 }
 
@@ -142,6 +149,16 @@ bool DemoApplication::OnWindowResize(const WindowResizedEvent& e) {
 	return false;
 }
 
+bool DemoApplication::OnFilesChanged(const FilesChangedEvent& e) {
+	for (const FileChange& change : e.changes) {
+		if (change.action != FileChange::Action::DELETED && change.path.ends_with(".glsl")) {
+			CompileShaders();
+			break;
+		}
+	}
+	return false;
+}
+
 Application* Application::Create() {
 	return new DemoApplication({
 		.enable_audio = false,
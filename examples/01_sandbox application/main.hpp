@@ -17,8 +17,10 @@ namespace zore {
 		void Run() override;
 		void CreateSimpleUI();
 		void ReloadShaders(ActionMap::Key);
+		void CompileShaders();
 
 		bool OnWindowResize(const WindowResizedEvent& e);
+		bool OnFilesChanged(const FilesChangedEvent& e);
 
 	private:
 		Camera2D m_camera;
@@ -0,0 +1,82 @@
+#include "benchmarks.hpp"
+#include <zore/io/archive.hpp>
+#include <zore/math/vector.hpp>
+#include <zore/math/matrix/mat4.hpp>
+#include <filesystem>
+#include <fstream>
+
+namespace zore {
+
+	enum class ArchiveKind : uint8_t { STATIC, DYNAMIC, KINEMATIC };
+
+	struct ArchiveItem {
+		std::string name;
+		uint32_t count;
+
+		template<typename A>
+		void serialize(A& archive) { archive(name, count); }
+	};
+
+	// Mixes raw fields, nested types, strings and vectors, the way save data would
+	struct ArchiveEntity {
+		static constexpr uint32_t SERIALIZE_VERSION = 2;
+
+		zm::vec3 position;
+		zm::mat4 transform;
+		ArchiveKind kind;
+		std::vector<float> weights;
+		std::vector<ArchiveItem> items;
+		std::vector<bool> flags;
+		int32_t grid[4];
+		float health;
+
+		template<typename A>
+		void serialize(A& archive) {
+			archive(position, transform, kind, weights, items, flags, grid);
+			if (archive.Version() >= 2)
+				archive(health);
+		}
+	};
+
+	static void PrintThroughput(const char* name, size_t bytes, float write, float read) {
+		std::printf("%-18s %7.1f MB  write %6.0f MB/s  read %6.0f MB/s\n", name, bytes / 1e6, bytes / 1e6 / write, bytes / 1e6 / read);
+	}
+
+	// Writes and reads back 100k mixed structs and a 64 MB float vector, which takes the bulk copy path, then reads the
+	// structs again from a mapped file
+	int BenchmarkArchive(int, char**) {
+		ArchiveEntity entity = { zm::vec3(1.f, 2.f, 3.f), zm::mat4(2.f), ArchiveKind::DYNAMIC, std::vector<float>(16, 1.f),
+			{ { "sword", 1 }, { "arrow", 20 } }, { true, false, true }, { 1, 2, 3, 4 }, 100.f };
+		const std::vector<ArchiveEntity> entities(100000, entity);
+		const std::vector<float> floats(size_t(1) << 24, 1.f);
+
+		for (int pass = 0; pass < 2; pass++) {
+			Timer timer;
+			ArchiveWriter writer;
+			writer(entities);
+			float write = timer.Time();
+			timer.Reset();
+			std::vector<ArchiveEntity> entities_read;
+			ArchiveReader(writer.Span())(entities_read);
+			PrintThroughput("mixed structs", writer.Size(), write, timer.Time());
+
+			timer.Reset();
+			ArchiveWriter bulk_writer;
+			bulk_writer(floats);
+			write = timer.Time();
+			timer.Reset();
+			std::vector<float> floats_read;
+			ArchiveReader(bulk_writer.Span())(floats_read);
+			PrintThroughput("bulk floats", bulk_writer.Size(), write, timer.Time());
+
+			std::string filename = (std::filesystem::temp_directory_path() / "zore_benchmark_archive.bin").string();
+			std::ofstream(filename, std::ios::binary).write(writer.Span().data(), writer.Size());
+			timer.Reset();
+			entities_read.clear();
+			ArchiveReader::Open(filename)(entities_read);
+			std::printf("%-18s %7.1f MB  read %6.0f MB/s\n", "mapped structs", writer.Size() / 1e6, writer.Size() / 1e6 / timer.Time());
+			std::filesystem::remove(filename);
+		}
+		return 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "benchmarks.hpp"
+#include <zore/io/asset_pack.hpp>
+#include <zore/structures/thread_pool.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace zore {
+
+	static constexpr size_t PACK_FILES = 200;
+	static constexpr size_t PACK_MAX_FILE_SIZE = 1024 * 1024;
+
+	// Writes {PACK_FILES} assets of up to 1 MiB, three quarters of them text built from a small vocabulary and the rest random
+	// bytes, standing in for already compressed textures and audio. Returns the total size of the assets
+	static size_t WritePackAssets(const std::filesystem::path& directory, std::vector<std::string>& keys) {
+		static const char* const WORDS[] = { "vertex", "normal", "texture", "shader", "uniform", "position", "color", "0.5", "1.0", "{", "}", "\n" };
+		std::mt19937 random(1);
+		std::uniform_int_distribution<size_t> size(4 * 1024, PACK_MAX_FILE_SIZE);
+		std::filesystem::create_directories(directory);
+		size_t total = 0;
+		for (size_t i = 0; i < PACK_FILES; i++) {
+			std::string data;
+			const size_t target = size(random);
+			bool text = i % 4 != 0;
+			while (data.size() < target) {
+				if (text)
+					data.append(WORDS[random() % std::size(WORDS)]).push_back(' ');
+				else
+					data.push_back(static_cast<char>(random()));
+			}
+			std::string name = "asset_" + std::to_string(i) + (text ? ".txt" : ".bin");
+			std::ofstream(directory / name, std::ios::binary).write(data.data(), data.size());
+			keys.push_back(directory.filename().string() + "/" + name);
+			total += data.size();
+		}
+		return total;
+	}
+
+	static void BenchmarkPack(const std::filesystem::path& directory, const std::vector<std::string>& keys, size_t total, bool compress, thread_pool& pool) {
+		std::filesystem::path file = directory / (compress ? "compressed.pak" : "raw.pak");
+		AssetPack pack = AssetPack::Create({ (directory / "assets").string() });
+		pack.SetThreadPool(&pool);
+		Timer timer;
+		AssetPack::SaveStats stats = pack.Save(file.string(), compress);
+		float build = timer.Time();
+
+		// Loading only maps the pack, so every asset is requested and read through to count decompression and page faults
+		timer.Reset();
+		AssetPack loaded = AssetPack::Load(file.string());
+		loaded.SetThreadPool(&pool);
+		size_t checksum = 0;
+		for (const std::string& key : keys) {
+			for (char c : loaded.Get(key))
+				checksum += static_cast<unsigned char>(c);
+		}
+		float load = timer.Time();
+
+		const double megabytes = total / (1024.0 * 1024.0);
+		std::printf("%-10s %.1f MB -> %.1f MB (ratio %.3f): build %.1f MB/s, load %.1f MB/s (checksum %zu)\n", compress ? "compressed" : "raw",
+			megabytes, stats.stored_size / (1024.0 * 1024.0), static_cast<double>(stats.stored_size) / total, megabytes / build, megabytes / load, checksum);
+	}
+
+	// Builds a pack of 200 generated assets with and without compression, then loads it and reads every asset back. The
+	// assets are written to a new directory under the given one, or under the temporary directory, and removed afterwards
+	int BenchmarkAssetPack(int argc, char** argv) {
+		std::filesystem::path directory = argc > 0 ? std::filesystem::path(argv[0]) : std::filesystem::temp_directory_path();
+		directory /= "zore_benchmark_asset_pack";
+		std::vector<std::string> keys;
+		size_t total = WritePackAssets(directory / "assets", keys);
+		thread_pool pool(std::max(std::thread::hardware_concurrency(), 1u));
+		for (int pass = 0; pass < 2; pass++) {
+			BenchmarkPack(directory, keys, total, false, pool);
+			BenchmarkPack(directory, keys, total, true, pool);
+		}
+		std::filesystem::remove_all(directory);
+		return 0;
+	}
+}
\ No newline at end of file
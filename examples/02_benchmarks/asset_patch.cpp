@@ -0,0 +1,102 @@
+#include "benchmarks.hpp"
+#include <zore/io/asset_patch.hpp>
+#include <zore/structures/thread_pool.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace zore {
+
+	static constexpr size_t PATCH_FILES = 100;
+
+	static std::string MakePatchAsset(std::mt19937& random, size_t size, bool text) {
+		std::string data;
+		while (data.size() < size) {
+			if (text)
+				data.append("token_" + std::to_string(random() % 5000)).push_back(' ');
+			else
+				data.push_back(static_cast<char>(random()));
+		}
+		return data;
+	}
+
+	static void WritePatchAsset(const std::filesystem::path& file, const std::string& data) {
+		std::ofstream(file, std::ios::binary).write(data.data(), data.size());
+	}
+
+	static bool SameFile(const std::filesystem::path& first, const std::filesystem::path& second) {
+		std::ifstream a(first, std::ios::binary), b(second, std::ios::binary);
+		return std::equal(std::istreambuf_iterator<char>(a), std::istreambuf_iterator<char>(), std::istreambuf_iterator<char>(b), std::istreambuf_iterator<char>());
+	}
+
+	// Saves the base pack, then edits the assets the way a content update would and saves the target pack: a few text assets
+	// get bytes inserted or erased, a few binary assets get a run of bytes changed, one asset is removed and one is added
+	static void BenchmarkPatch(const std::filesystem::path& directory, bool compress, thread_pool& pool) {
+		const std::filesystem::path assets = directory / "assets";
+		const std::filesystem::path base_file = directory / "base.pak";
+		const std::filesystem::path target_file = directory / "target.pak";
+		const std::filesystem::path patch_file = directory / "update.patch";
+		const std::filesystem::path output_file = directory / "patched.pak";
+		std::filesystem::remove_all(assets);
+		std::filesystem::create_directories(assets);
+
+		std::mt19937 random(1);
+		std::uniform_int_distribution<size_t> size(16 * 1024, 2 * 1024 * 1024);
+		std::vector<std::string> contents;
+		for (size_t i = 0; i < PATCH_FILES; i++) {
+			contents.push_back(MakePatchAsset(random, size(random), i % 4 != 0));
+			WritePatchAsset(assets / ("asset_" + std::to_string(i)), contents.back());
+		}
+		AssetPack::Create({ assets.string() }).SetThreadPool(&pool).Save(base_file.string(), compress);
+
+		for (size_t i = 1; i < 12; i += 2) {
+			std::string& data = contents[i];
+			size_t offset = random() % data.size();
+			if (i % 4 == 1)
+				data.insert(offset, "edited " + std::to_string(i));
+			else
+				data.erase(offset, std::min<size_t>(100, data.size() - offset));
+			WritePatchAsset(assets / ("asset_" + std::to_string(i)), data);
+		}
+		for (size_t i = 0; i < 12; i += 4) {
+			std::string& data = contents[i];
+			size_t offset = random() % data.size();
+			for (size_t j = offset; j < std::min(offset + 256, data.size()); j++)
+				data[j] = static_cast<char>(random());
+			WritePatchAsset(assets / ("asset_" + std::to_string(i)), data);
+		}
+		std::filesystem::remove(assets / ("asset_" + std::to_string(PATCH_FILES - 1)));
+		WritePatchAsset(assets / "asset_added", MakePatchAsset(random, 256 * 1024, true));
+		AssetPack::Create({ assets.string() }).SetThreadPool(&pool).Save(target_file.string(), compress);
+
+		AssetPack base = AssetPack::Load(base_file.string());
+		AssetPack target = AssetPack::Load(target_file.string());
+		Timer timer;
+		AssetPatch::Stats stats = AssetPatch::Create(base, target, patch_file.string());
+		float create = timer.Time();
+		timer.Reset();
+		AssetPatch::Apply(base, patch_file.string(), output_file.string(), &pool);
+		float apply = timer.Time();
+
+		std::printf("%-10s %zu unchanged, %zu changed, %zu added, %zu removed: patch %.1f KiB of a %.1f MiB pack, create %.1f ms, apply %.1f ms, %s\n",
+			compress ? "compressed" : "raw", stats.unchanged_count, stats.changed_count, stats.added_count, stats.removed_count, stats.patch_size / 1024.0,
+			std::filesystem::file_size(target_file) / (1024.0 * 1024.0), create * 1e3f, apply * 1e3f, SameFile(output_file, target_file) ? "matches" : "MISMATCH");
+	}
+
+	// Creates and applies a patch between two versions of a pack of 100 generated assets, raw and compressed. The packs are
+	// written to a new directory under the given one, or under the temporary directory, and removed afterwards
+	int BenchmarkAssetPatch(int argc, char** argv) {
+		std::filesystem::path directory = argc > 0 ? std::filesystem::path(argv[0]) : std::filesystem::temp_directory_path();
+		directory /= "zore_benchmark_asset_patch";
+		thread_pool pool(std::max(std::thread::hardware_concurrency(), 1u));
+		BenchmarkPatch(directory, false, pool);
+		BenchmarkPatch(directory, true, pool);
+		std::filesystem::remove_all(directory);
+		return 0;
+	}
+}
\ No newline at end of file
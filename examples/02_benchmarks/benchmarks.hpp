@@ -0,0 +1,24 @@
+#pragma once
+
+#include <zore/utils/time.hpp>
+#include <cstdio>
+
+namespace zore {
+
+	//========================================================================
+	//	Benchmarks
+	//========================================================================
+
+	// Each benchmark takes the arguments following its name, and returns the process exit code
+	int BenchmarkLines(int argc, char** argv);
+	int BenchmarkArchive(int argc, char** argv);
+	int BenchmarkBits(int argc, char** argv);
+	int BenchmarkReactor(int argc, char** argv);
+	int BenchmarkWriter(int argc, char** argv);
+	int BenchmarkBezier(int argc, char** argv);
+	int BenchmarkBroadphase(int argc, char** argv);
+	int BenchmarkSpatialHash(int argc, char** argv);
+	int BenchmarkPhysicsWorld(int argc, char** argv);
+	int BenchmarkAssetPack(int argc, char** argv);
+	int BenchmarkAssetPatch(int argc, char** argv);
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "benchmarks.hpp"
+#include <zore/math/bezier.hpp>
+#include <random>
+
+namespace zore {
+
+	static constexpr size_t BEZIER_CURVES = 10000;
+	static constexpr int BEZIER_FIXED_POINTS = 32;
+	static constexpr float BEZIER_TOLERANCE = 0.1f;
+	static constexpr int BEZIER_REPEATS = 20;
+
+	static void PrintFlatten(const char* name, size_t points, float seconds) {
+		std::printf("%-22s %8zu points, %6.2f ms, %6.1fM points/s\n", name, points, seconds * 1e3f / BEZIER_REPEATS, points * BEZIER_REPEATS / seconds / 1e6f);
+	}
+
+	// Flattens 10k random cubic curves spanning 200 units with a fixed 32 points each, then adaptively and in one batch to
+	// within 0.1 units
+	int BenchmarkBezier(int, char**) {
+		std::mt19937 random(3);
+		std::uniform_real_distribution<float> coordinate(-100.f, 100.f);
+		std::vector<zm::Bezier::CubicCurve> curves(BEZIER_CURVES);
+		for (zm::Bezier::CubicCurve& curve : curves) {
+			curve = { zm::vec2(coordinate(random), coordinate(random)), zm::vec2(coordinate(random), coordinate(random)),
+				zm::vec2(coordinate(random), coordinate(random)), zm::vec2(coordinate(random), coordinate(random)) };
+		}
+		std::vector<zm::vec2> out;
+		std::vector<uint32_t> offsets;
+
+		for (int pass = 0; pass < 2; pass++) {
+			Timer timer;
+			for (int i = 0; i < BEZIER_REPEATS; i++) {
+				out.resize(curves.size() * BEZIER_FIXED_POINTS);
+				for (size_t j = 0; j < curves.size(); j++) {
+					const zm::Bezier::CubicCurve& curve = curves[j];
+					zm::Bezier::Cubic(curve.a, curve.b, curve.c, curve.d, BEZIER_FIXED_POINTS, out.data() + j * BEZIER_FIXED_POINTS);
+				}
+			}
+			PrintFlatten("fixed count", out.size(), timer.Time());
+
+			timer.Reset();
+			for (int i = 0; i < BEZIER_REPEATS; i++) {
+				out.clear();
+				for (const zm::Bezier::CubicCurve& curve : curves)
+					zm::Bezier::Flatten(curve, BEZIER_TOLERANCE, out);
+			}
+			PrintFlatten("adaptive subdivision", out.size(), timer.Time());
+
+			timer.Reset();
+			for (int i = 0; i < BEZIER_REPEATS; i++) {
+				out.clear();
+				zm::Bezier::FlattenBatch(curves.data(), curves.size(), BEZIER_TOLERANCE, out, offsets);
+			}
+			PrintFlatten("batch", out.size(), timer.Time());
+		}
+		return 0;
+	}
+}
\ No newline at end of file
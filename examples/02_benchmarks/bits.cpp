@@ -0,0 +1,81 @@
+#include "benchmarks.hpp"
+#include <zore/networking/bit_stream.hpp>
+#include <zore/networking/packet.hpp>
+#include <random>
+
+namespace zore {
+
+	struct SnapshotEntity {
+		uint32_t id;
+		zm::vec3 position;
+		float yaw;
+		int32_t health;
+		bool alive;
+		bool crouching;
+	};
+
+	static constexpr size_t SNAPSHOT_ENTITIES = 100;
+	static constexpr int SNAPSHOT_REPEATS = 20000;
+
+	static void WriteSnapshot(net::BitWriter& writer, const std::vector<SnapshotEntity>& entities) {
+		writer.WriteVarint(entities.size());
+		for (const SnapshotEntity& entity : entities) {
+			writer.WriteVarint(entity.id);
+			writer.WriteVector(entity.position, -1024.f, 1024.f, 0.01f);
+			writer.WriteFloat(entity.yaw, -3.1416f, 3.1416f, 0.001f);
+			writer.WriteRanged(entity.health, 0, 100);
+			writer.WriteBool(entity.alive);
+			writer.WriteBool(entity.crouching);
+		}
+		writer.Flush();
+	}
+
+	// Compares the size of a 100 entity snapshot packed into bits against Packet's full width stream operators, then times
+	// writing and reading the packed snapshot
+	int BenchmarkBits(int, char**) {
+		std::mt19937 random(3);
+		std::uniform_real_distribution<float> coordinate(-1000.f, 1000.f);
+		std::uniform_real_distribution<float> angle(-3.1416f, 3.1416f);
+		std::vector<SnapshotEntity> entities(SNAPSHOT_ENTITIES);
+		for (SnapshotEntity& entity : entities)
+			entity = { static_cast<uint32_t>(random() % 5000), zm::vec3(coordinate(random), coordinate(random) * 0.1f, coordinate(random)), angle(random),
+				static_cast<int32_t>(random() % 101), (random() & 1) != 0, (random() & 1) != 0 };
+
+		net::BitWriter writer;
+		WriteSnapshot(writer, entities);
+		net::Packet packed;
+		packed << writer;
+		net::Packet full;
+		for (const SnapshotEntity& entity : entities)
+			full << entity.id << entity.position.x << entity.position.y << entity.position.z << entity.yaw << entity.health << entity.alive << entity.crouching;
+		std::printf("%zu entities: %u bytes bit packed, %u bytes full width\n", entities.size(), packed.PayloadSize(), full.PayloadSize());
+
+		for (int pass = 0; pass < 2; pass++) {
+			Timer timer;
+			for (int i = 0; i < SNAPSHOT_REPEATS; i++) {
+				writer.Clear();
+				WriteSnapshot(writer, entities);
+			}
+			float write = timer.Time();
+
+			timer.Reset();
+			float checksum = 0.f;
+			for (int i = 0; i < SNAPSHOT_REPEATS; i++) {
+				net::BitReader reader(writer.Data());
+				uint64_t count = reader.ReadVarint();
+				for (uint64_t j = 0; j < count; j++) {
+					checksum += static_cast<float>(reader.ReadVarint());
+					checksum += reader.ReadVector(-1024.f, 1024.f, 0.01f).x;
+					checksum += reader.ReadFloat(-3.1416f, 3.1416f, 0.001f);
+					checksum += static_cast<float>(reader.ReadRanged(0, 100));
+					checksum += reader.ReadBool() ? 1.f : 0.f;
+					checksum += reader.ReadBool() ? 1.f : 0.f;
+				}
+			}
+			float read = timer.Time();
+			const double total = static_cast<double>(SNAPSHOT_ENTITIES) * SNAPSHOT_REPEATS;
+			std::printf("write %.1fM entities/s, read %.1fM entities/s (checksum %g)\n", total / write / 1e6, total / read / 1e6, checksum);
+		}
+		return 0;
+	}
+}
\ No newline at end of file
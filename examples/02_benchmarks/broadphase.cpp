@@ -0,0 +1,81 @@
+#include "benchmarks.hpp"
+#include <zore/physics/dynamic_tree.hpp>
+#include <zore/physics/sweep_and_prune.hpp>
+#include <random>
+
+namespace zore {
+
+	static constexpr size_t BROADPHASE_PROXIES = 50000;
+	static constexpr int BROADPHASE_FRAMES = 20;
+	static constexpr size_t BROADPHASE_QUERIES = 1000;
+
+	// The same scene for every broadphase: 50k unit boxes in a 200 unit cube, every one jittering by up to 0.1 units each frame
+	template <typename B>
+	static void BenchmarkBroadphase(const char* name) {
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> coordinate(-100.f, 100.f);
+		std::uniform_real_distribution<float> jitter(-0.1f, 0.1f);
+		B broadphase;
+		std::vector<AABB3D> boxes(BROADPHASE_PROXIES);
+		std::vector<int32_t> proxies(BROADPHASE_PROXIES);
+		for (size_t i = 0; i < BROADPHASE_PROXIES; i++) {
+			boxes[i] = AABB3D::FromCenter(zm::vec3(coordinate(random), coordinate(random), coordinate(random)), zm::vec3(1.f));
+			proxies[i] = broadphase.CreateProxy(boxes[i], i);
+		}
+		std::vector<typename B::Pair> pairs;
+		broadphase.FindPairs(pairs);
+
+		float move = 0.f, find = 0.f, query = 0.f, raycast = 0.f;
+		size_t pair_count = 0, query_hits = 0, ray_hits = 0;
+		for (int frame = 0; frame < BROADPHASE_FRAMES; frame++) {
+			Timer timer;
+			for (size_t i = 0; i < BROADPHASE_PROXIES; i++) {
+				zm::vec3 displacement(jitter(random), jitter(random), jitter(random));
+				boxes[i] = AABB3D(boxes[i].GetMin() + displacement, boxes[i].GetMax() + displacement);
+				broadphase.MoveProxy(proxies[i], boxes[i], displacement);
+			}
+			move += timer.Time();
+
+			timer.Reset();
+			pairs.clear();
+			broadphase.FindPairs(pairs);
+			find += timer.Time();
+			pair_count += pairs.size();
+
+			timer.Reset();
+			for (size_t i = 0; i < BROADPHASE_QUERIES; i++) {
+				AABB3D box = AABB3D::FromCenter(zm::vec3(coordinate(random), coordinate(random), coordinate(random)), zm::vec3(5.f));
+				broadphase.Query(box, [&](int32_t) {
+					query_hits++;
+					return true;
+				});
+			}
+			query += timer.Time();
+
+			if constexpr (requires { broadphase.Raycast(zm::vec3(), zm::vec3(), 0.f, [](int32_t, float distance) { return distance; }); }) {
+				timer.Reset();
+				for (size_t i = 0; i < BROADPHASE_QUERIES; i++) {
+					zm::vec3 origin(coordinate(random), coordinate(random), coordinate(random));
+					zm::vec3 direction = zm::Normalize(zm::vec3(coordinate(random), coordinate(random), coordinate(random)));
+					broadphase.Raycast(origin, direction, 100.f, [&](int32_t, float distance) {
+						ray_hits++;
+						return distance;
+					});
+				}
+				raycast += timer.Time();
+			}
+		}
+
+		std::printf("%-16s move %6.2f ms, pairs %6.2f ms (%zu), %zu box queries %5.2f ms (%zu hits)", name, move * 1e3f / BROADPHASE_FRAMES,
+			find * 1e3f / BROADPHASE_FRAMES, pair_count / BROADPHASE_FRAMES, BROADPHASE_QUERIES, query * 1e3f / BROADPHASE_FRAMES, query_hits / BROADPHASE_FRAMES);
+		if (raycast > 0.f)
+			std::printf(", %zu rays %5.2f ms (%zu hits)", BROADPHASE_QUERIES, raycast * 1e3f / BROADPHASE_FRAMES, ray_hits / BROADPHASE_FRAMES);
+		std::printf(" per frame\n");
+	}
+
+	int BenchmarkBroadphase(int, char**) {
+		BenchmarkBroadphase<DynamicTree>("dynamic tree");
+		BenchmarkBroadphase<SweepAndPrune>("sweep and prune");
+		return 0;
+	}
+}
\ No newline at end of file
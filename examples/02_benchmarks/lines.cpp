@@ -0,0 +1,62 @@
+#include "benchmarks.hpp"
+#include <zore/io/file_manager.hpp>
+#include <zore/io/mapped_file.hpp>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace zore {
+
+	static constexpr size_t LINES_FILE_SIZE = size_t(1) << 30;
+
+	// Lines of up to 80 characters, with every seventh ending in \r\n
+	static void WriteLinesFile(const std::string& filename) {
+		std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+		std::mt19937 random(1);
+		std::string line;
+		for (size_t written = 0; written < LINES_FILE_SIZE; written += line.size()) {
+			line.assign(random() % 80, 'x');
+			if (random() % 7 == 0)
+				line += '\r';
+			line += '\n';
+			file.write(line.data(), line.size());
+		}
+	}
+
+	// Iterates every line of a 1 GB file with File::Iterator and with MappedFile. Both passes include opening the file, so
+	// the mapped pass pays for its page faults. File::Iterator keeps the \r of \r\n breaks, so it counts a few more bytes
+	int BenchmarkLines(int argc, char** argv) {
+		std::string filename = argc > 0 ? argv[0] : (std::filesystem::temp_directory_path() / "zore_benchmark_lines.txt").string();
+		if (!std::filesystem::exists(filename)) {
+			std::printf("writing %s\n", filename.c_str());
+			WriteLinesFile(filename);
+		}
+
+		for (int pass = 0; pass < 2; pass++) {
+			size_t lines = 0;
+			size_t bytes = 0;
+			Timer timer;
+			{
+				File file(filename);
+				for (const std::string& line : file) {
+					lines++;
+					bytes += line.size();
+				}
+			}
+			std::printf("File::Iterator  %zu lines, %zu bytes, %.3f s\n", lines, bytes, timer.Time());
+
+			lines = 0;
+			bytes = 0;
+			timer.Reset();
+			{
+				MappedFile file = MappedFile::Open(filename);
+				for (std::string_view line : file) {
+					lines++;
+					bytes += line.size();
+				}
+			}
+			std::printf("MappedFile      %zu lines, %zu bytes, %.3f s\n", lines, bytes, timer.Time());
+		}
+		return 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "benchmarks.hpp"
+#include <string_view>
+
+using namespace zore;
+
+struct Benchmark {
+	const char* name;
+	const char* arguments;
+	int (*run)(int argc, char** argv);
+};
+
+static const Benchmark s_benchmarks[] = {
+	{ "lines", "[file]", &BenchmarkLines },
+	{ "archive", "", &BenchmarkArchive },
+	{ "bits", "", &BenchmarkBits },
+	{ "reactor", "[epoll | io_uring | blocking] [port]", &BenchmarkReactor },
+	{ "writer", "[directory]", &BenchmarkWriter },
+	{ "bezier", "", &BenchmarkBezier },
+	{ "broadphase", "", &BenchmarkBroadphase },
+	{ "spatial_hash", "", &BenchmarkSpatialHash },
+	{ "physics_world", "[bodies]", &BenchmarkPhysicsWorld },
+	{ "asset_pack", "[directory]", &BenchmarkAssetPack },
+	{ "asset_patch", "[directory]", &BenchmarkAssetPatch },
+};
+
+int main(int argc, char** argv) {
+	if (argc >= 2) {
+		for (const Benchmark& benchmark : s_benchmarks) {
+			if (std::string_view(argv[1]) == benchmark.name)
+				return benchmark.run(argc - 2, argv + 2);
+		}
+	}
+	std::printf("usage: %s <benchmark> [arguments]\n", argc > 0 ? argv[0] : "ZoreEngineBenchmarks");
+	for (const Benchmark& benchmark : s_benchmarks)
+		std::printf("  %s%s%s\n", benchmark.name, *benchmark.arguments ? " " : "", benchmark.arguments);
+	return 1;
+}
\ No newline at end of file
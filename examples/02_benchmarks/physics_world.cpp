@@ -0,0 +1,65 @@
+#include "benchmarks.hpp"
+#include <zore/physics/physics_world.hpp>
+#include <zore/voxel/chunk.hpp>
+#include <zore/structures/thread_pool.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <random>
+#include <thread>
+
+namespace zore {
+
+	static constexpr int WORLD_STEPS = 300;
+	static constexpr int WORLD_LAYERS = 10;
+	static constexpr int WORLD_FLOOR_CHUNKS = 4;
+
+	static void BenchmarkWorld(size_t bodies, thread_pool* pool) {
+		// One chunk with a single layer of blocks at y = 0, repeated across an 8 x 8 chunk floor around the origin
+		voxel::Chunk floor;
+		for (int32_t x = 0; x < voxel::Chunk::SIZE; x++)
+			for (int32_t z = 0; z < voxel::Chunk::SIZE; z++)
+				floor.Set(x, 0, z, 1);
+		PhysicsWorld world(1.f / 60.f, pool);
+		world.SetVoxels([&](const zm::ivec3& chunk) -> const voxel::Chunk* {
+			bool inside = chunk.y == 0 && zm::Abs(chunk.x + 0.5f) < WORLD_FLOOR_CHUNKS && zm::Abs(chunk.z + 0.5f) < WORLD_FLOOR_CHUNKS;
+			return inside ? &floor : nullptr;
+		});
+
+		// Unit boxes in 10 loose layers, dropping onto the floor and each other
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> offset(0.f, 0.2f);
+		const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(bodies) / WORLD_LAYERS)));
+		for (size_t i = 0; i < bodies; i++) {
+			int layer = static_cast<int>(i) / (side * side);
+			int cell = static_cast<int>(i) % (side * side);
+			PhysicsWorld::BodyDesc desc;
+			desc.position = zm::vec3((cell % side - side * 0.5f) * 1.5f + offset(random), 2.f + layer * 1.2f, (cell / side - side * 0.5f) * 1.5f + offset(random));
+			desc.restitution = 0.1f;
+			world.CreateBody(desc);
+		}
+
+		Timer timer;
+		float settled = 0.f;
+		for (int step = 0; step < WORLD_STEPS; step++) {
+			if (step == WORLD_STEPS - 60)
+				settled = timer.Time();
+			world.Step();
+		}
+		float total = timer.Time();
+		std::printf("%zu bodies, %s: %.2f ms per step, %.2f ms over the last second, %zu contacts, %zu islands\n", bodies,
+			pool ? "pool" : "serial", total * 1e3f / WORLD_STEPS, (total - settled) * 1e3f / 60.f, world.GetContactCount(), world.GetIslandCount());
+	}
+
+	// Steps a headless scene of boxes settling onto a voxel floor for 5 seconds at 60 Hz, serially and on a pool with every
+	// hardware thread
+	int BenchmarkPhysicsWorld(int argc, char** argv) {
+		size_t bodies = 10000;
+		if (argc > 0)
+			std::from_chars(argv[0], argv[0] + std::strlen(argv[0]), bodies);
+		thread_pool pool(std::max(std::thread::hardware_concurrency(), 1u));
+		BenchmarkWorld(bodies, nullptr);
+		BenchmarkWorld(bodies, &pool);
+		return 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "benchmarks.hpp"
+#include <zore/networking/reactor.hpp>
+#include <zore/networking/address.hpp>
+#include <charconv>
+#include <cstring>
+#include <thread>
+
+#if defined(PLATFORM_LINUX)
+#include <sys/resource.h>
+#endif
+
+namespace zore {
+
+	static constexpr size_t MESSAGE_SIZE = 64;
+	static constexpr size_t ROUND_TRIPS = 200000;
+	static constexpr size_t CHURN_CONNECTIONS = 10000;
+	static constexpr size_t CHURN_BATCH = 100;
+
+	// Seconds of CPU time used by the whole process so far, or zero where it is not measured
+	static float CpuTime() {
+#if defined(PLATFORM_LINUX)
+		rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		return static_cast<float>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + static_cast<float>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6f;
+#else
+		return 0.f;
+#endif
+	}
+
+	static void PrintRoundTrips(const char* backend, size_t clients, size_t round_trips, float seconds, float cpu) {
+		std::printf("%-8s %zu byte ping-pong, %4zu clients: %.0f round trips/s, %.2f us CPU per round trip\n", backend, MESSAGE_SIZE,
+			clients, round_trips / seconds, cpu / round_trips * 1e6f);
+	}
+
+	// Connects batches of clients and closes them straight away, until the server has accepted and seen every one close
+	static bool BenchmarkChurn(uint16_t port, net::Reactor::Backend backend, const char* name) {
+		net::Reactor reactor(backend);
+		net::Listener listener;
+		listener.Listen(port);
+		size_t closed = 0;
+		net::Connection::Callbacks server;
+		server.on_close = [&](net::Connection&) { closed++; };
+		reactor.Add(listener, [&](net::Socket&& socket) { reactor.Add(std::move(socket), server); });
+
+		Timer timer;
+		for (size_t opened = 0; opened < CHURN_CONNECTIONS; opened += CHURN_BATCH) {
+			for (size_t i = 0; i < CHURN_BATCH; i++) {
+				net::Connection* client = reactor.Add(net::Socket(net::Address::Localhost(port), net::Protocol::TCP, true), {});
+				if (!client)
+					return false;
+				client->Close();
+			}
+			while (closed < opened + CHURN_BATCH)
+				reactor.Poll(1.f);
+		}
+		std::printf("%-8s connect and close churn: %.0f connections/s\n", name, CHURN_CONNECTIONS / timer.Time());
+		return true;
+	}
+
+	// Each client sends a message, and sends the next once the server has echoed it back, until ROUND_TRIPS are done
+	static bool BenchmarkPingPong(uint16_t port, size_t clients, net::Reactor::Backend backend, const char* name) {
+		net::Reactor reactor(backend);
+		net::Listener listener;
+		listener.Listen(port);
+		net::Connection::Callbacks echo;
+		echo.on_read = [](net::Connection& connection) {
+			std::span<const uint8_t> received = connection.Received();
+			connection.Send(received.data(), received.size());
+			connection.Consume(received.size());
+		};
+		reactor.Add(listener, [&](net::Socket&& socket) { reactor.Add(std::move(socket), echo); });
+
+		const std::vector<uint8_t> message(MESSAGE_SIZE, 7);
+		size_t round_trips = 0;
+		net::Connection::Callbacks client;
+		client.on_read = [&](net::Connection& connection) {
+			while (connection.Received().size() >= MESSAGE_SIZE) {
+				connection.Consume(MESSAGE_SIZE);
+				// Stops resending once the messages still in flight finish the count
+				if (++round_trips + clients <= ROUND_TRIPS)
+					connection.Send(message.data(), MESSAGE_SIZE);
+			}
+		};
+		std::vector<net::Connection*> connections;
+		for (size_t i = 0; i < clients; i++) {
+			net::Connection* connection = reactor.Add(net::Socket(net::Address::Localhost(port), net::Protocol::TCP, true), client);
+			if (!connection)
+				return false;
+			connections.push_back(connection);
+		}
+		while (reactor.GetConnectionCount() < clients * 2)
+			reactor.Poll(0.01f);
+
+		Timer timer;
+		float cpu = CpuTime();
+		for (net::Connection* connection : connections)
+			connection->Send(message.data(), MESSAGE_SIZE);
+		while (round_trips < ROUND_TRIPS)
+			reactor.Poll(1.f);
+		PrintRoundTrips(name, clients, round_trips, timer.Time(), CpuTime() - cpu);
+
+		// Clients hang up first, so that the server's ends do not linger in TIME_WAIT holding the port for the next run
+		for (net::Connection* connection : connections)
+			connection->Close();
+		while (reactor.GetConnectionCount() > 0)
+			reactor.Poll(0.1f);
+		return true;
+	}
+
+	static bool ReceiveMessage(net::Socket& socket, uint8_t* message) {
+		for (uint32_t received = 0; received < MESSAGE_SIZE;) {
+			uint32_t size = 0;
+			if (socket.Receive(message + received, static_cast<uint32_t>(MESSAGE_SIZE) - received, size) != net::Socket::Status::DONE)
+				return false;
+			received += size;
+		}
+		return true;
+	}
+
+	// The same ping-pong on blocking sockets, with a thread for each end of every connection
+	static bool BenchmarkBlockingPingPong(uint16_t port, size_t clients) {
+		net::Listener listener(true);
+		listener.Listen(port);
+		std::vector<net::Socket> client_sockets;
+		for (size_t i = 0; i < clients; i++) {
+			client_sockets.emplace_back(net::Address::Localhost(port), net::Protocol::TCP, true);
+			if (!client_sockets.back().IsOpen())
+				return false;
+		}
+		std::vector<net::Socket> server_sockets;
+		while (server_sockets.size() < clients)
+			listener.AcceptConnections(server_sockets);
+
+		const size_t round_trips = ROUND_TRIPS / clients * clients;
+		Timer timer;
+		float cpu = CpuTime();
+		std::vector<std::thread> server_threads;
+		for (net::Socket& socket : server_sockets) {
+			server_threads.emplace_back([&socket]() {
+				uint8_t message[MESSAGE_SIZE];
+				while (ReceiveMessage(socket, message))
+					socket.Send(message, MESSAGE_SIZE);
+			});
+		}
+		std::vector<std::thread> client_threads;
+		for (net::Socket& socket : client_sockets) {
+			client_threads.emplace_back([&socket, clients]() {
+				uint8_t message[MESSAGE_SIZE] = {};
+				for (size_t i = 0; i < ROUND_TRIPS / clients; i++) {
+					socket.Send(message, MESSAGE_SIZE);
+					ReceiveMessage(socket, message);
+				}
+			});
+		}
+		for (std::thread& thread : client_threads)
+			thread.join();
+		PrintRoundTrips("blocking", clients, round_trips, timer.Time(), CpuTime() - cpu);
+
+		// Clients hang up first, which ends the server threads
+		for (net::Socket& socket : client_sockets)
+			socket.Close();
+		for (std::thread& thread : server_threads)
+			thread.join();
+		return true;
+	}
+
+	// Runs both ends of every connection in one reactor on loopback, or on blocking sockets with a thread per end, so the
+	// numbers include the client side's work. Each test listens on the next port up from the first, which defaults to below
+	// the usual ephemeral port range
+	int BenchmarkReactor(int argc, char** argv) {
+		std::string_view backend = argc > 0 ? argv[0] : "epoll";
+		uint16_t port = 27015;
+		if (argc > 1)
+			std::from_chars(argv[1], argv[1] + std::strlen(argv[1]), port);
+
+		bool connected = true;
+		if (backend == "blocking") {
+			for (size_t clients : { 1, 100, 1000 })
+				connected = connected && BenchmarkBlockingPingPong(++port, clients);
+		}
+		else if (backend == "epoll" || backend == "io_uring") {
+			net::Reactor::Backend reactor_backend = backend == "io_uring" ? net::Reactor::Backend::IO_URING : net::Reactor::Backend::EPOLL;
+			if (net::Reactor(reactor_backend).GetBackend() != reactor_backend) {
+				std::printf("io_uring is not supported, running on epoll\n");
+				reactor_backend = net::Reactor::Backend::EPOLL;
+				backend = "epoll";
+			}
+			connected = BenchmarkChurn(port, reactor_backend, backend.data());
+			for (size_t clients : { 1, 100, 1000 })
+				connected = connected && BenchmarkPingPong(++port, clients, reactor_backend, backend.data());
+		}
+		else {
+			std::printf("unknown backend %s, expected epoll, io_uring or blocking\n", argv[0]);
+			return 1;
+		}
+		if (!connected) {
+			std::printf("could not connect to port %u\n", port);
+			return 1;
+		}
+		return 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "benchmarks.hpp"
+#include <zore/physics/spatial_hash.hpp>
+#include <zore/structures/thread_pool.hpp>
+#include <algorithm>
+#include <random>
+#include <thread>
+
+namespace zore {
+
+	static constexpr size_t HASH_POINTS = 200000;
+	static constexpr int HASH_BUILDS = 10;
+	static constexpr size_t HASH_NEAREST = 10;
+
+	// Builds a grid of 200k points spread through a 200 x 200 x 50 box with 2 unit cells, serially and on a pool with every
+	// hardware thread, then runs a 2 unit radius query and a 10 nearest query around every other point
+	int BenchmarkSpatialHash(int, char**) {
+		std::mt19937 random(5);
+		std::uniform_real_distribution<float> horizontal(-100.f, 100.f);
+		std::uniform_real_distribution<float> vertical(-25.f, 25.f);
+		std::vector<zm::vec3> points(HASH_POINTS);
+		for (zm::vec3& point : points)
+			point = zm::vec3(horizontal(random), horizontal(random), vertical(random));
+		const uint32_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+		thread_pool pool(threads);
+		SpatialHash hash(2.f);
+
+		for (int pass = 0; pass < 2; pass++) {
+			Timer timer;
+			for (int i = 0; i < HASH_BUILDS; i++)
+				hash.Build(points);
+			float serial = timer.Time();
+			timer.Reset();
+			for (int i = 0; i < HASH_BUILDS; i++)
+				hash.Build(points, pool);
+			float parallel = timer.Time();
+			std::printf("%zu point build: %.2f ms serial, %.2f ms on a pool of %u\n", HASH_POINTS, serial * 1e3f / HASH_BUILDS,
+				parallel * 1e3f / HASH_BUILDS, threads);
+
+			size_t found = 0;
+			timer.Reset();
+			for (size_t i = 0; i < HASH_POINTS; i += 2) {
+				hash.QueryRadius(points[i], 2.f, [&](uint32_t, float) {
+					found++;
+				});
+			}
+			std::printf("%zu radius queries: %.2f ms (%zu found)\n", HASH_POINTS / 2, timer.Time() * 1e3f, found);
+
+			std::vector<uint32_t> nearest;
+			found = 0;
+			timer.Reset();
+			for (size_t i = 0; i < HASH_POINTS; i += 2) {
+				nearest.clear();
+				found += hash.QueryNearest(points[i], HASH_NEAREST, 10.f, nearest);
+			}
+			std::printf("%zu nearest queries: %.2f ms (%zu found)\n", HASH_POINTS / 2, timer.Time() * 1e3f, found);
+		}
+		return 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include "benchmarks.hpp"
+#include <zore/io/async_writer.hpp>
+#include <filesystem>
+
+namespace zore {
+
+	static constexpr size_t WRITER_FILES = 200;
+	static constexpr size_t WRITER_FILE_SIZE = 64 * 1024;
+
+	// Replaces 200 files of 64 KiB with every write synced, through the blocking and io_uring backends in turn. The files
+	// are written to a new directory under the given one, or under the temporary directory, and removed afterwards
+	int BenchmarkWriter(int argc, char** argv) {
+		std::filesystem::path directory = argc > 0 ? std::filesystem::path(argv[0]) : std::filesystem::temp_directory_path();
+		directory /= "zore_benchmark_writer";
+		std::filesystem::create_directories(directory);
+		const std::string data(WRITER_FILE_SIZE, 'x');
+
+		for (int pass = 0; pass < 3; pass++) {
+			for (AsyncWriter::Backend backend : { AsyncWriter::Backend::BLOCKING, AsyncWriter::Backend::IO_URING }) {
+				AsyncWriter writer(AsyncWriter::Sync::ALWAYS, backend);
+				Timer timer;
+				for (size_t i = 0; i < WRITER_FILES; i++)
+					writer.Write((directory / ("file_" + std::to_string(i))).string(), data);
+				writer.Flush();
+				const char* name = writer.GetBackend() == AsyncWriter::Backend::IO_URING ? "io_uring" : "blocking";
+				std::printf("%-8s %zu x %zu KiB synced: %.1f ms, %llu failed\n", name, WRITER_FILES, WRITER_FILE_SIZE / 1024, timer.Time() * 1e3f,
+					static_cast<unsigned long long>(writer.GetStats().failures));
+			}
+		}
+		std::filesystem::remove_all(directory);
+		return 0;
+	}
+}
\ No newline at end of file
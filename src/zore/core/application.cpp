@@ -1,6 +1,7 @@
 #include "zore/core/application.hpp"
 #include "zore/platform/processor.hpp"
 #include "zore/io/file_manager.hpp"
+#include "zore/io/async_writer.hpp"
 #include "zore/core/command.hpp"
 #include "zore/devices/window.hpp"
 #include "zore/networking/networking_manager.hpp"
@@ -46,6 +47,7 @@ namespace zore {
 		net::Manager::Free();
 		Window::Free();
 		Processor::Free();
+		File::Manager::Writer().Flush();
 		s_initialized = false;
 	}
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "zore/core/config_manager.hpp"
 #include "zore/io/file_manager.hpp"
+#include "zore/io/mapped_file.hpp"
+#include "zore/io/async_writer.hpp"
 #include "zore/utils/string.hpp"
 #include "zore/debug.hpp"
 
@@ -24,22 +26,27 @@ namespace zore::Config {
 		m_should_save = false;
 
 		File::Manager::EnsureDir("config");
-		File file("config/" + m_filename + ".cfg", File::Mode::READ_OR_CREATE);
-		for (const std::string& line : file) {
-			size_t index = line.find("=");
+		// A save may still be queued, and must land before the file is read back
+		File::Manager::Writer().Flush();
+		std::string filename = "config/" + m_filename + ".cfg";
+		if (!File::Exists(filename)) {
+			File(filename, File::Mode::READ_OR_CREATE);
+			return;
+		}
+		MappedFile file = MappedFile::Open(filename);
+		for (std::string_view line : file) {
+			size_t index = line.find('=');
 			std::string key = String::Trim(line.substr(0, index));
-			std::string value = String::Trim(line.substr(index + 1));
-			m_entries[key] = value;
+			m_entries[key] = String::Trim(line.substr(index + 1));
 		}
 	}
 
 	void Manager::Save() {
 		if (m_should_save) {
-			File file("config/" + m_filename + ".cfg", File::Mode::TRUNCATE);
 			std::string output;
 			for (auto& iter : m_entries)
 				output += iter.first + "=" + iter.second + "\n";
-			file.Write(output);
+			File::Manager::Writer().Write("config/" + m_filename + ".cfg", std::move(output));
 			m_should_save = false;
 		}
 	}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "zore/events/button_events.hpp"
+#include "zore/events/file_events.hpp"
 #include "zore/events/keyboard_events.hpp"
 #include "zore/events/mouse_events.hpp"
 #include "zore/events/window_events.hpp"
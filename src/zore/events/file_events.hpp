@@ -0,0 +1,29 @@
+#pragma once
+
+#include "zore/events/event.hpp"
+#include <vector>
+#include <string>
+
+namespace zore {
+
+	struct FileChange {
+		// A file renamed over an existing one, as atomic saves do, modifies it
+		enum class Action { CREATED, MODIFIED, DELETED };
+
+		std::string path;
+		Action action;
+	};
+
+	// Every change seen by a file watcher since its last batch. Each path appears at most once
+	struct FilesChangedEvent : public event::Base {
+		FilesChangedEvent(const std::vector<FileChange>& changes) : changes(changes) {}
+
+		bool Contains(std::string_view path) const {
+			for (const FileChange& change : changes)
+				if (change.path == path)
+					return true;
+			return false;
+		}
+		std::vector<FileChange> changes;
+	};
+}
\ No newline at end of file
@@ -47,6 +47,15 @@ namespace zore::Texture {
 		ENSURE(data, "Failed to load texture: " + path + ". " + stbi_failure_reason());
     }
 
+    void Data::LoadFromMemory(std::span<const char> memory, Format requested_format) {
+        if (data)
+            Free();
+        // The flip flag is per thread here, since this may run on several threads at once
+        stbi_set_flip_vertically_on_load_thread(true);
+        data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(memory.data()), static_cast<int>(memory.size()), &width, &height, &channels, GetChannelCount(requested_format));
+        ENSURE(data, std::string("Failed to load texture from memory. ") + stbi_failure_reason());
+    }
+
     void Data::Free() {
         stbi_image_free(data);
         data = nullptr;
@@ -2,6 +2,7 @@
 
 #include "zore/graphics/textures/texture_format.hpp"
 #include <string>
+#include <span>
 
 namespace zore::Texture {
 
@@ -21,6 +22,8 @@ namespace zore::Texture {
 
         void Move(Data& other);
         void Load(const std::string& path, Format requested_format = Format::RGBA);
+        // Decodes an image file that has already been read, such as one from an asset pack. Safe to call from worker threads
+        void LoadFromMemory(std::span<const char> memory, Format requested_format = Format::RGBA);
         void Free();
 
     private:
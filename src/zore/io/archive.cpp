@@ -0,0 +1,47 @@
+#include "zore/io/archive.hpp"
+#include "zore/debug.hpp"
+
+namespace zore {
+
+	//========================================================================
+	//	Archive Writer
+	//========================================================================
+
+	ArchiveWriter::ArchiveWriter(uint32_t version) : Archive(version) {
+		Clear();
+	}
+
+	void ArchiveWriter::Clear() {
+		m_data.clear();
+		uint32_t magic = MAGIC;
+		Process(magic);
+		Process(m_version);
+	}
+
+	//========================================================================
+	//	Archive Reader
+	//========================================================================
+
+	ArchiveReader::ArchiveReader(std::span<const char> data) : Archive(0), m_data(data), m_position(0) {
+		ReadHeader();
+	}
+
+	ArchiveReader ArchiveReader::Open(const std::string& filename) {
+		MappedFile file = MappedFile::Open(filename);
+		ArchiveReader reader(file.Span());
+		// Moving the mapping keeps its address, so the reader's view of it stays valid
+		reader.m_file = std::move(file);
+		return reader;
+	}
+
+	void ArchiveReader::ReadHeader() {
+		uint32_t magic = 0;
+		Process(magic);
+		ENSURE(magic == MAGIC, "Data is not a zore archive");
+		Process(m_version);
+	}
+
+	void ArchiveReader::Overflow(size_t size) const {
+		throw ZORE_EXCEPTION("Archive read of " + std::to_string(size) + " bytes past the end, with " + std::to_string(Remaining()) + " bytes remaining");
+	}
+}
\ No newline at end of file
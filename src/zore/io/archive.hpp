@@ -0,0 +1,147 @@
+#pragma once
+
+#include "zore/io/mapped_file.hpp"
+#include "zore/math/vector/vec_base.hpp"
+#include <type_traits>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <array>
+#include <span>
+
+namespace zm {
+	struct mat2;
+	struct mat3;
+	struct mat4;
+}
+
+namespace zore {
+
+	//========================================================================
+	//	Serialization Concepts
+	//========================================================================
+
+	template <typename T>
+	struct is_math_type : std::false_type {};
+	template <typename T, int N>
+	struct is_math_type<zm::vec_base<T, N>> : std::true_type {};
+	template <>
+	struct is_math_type<zm::mat2> : std::true_type {};
+	template <>
+	struct is_math_type<zm::mat3> : std::true_type {};
+	template <>
+	struct is_math_type<zm::mat4> : std::true_type {};
+
+	// Types stored as their raw bytes, in the host's byte order. Ranges of them are copied in a single block
+	template <typename T>
+	concept bitwise_serializable = std::is_arithmetic_v<T> || std::is_enum_v<T> || is_math_type<T>::value;
+
+	// Types listing their fields with a single member used for both reading and writing:
+	//     template <typename A> void serialize(A& archive) { archive(position, health, name); }
+	template <typename T, typename A>
+	concept serializable = requires(T& value, A& archive) { value.serialize(archive); };
+
+	// Types with a SERIALIZE_VERSION have it stored ahead of their fields, and read back through Archive::Version() while their
+	// fields are serialized. Fields added in later versions can then be skipped when reading older data
+	template <typename T>
+	concept versioned = requires { { T::SERIALIZE_VERSION } -> std::convertible_to<uint32_t>; };
+
+	//========================================================================
+	//	Archive Base
+	//========================================================================
+
+	// Shared by the reader and writer, so that one serialize function describes both directions. Strings and containers are
+	// stored as a 32 bit element count followed by their elements
+	template <typename Derived>
+	class Archive {
+	public:
+		static constexpr uint32_t MAGIC = 0x4352415A; // "ZARC"
+
+	public:
+		uint32_t Version() const { return m_version; }
+
+		template <typename... Args>
+		Derived& operator()(Args&&... args);
+
+	protected:
+		Archive(uint32_t version) : m_version(version) {}
+
+		template <typename T>
+		void Process(T& value);
+		template <typename T>
+		void ProcessRange(T* values, size_t count);
+		Derived& Self() { return static_cast<Derived&>(*this); }
+
+	protected:
+		uint32_t m_version;
+	};
+
+	//========================================================================
+	//	Archive Writer
+	//========================================================================
+
+	class ArchiveWriter : public Archive<ArchiveWriter> {
+	public:
+		friend class Archive<ArchiveWriter>;
+		static constexpr bool IS_READING = false;
+
+	public:
+		ArchiveWriter(uint32_t version = 0);
+
+		void Clear();
+		void Reserve(size_t size) { m_data.reserve(size); }
+		const std::vector<char>& Data() const { return m_data; }
+		std::span<const char> Span() const { return { m_data.data(), m_data.size() }; }
+		size_t Size() const { return m_data.size(); }
+
+	private:
+		void Bytes(const void* data, size_t size) {
+			const char* bytes = static_cast<const char*>(data);
+			m_data.insert(m_data.end(), bytes, bytes + size);
+		}
+		void Expect(size_t) const {}
+
+	private:
+		std::vector<char> m_data;
+	};
+
+	//========================================================================
+	//	Archive Reader
+	//========================================================================
+
+	// Reads from memory owned by the caller, or from a file mapped by Open. Reading past the end throws, so truncated or corrupt
+	// data never reads out of bounds
+	class ArchiveReader : public Archive<ArchiveReader> {
+	public:
+		friend class Archive<ArchiveReader>;
+		static constexpr bool IS_READING = true;
+
+	public:
+		ArchiveReader(std::span<const char> data);
+		static ArchiveReader Open(const std::string& filename);
+
+		size_t Remaining() const { return m_data.size() - m_position; }
+		bool AtEnd() const { return m_position == m_data.size(); }
+
+	private:
+		void Bytes(void* data, size_t size) {
+			Expect(size);
+			if (size > 0)
+				std::memcpy(data, m_data.data() + m_position, size);
+			m_position += size;
+		}
+		void Expect(size_t size) const {
+			if (size > Remaining())
+				Overflow(size);
+		}
+		[[noreturn]] void Overflow(size_t size) const;
+		void ReadHeader();
+
+	private:
+		MappedFile m_file;
+		std::span<const char> m_data;
+		size_t m_position;
+	};
+}
+
+#include "zore/io/archive.inl"
\ No newline at end of file
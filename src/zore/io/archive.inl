@@ -0,0 +1,109 @@
+#pragma once
+
+#ifdef __INTELLISENSE__
+#include "zore/io/archive.hpp"
+#endif
+
+namespace zore {
+
+	template <typename T>
+	struct is_vector : std::false_type {};
+	template <typename T, typename A>
+	struct is_vector<std::vector<T, A>> : std::true_type {};
+
+	template <typename T>
+	struct is_array : std::false_type {};
+	template <typename T, size_t N>
+	struct is_array<std::array<T, N>> : std::true_type {};
+
+	//========================================================================
+	//	Archive Base
+	//========================================================================
+
+	template <typename Derived>
+	template <typename... Args>
+	Derived& Archive<Derived>::operator()(Args&&... args) {
+		(Process(args), ...);
+		return Self();
+	}
+
+	template <typename Derived>
+	template <typename T>
+	void Archive<Derived>::Process(T& value) {
+		using Type = std::remove_const_t<T>;
+		static_assert(!Derived::IS_READING || !std::is_const_v<T>, "Cannot read into a const value");
+		// The writer only reads from the value, which lets const values be written
+		Type& target = const_cast<Type&>(value);
+
+		if constexpr (bitwise_serializable<Type>) {
+			Self().Bytes(&target, sizeof(Type));
+		}
+		else if constexpr (std::is_same_v<Type, std::string>) {
+			uint32_t size = static_cast<uint32_t>(target.size());
+			Process(size);
+			if constexpr (Derived::IS_READING) {
+				Self().Expect(size);
+				target.resize(size);
+			}
+			Self().Bytes(target.data(), size);
+		}
+		else if constexpr (std::is_same_v<Type, std::vector<bool>>) {
+			// Packed bools have no addressable elements, so each one is stored as a byte
+			uint32_t size = static_cast<uint32_t>(target.size());
+			Process(size);
+			if constexpr (Derived::IS_READING) {
+				Self().Expect(size);
+				target.resize(size);
+			}
+			for (uint32_t i = 0; i < size; i++) {
+				bool element = target[i];
+				Process(element);
+				target[i] = element;
+			}
+		}
+		else if constexpr (is_vector<Type>::value) {
+			uint32_t size = static_cast<uint32_t>(target.size());
+			Process(size);
+			if constexpr (Derived::IS_READING) {
+				// Every element takes at least a byte, so corrupt counts are caught before allocating for them
+				Self().Expect(bitwise_serializable<typename Type::value_type> ? size * sizeof(typename Type::value_type) : size);
+				target.resize(size);
+			}
+			ProcessRange(target.data(), size);
+		}
+		else if constexpr (is_array<Type>::value) {
+			ProcessRange(target.data(), target.size());
+		}
+		else if constexpr (std::is_array_v<Type>) {
+			ProcessRange(&target[0], std::extent_v<Type>);
+		}
+		else if constexpr (serializable<Type, Derived>) {
+			if constexpr (versioned<Type>) {
+				uint32_t version = Type::SERIALIZE_VERSION;
+				Process(version);
+				uint32_t outer = m_version;
+				m_version = version;
+				target.serialize(Self());
+				m_version = outer;
+			}
+			else {
+				target.serialize(Self());
+			}
+		}
+		else {
+			static_assert(sizeof(Type) == 0, "Type cannot be serialized, add a serialize member to it");
+		}
+	}
+
+	template <typename Derived>
+	template <typename T>
+	void Archive<Derived>::ProcessRange(T* values, size_t count) {
+		if constexpr (bitwise_serializable<T>) {
+			Self().Bytes(values, count * sizeof(T));
+		}
+		else {
+			for (size_t i = 0; i < count; i++)
+				Process(values[i]);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "zore/io/asset_loader.hpp"
+#include "zore/structures/thread_pool.hpp"
+#include "zore/debug/profiler.hpp"
+#include <algorithm>
+#include <limits>
+#include <fstream>
+
+namespace zore {
+
+	//========================================================================
+	//	Asset Loader Job
+	//========================================================================
+
+	// Each job keeps loading assets until none are left that can be loaded
+	class AssetLoader::LoadJob : public Job {
+	public:
+		explicit LoadJob(AssetLoader* loader) : m_loader(loader) {}
+
+		void execute() override { m_loader->Work(); }
+
+	private:
+		AssetLoader* m_loader;
+	};
+
+	//========================================================================
+	//	Asset Loader
+	//========================================================================
+
+	void AssetLoader::Asset::Wait() const {
+		for (State state = GetState(); state == State::QUEUED || state == State::LOADING; state = GetState())
+			m_state.wait(state, std::memory_order_acquire);
+	}
+
+	AssetLoader::AssetLoader(thread_pool& pool, size_t memory_budget, const AssetPack* asset_pack, uint32_t max_jobs) :
+		m_pool(pool), m_asset_pack(asset_pack), m_memory_budget(memory_budget), m_memory_used(0), m_max_jobs(std::max(max_jobs, 1u)), m_jobs(0), m_tick(0) {
+	}
+
+	AssetLoader::~AssetLoader() {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (const std::shared_ptr<Asset>& asset : m_queue) {
+			asset->m_error = "The asset loader was destroyed before the asset was loaded";
+			Finish(*asset, State::FAILED);
+		}
+		m_queue.clear();
+		m_idle.wait(lock, [&]() { return m_jobs == 0; });
+	}
+
+	void AssetLoader::Trim() {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		TrimLocked();
+	}
+
+	void AssetLoader::SetMemoryBudget(size_t memory_budget) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_memory_budget = memory_budget;
+		TrimLocked();
+	}
+
+	size_t AssetLoader::GetMemoryUsed() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_memory_used;
+	}
+
+	size_t AssetLoader::GetQueuedCount() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_queue.size();
+	}
+
+	std::shared_ptr<AssetLoader::Asset> AssetLoader::Request(std::string_view key, std::type_index type, int priority,
+		std::vector<std::shared_ptr<Asset>> dependencies, const std::function<std::shared_ptr<Asset>()>& create) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto iter = m_assets.find(key);
+		if (iter != m_assets.end() && iter->second->GetState() != State::FAILED) {
+			Asset& asset = *iter->second;
+			ENSURE(asset.m_type == type, "Asset was already requested as a different type: " + std::string(key));
+			asset.m_last_used = ++m_tick;
+			if (asset.GetState() == State::QUEUED)
+				asset.m_priority = std::max(asset.m_priority, priority);
+			return iter->second;
+		}
+
+		std::shared_ptr<Asset> asset = create();
+		asset->m_dependencies = std::move(dependencies);
+		asset->m_last_used = ++m_tick;
+		if (iter != m_assets.end())
+			iter->second = asset;
+		else
+			m_assets.emplace(std::string(key), asset);
+		m_queue.push_back(asset);
+		Dispatch();
+		return asset;
+	}
+
+	void AssetLoader::Dispatch() {
+		while (m_jobs < m_max_jobs && m_jobs < m_queue.size()) {
+			m_jobs++;
+			m_pool.enqueue(LoadJob(this));
+		}
+	}
+
+	void AssetLoader::Work() {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (std::shared_ptr<Asset> asset = Next()) {
+			asset->m_state.store(State::LOADING, std::memory_order_release);
+			lock.unlock();
+			Process(*asset);
+			lock.lock();
+			Finish(*asset, asset->m_error.empty() ? State::READY : State::FAILED);
+			// Finishing may have made assets that depend on this one loadable
+			Dispatch();
+		}
+		if (--m_jobs == 0)
+			m_idle.notify_all();
+	}
+
+	std::shared_ptr<AssetLoader::Asset> AssetLoader::Next() {
+		// Picks the highest priority asset whose dependencies are ready, and the earliest requested among equals. Assets whose
+		// dependencies failed are failed as well, and removed along the way
+		static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+		size_t best = NONE;
+		for (size_t i = 0; i < m_queue.size();) {
+			Asset& asset = *m_queue[i];
+			bool ready = true;
+			const Asset* failed = nullptr;
+			for (const std::shared_ptr<Asset>& dependency : asset.m_dependencies) {
+				State state = dependency->GetState();
+				ready &= state == State::READY;
+				if (state == State::FAILED)
+					failed = dependency.get();
+			}
+			if (failed) {
+				asset.m_error = "Dependency failed to load: " + failed->m_key;
+				Finish(asset, State::FAILED);
+				m_queue.erase(m_queue.begin() + i);
+				continue;
+			}
+			if (ready && (best == NONE || asset.m_priority > m_queue[best]->m_priority))
+				best = i;
+			i++;
+		}
+		if (best == NONE)
+			return nullptr;
+		std::shared_ptr<Asset> asset = std::move(m_queue[best]);
+		m_queue.erase(m_queue.begin() + best);
+		return asset;
+	}
+
+	void AssetLoader::Process(Asset& asset) {
+		ZoneScoped;
+		const TimePoint start = Time::CurrentTime();
+		asset.m_timings.queued = Time::Duration(asset.m_requested, start);
+		try {
+			std::vector<char> buffer;
+			std::span<const char> data;
+			if (m_asset_pack && m_asset_pack->Has(asset.m_key)) {
+				data = m_asset_pack->Get(asset.m_key);
+			}
+			else {
+				std::ifstream file(asset.m_key, std::ios::binary | std::ios::ate);
+				ENSURE(file.is_open(), "Failed to open asset: " + asset.m_key);
+				buffer.resize(static_cast<size_t>(file.tellg()));
+				file.seekg(0, std::ios::beg);
+				file.read(buffer.data(), buffer.size());
+				ENSURE(file, "Failed to read asset: " + asset.m_key);
+				data = buffer;
+			}
+
+			const TimePoint read = Time::CurrentTime();
+			asset.m_timings.read = Time::Duration(start, read);
+			asset.m_size = asset.Decode(data);
+			asset.m_timings.decode = Time::Elapsed(read);
+		}
+		catch (const std::exception& e) {
+			asset.m_error = e.what();
+			// Exceptions without a message would otherwise look like success
+			if (asset.m_error.empty())
+				asset.m_error = "Failed to load asset: " + asset.m_key;
+		}
+	}
+
+	void AssetLoader::Finish(Asset& asset, State state) {
+		if (state == State::READY) {
+			m_memory_used += asset.m_size;
+			TrimLocked();
+		}
+		asset.m_state.store(state, std::memory_order_release);
+		asset.m_state.notify_all();
+	}
+
+	void AssetLoader::TrimLocked() {
+		if (m_memory_used <= m_memory_budget)
+			return;
+		// Only the loader holds assets with a use count of one, and new handles are only handed out under the lock
+		std::vector<std::pair<uint64_t, std::string_view>> unused;
+		for (const auto& [key, asset] : m_assets) {
+			if (asset.use_count() == 1 && asset->IsReady())
+				unused.emplace_back(asset->m_last_used, key);
+		}
+		std::sort(unused.begin(), unused.end());
+		for (size_t i = 0; i < unused.size() && m_memory_used > m_memory_budget; i++) {
+			auto iter = m_assets.find(unused[i].second);
+			m_memory_used -= iter->second->m_size;
+			m_assets.erase(iter);
+		}
+	}
+}
\ No newline at end of file
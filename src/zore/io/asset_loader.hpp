@@ -0,0 +1,187 @@
+#pragma once
+
+#include "zore/io/asset_pack.hpp"
+#include "zore/structures/string_unordered_map.hpp"
+#include "zore/utils/time.hpp"
+#include "zore/debug.hpp"
+#include <condition_variable>
+#include <typeindex>
+#include <functional>
+#include <optional>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace zore {
+
+	class thread_pool;
+
+	//========================================================================
+	//	Asset Loader
+	//========================================================================
+
+	// Reads and decodes assets on thread pool workers, highest priority first, and once all of their dependencies are ready.
+	// Assets are read from the asset pack when it holds them, and from disk otherwise. Loaded assets are shared by key, and assets
+	// no longer referenced by any handle are evicted, least recently requested first, whenever memory use exceeds the budget
+	class AssetLoader {
+	public:
+		enum class State { QUEUED, LOADING, READY, FAILED };
+
+		// Seconds spent waiting to be loaded, reading the asset's data, and decoding it
+		struct Timings {
+			float queued = 0.f;
+			float read = 0.f;
+			float decode = 0.f;
+		};
+
+		class Asset {
+		public:
+			friend class AssetLoader;
+
+			Asset(std::string_view key, std::type_index type, int priority) : m_key(key), m_type(type), m_priority(priority),
+				m_state(State::QUEUED), m_requested(Time::CurrentTime()), m_size(0), m_last_used(0) {}
+			Asset(const Asset&) = delete;
+			Asset& operator=(const Asset&) = delete;
+			virtual ~Asset() = default;
+
+			State GetState() const { return m_state.load(std::memory_order_acquire); }
+			bool IsReady() const { return GetState() == State::READY; }
+			bool IsDone() const { return GetState() == State::READY || GetState() == State::FAILED; }
+			// Blocks until the asset is ready or has failed
+			void Wait() const;
+
+			const std::string& GetKey() const { return m_key; }
+			// The error, timings and size are only valid once the asset is done. The size is the memory charged against the budget
+			const std::string& GetError() const { return m_error; }
+			const Timings& GetTimings() const { return m_timings; }
+			size_t GetSize() const { return m_size; }
+
+		protected:
+			// Returns the bytes the decoded asset keeps resident
+			virtual size_t Decode(std::span<const char> data) = 0;
+
+		private:
+			std::string m_key;
+			std::type_index m_type;
+			int m_priority;
+			std::atomic<State> m_state;
+			std::vector<std::shared_ptr<Asset>> m_dependencies;
+			std::string m_error;
+			Timings m_timings;
+			TimePoint m_requested;
+			// Bytes the decoded asset keeps resident, which is what counts towards the memory budget
+			size_t m_size;
+			uint64_t m_last_used;
+		};
+
+		template<typename T>
+		using Decoder = std::function<T(std::span<const char>)>;
+		// Reports the bytes a decoded asset keeps resident, such as the pixels of a texture decoded from a much smaller image file
+		template<typename T>
+		using Sizer = std::function<size_t(const T&)>;
+
+	private:
+		template<typename T>
+		class TypedAsset : public Asset {
+		public:
+			TypedAsset(std::string_view key, int priority, Decoder<T> decoder, Sizer<T> sizer) : Asset(key, typeid(T), priority),
+				m_decoder(std::move(decoder)), m_sizer(std::move(sizer)) {}
+
+			const T& Get() const { return *m_value; }
+
+		protected:
+			size_t Decode(std::span<const char> data) override {
+				m_value.emplace(m_decoder(data));
+				// Without a sizer the asset is charged the size of the data it was decoded from
+				size_t size = m_sizer ? m_sizer(*m_value) : data.size();
+				m_decoder = nullptr;
+				m_sizer = nullptr;
+				return size;
+			}
+
+		private:
+			Decoder<T> m_decoder;
+			Sizer<T> m_sizer;
+			std::optional<T> m_value;
+		};
+
+	public:
+		// Keeps an asset loaded. Handles are cheap to copy, and are safe to pass between threads
+		template<typename T>
+		class Handle {
+		public:
+			Handle() = default;
+			explicit Handle(std::shared_ptr<TypedAsset<T>> asset) : m_asset(std::move(asset)) {}
+
+			bool IsValid() const { return m_asset != nullptr; }
+			bool IsReady() const { return m_asset && m_asset->IsReady(); }
+			State GetState() const { return m_asset->GetState(); }
+			void Wait() const { m_asset->Wait(); }
+			const T& Get() const {
+				DEBUG_ENSURE(IsReady(), "Asset is not loaded: " + m_asset->GetKey());
+				return m_asset->Get();
+			}
+			const T& operator*() const { return Get(); }
+			const T* operator->() const { return &Get(); }
+			// Passed to Load as a dependency of another asset
+			std::shared_ptr<Asset> GetAsset() const { return m_asset; }
+
+		private:
+			std::shared_ptr<TypedAsset<T>> m_asset;
+		};
+
+	public:
+		AssetLoader(thread_pool& pool, size_t memory_budget, const AssetPack* asset_pack = nullptr, uint32_t max_jobs = 4);
+		AssetLoader(const AssetLoader&) = delete;
+		AssetLoader& operator=(const AssetLoader&) = delete;
+		~AssetLoader();
+
+		// Returns the existing handle if the key was already requested, and raises its priority if it is still queued. Failed
+		// assets are loaded again
+		template<typename T>
+		Handle<T> Load(std::string_view key, Decoder<T> decoder, int priority = 0, std::vector<std::shared_ptr<Asset>> dependencies = {}) {
+			return Load<T>(key, std::move(decoder), nullptr, priority, std::move(dependencies));
+		}
+		// Charges the asset the size reported by sizer once decoded, instead of the size of the data it was decoded from
+		template<typename T>
+		Handle<T> Load(std::string_view key, Decoder<T> decoder, Sizer<T> sizer, int priority = 0, std::vector<std::shared_ptr<Asset>> dependencies = {}) {
+			std::shared_ptr<Asset> asset = Request(key, typeid(T), priority, std::move(dependencies), [&]() {
+				return std::make_shared<TypedAsset<T>>(key, priority, std::move(decoder), std::move(sizer));
+			});
+			return Handle<T>(std::static_pointer_cast<TypedAsset<T>>(asset));
+		}
+
+		// Evicts unreferenced assets until memory use is within the budget, which also happens after every load
+		void Trim();
+		void SetMemoryBudget(size_t memory_budget);
+		size_t GetMemoryBudget() const { return m_memory_budget; }
+		size_t GetMemoryUsed() const;
+		size_t GetQueuedCount() const;
+
+	private:
+		class LoadJob;
+
+		std::shared_ptr<Asset> Request(std::string_view key, std::type_index type, int priority, std::vector<std::shared_ptr<Asset>> dependencies,
+			const std::function<std::shared_ptr<Asset>()>& create);
+		void Dispatch();
+		void Work();
+		std::shared_ptr<Asset> Next();
+		void Process(Asset& asset);
+		void Finish(Asset& asset, State state);
+		void TrimLocked();
+
+	private:
+		thread_pool& m_pool;
+		const AssetPack* m_asset_pack;
+		size_t m_memory_budget;
+		size_t m_memory_used;
+		uint32_t m_max_jobs;
+		uint32_t m_jobs;
+		uint64_t m_tick;
+
+		zore::string_unordered_map<std::shared_ptr<Asset>> m_assets;
+		std::vector<std::shared_ptr<Asset>> m_queue;
+		mutable std::mutex m_mutex;
+		std::condition_variable m_idle;
+	};
+}
\ No newline at end of file
@@ -1,18 +1,61 @@
 #include "zore/io/asset_pack.hpp"
+#include "zore/io/compression.hpp"
+#include "zore/utils/hash.hpp"
+#include "zore/structures/thread_pool.hpp"
+#include "zore/debug/profiler.hpp"
 #include "zore/debug.hpp"
 #include <filesystem>
+#include <algorithm>
+#include <limits>
+#include <bit>
+#include <atomic>
+#include <cctype>
 #include <cstring>
 #include <fstream>
 
 namespace zore {
 
+	// Version 1 packs have every word XORed with this key
 	static uint32_t hash_key = 0x9E3779B9;
+	static constexpr char MAGIC[4] = { 'Z', 'P', 'K', '2' };
+
+	static uint64_t Align(uint64_t offset, uint64_t alignment) {
+		return (offset + alignment - 1) & ~(alignment - 1);
+	}
 
 	//========================================================================
 	//	Asset Pack
 	//========================================================================
 
 	AssetPack AssetPack::Load(std::string_view filename) {
+		AssetPack pack;
+		pack.m_file = MappedFile::Open(std::string(filename));
+		const char* data = pack.m_file.Data();
+		const size_t size = pack.m_file.Size();
+		if (size < sizeof(Header) || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+			// Packs from before the table of contents have to be decoded and copied in full
+			pack.m_file.Close();
+			LoadLegacy(pack, filename);
+			return pack;
+		}
+
+		Header header;
+		std::memcpy(&header, data, sizeof(Header));
+		ENSURE(header.version == VERSION, "Unsupported asset pack version: " + std::string(filename));
+		ENSURE(sizeof(Header) + header.asset_count * sizeof(Entry) <= header.strings_offset && header.strings_offset <= header.data_offset
+			&& header.data_offset <= size, "Asset pack file is corrupted");
+		// The mapping is page aligned, so the entries following the header are aligned as well
+		pack.m_entries = std::span<const Entry>(reinterpret_cast<const Entry*>(data + sizeof(Header)), header.asset_count);
+		pack.m_strings = data + header.strings_offset;
+		pack.m_flags = header.flags;
+		for (const Entry& entry : pack.m_entries) {
+			ENSURE(entry.key_offset + entry.key_size <= header.data_offset - header.strings_offset, "Asset pack file is corrupted");
+			ENSURE(entry.offset >= header.data_offset && entry.offset <= size && entry.size <= size - entry.offset, "Asset pack file is corrupted");
+		}
+		return pack;
+	}
+
+	void AssetPack::LoadLegacy(AssetPack& pack, std::string_view filename) {
 		std::ifstream file(filename.data(), std::ios::binary | std::ios::ate);
 		ENSURE(file.is_open(), "Failed to load asset pack: " + std::string(filename));
 
@@ -28,7 +71,6 @@ namespace zore {
 		for (size_t i = 0; i < buffer.size() / 4; i++)
 			data[i] ^= hash_key;
 
-		AssetPack pack;
 		char* current = buffer.data();
 		char* end = buffer.data() + buffer.size();
 
@@ -57,7 +99,6 @@ namespace zore {
 		}
 
 		ENSURE(current <= end, "Asset pack file is corrupted");
-		return pack;
 	}
 
 	AssetPack AssetPack::Create(std::vector<std::string_view> assets) {
@@ -78,50 +119,419 @@ namespace zore {
 		return *this;
 	}
 
-	void AssetPack::Save(std::string_view filename) {
-		uint32_t asset_count = static_cast<uint32_t>(m_assets.size());
-		uint32_t buffer_size = 4;
-		for (const auto& [key, value] : m_assets)
-			buffer_size += static_cast<uint32_t>(key.size()) + static_cast<uint32_t>(value.size()) + 8;
-		buffer_size = (buffer_size / 4) * 4 + 4;
-		std::vector<char> buffer(buffer_size);
+	AssetPack::SaveStats AssetPack::Save(std::string_view filename, bool compress, const AssetPack* previous) {
+		ZoneScoped;
+		struct Source {
+			PendingAsset asset;
+			// Added files are read once their batch is saved, while other assets already have their data
+			const std::string* path;
+			std::span<const char> data;
+			const Entry* entry;
+		};
 
-		char* current = buffer.data();
-		std::memcpy(current, &asset_count, 4);
-		current += 4;
+		// Added files replace assets with the same key
+		std::vector<Source> sources;
+		sources.reserve(m_files.size() + m_assets.size() + m_entries.size());
+		for (const auto& [key, path] : m_files)
+			sources.push_back({ { HashKey(key), key, std::filesystem::file_size(path) }, &path, {}, nullptr });
 		for (const auto& [key, value] : m_assets) {
-			uint32_t key_size = static_cast<uint32_t>(key.size());
-			std::memcpy(current, &key_size, 4);
-			current += 4;
-			std::memcpy(current, key.data(), key_size);
-			current += key_size;
-			uint32_t value_size = static_cast<uint32_t>(value.size());
-			std::memcpy(current, &value_size, 4);
-			current += 4;
-			std::memcpy(current, value.data(), value_size);
-			current += value_size;
+			if (m_files.find(key) == m_files.end())
+				sources.push_back({ { HashKey(key), key, value.size() }, nullptr, std::span<const char>(value.data(), value.size()), nullptr });
 		}
+		for (const Entry& entry : m_entries) {
+			std::string_view key = GetKey(entry);
+			if (m_files.find(key) == m_files.end() && m_assets.find(key) == m_assets.end())
+				sources.push_back({ { entry.hash, key, entry.size }, nullptr, GetData(entry), &entry });
+		}
+		std::sort(sources.begin(), sources.end(), [](const Source& a, const Source& b) {
+			return a.asset.hash != b.asset.hash ? a.asset.hash < b.asset.hash : a.asset.key < b.asset.key;
+		});
+		std::vector<PendingAsset> assets(sources.size());
+		for (size_t i = 0; i < sources.size(); i++)
+			assets[i] = sources[i].asset;
 
-		uint32_t* data = reinterpret_cast<uint32_t*>(buffer.data());
-		for (size_t i = 0; i < buffer.size() / 4; i++)
-			data[i] ^= hash_key;
-		
-		std::ofstream file(filename.data(), std::ios::binary);
-		ENSURE(file.is_open(), "Failed to save asset pack: " + std::string(filename));
-		file.write(buffer.data(), buffer.size());
+		// An entry can be copied as it is stored if it is compressed exactly when compression is wanted. Raw entries in packs saved
+		// with compression were already found not to be worth compressing
+		auto is_reusable = [&](const AssetPack& pack, const Entry& entry) {
+			return entry.flags & COMPRESSED ? compress : !compress || (pack.m_flags & PACK_COMPRESSED);
+		};
+
+		auto load = [&](size_t index, Blob& blob) {
+			const Source& source = sources[index];
+			if (source.entry) {
+				blob.content_hash = source.entry->content_hash;
+				if (is_reusable(*this, *source.entry)) {
+					blob.data = source.data;
+					blob.flags = source.entry->flags;
+					blob.encoded = true;
+				}
+				else if (source.entry->flags & COMPRESSED) {
+					blob.buffer = Inflate(*source.entry);
+					blob.data = blob.buffer;
+				}
+				else {
+					blob.data = source.data;
+				}
+				return;
+			}
+
+			if (source.path) {
+				blob.buffer = ReadFile(*source.path);
+				blob.data = blob.buffer;
+			}
+			else {
+				blob.data = source.data;
+			}
+			blob.content_hash = zore::Hash::XXH64(blob.data);
+
+			// Unchanged assets are copied from whichever pack already holds them in the form they would be saved in
+			for (const AssetPack* pack : { static_cast<const AssetPack*>(this), previous }) {
+				const Entry* match = pack ? pack->FindUnchanged(source.asset.key, blob.content_hash) : nullptr;
+				if (match && is_reusable(*pack, *match)) {
+					blob.buffer = std::vector<char>();
+					blob.data = pack->GetData(*match);
+					blob.flags = match->flags;
+					blob.encoded = true;
+					return;
+				}
+			}
+		};
+
+		auto encode = [&](size_t index, Blob& blob) {
+			if (!compress || !IsCompressible(assets[index].key, blob.data.size()))
+				return;
+			std::vector<char> compressed = Compress(blob.data, m_pool);
+			if (compressed.empty())
+				return;
+			blob.buffer = std::move(compressed);
+			blob.data = blob.buffer;
+			blob.flags = COMPRESSED;
+		};
+
+		return Write(filename, compress ? static_cast<uint32_t>(PACK_COMPRESSED) : 0u, assets, m_pool, load, encode);
+	}
+
+	AssetPack::SaveStats AssetPack::Write(std::string_view filename, uint32_t flags, const std::vector<PendingAsset>& assets, thread_pool* pool,
+		const BlobCallback& load, const BlobCallback& encode) {
+		Header header;
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.asset_count = static_cast<uint32_t>(assets.size());
+		header.flags = flags;
+		header.strings_offset = sizeof(Header) + assets.size() * sizeof(Entry);
+		SaveStats stats = { assets.size(), 0, 0, 0 };
+
+		std::vector<Entry> entries(assets.size());
+		uint64_t offset = 0;
+		for (size_t i = 0; i < assets.size(); i++) {
+			ENSURE(assets[i].key.size() <= std::numeric_limits<uint16_t>::max(), "Asset key is too long: " + std::string(assets[i].key));
+			entries[i].hash = assets[i].hash;
+			entries[i].key_offset = static_cast<uint32_t>(offset);
+			entries[i].key_size = static_cast<uint16_t>(assets[i].key.size());
+			entries[i].alignment_log2 = static_cast<uint8_t>(std::countr_zero(DEFAULT_ALIGNMENT));
+			offset += assets[i].key.size();
+		}
+		header.data_offset = Align(header.strings_offset + offset, DEFAULT_ALIGNMENT);
+
+		// Written next to the target and renamed over it, so that a failed save never leaves a half written pack. On Linux a pack
+		// mapping the target keeps reading the old file, but Windows cannot replace a file while it is mapped
+		std::string temporary = std::string(filename) + ".tmp";
+		{
+			// Opened for reading as well, so that duplicates can be compared against assets already written
+			std::fstream file(temporary, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+			ENSURE(file.is_open(), "Failed to save asset pack: " + std::string(filename));
+
+			// The table of contents is written again at the end, once the offsets and sizes of the assets are known
+			file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+			file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+			for (const PendingAsset& asset : assets)
+				file.write(asset.key.data(), asset.key.size());
+			offset = header.strings_offset + offset;
+
+			// Assets are loaded and encoded a batch at a time, so that only one batch is held in memory while it is written. Assets
+			// with the same contents as an earlier asset are not encoded or written, and share the earlier asset's data instead
+			std::vector<Blob> blobs;
+			std::unordered_map<uint64_t, size_t> contents;
+			for (size_t begin = 0; begin < assets.size();) {
+				size_t end = begin;
+				uint64_t batch_size = 0;
+				while (end < assets.size() && (end == begin || batch_size + assets[end].size <= SAVE_BATCH_SIZE))
+					batch_size += assets[end++].size;
+
+				blobs.clear();
+				blobs.resize(end - begin);
+				auto load_batch = [&](size_t first, size_t last) {
+					for (size_t i = first; i < last; i++)
+						load(begin + i, blobs[i]);
+				};
+				auto encode_batch = [&](size_t first, size_t last) {
+					for (size_t i = first; i < last; i++) {
+						if (!blobs[i].encoded && blobs[i].duplicate == NO_DUPLICATE)
+							encode(begin + i, blobs[i]);
+					}
+				};
+				// The content hash only finds the first earlier asset with the same hash, whose data is shared once their contents
+				// compare equal. Assets from earlier batches are read back from the file
+				auto same_contents = [&](const Blob& blob, size_t original) {
+					std::vector<char> stored;
+					std::span<const char> data;
+					uint8_t original_flags;
+					if (original >= begin) {
+						data = blobs[original - begin].data;
+						original_flags = blobs[original - begin].flags;
+					}
+					else {
+						stored.resize(entries[original].size);
+						file.seekg(entries[original].offset);
+						file.read(stored.data(), stored.size());
+						file.seekp(offset);
+						ENSURE(file, "Failed to write asset pack: " + std::string(filename));
+						data = stored;
+						original_flags = entries[original].flags;
+					}
+					if (original_flags == blob.flags && data.size() == blob.data.size() && std::memcmp(data.data(), blob.data.data(), data.size()) == 0)
+						return true;
+					if (!(original_flags & COMPRESSED) && !(blob.flags & COMPRESSED))
+						return false;
+					std::vector<char> original_storage, blob_storage;
+					std::span<const char> a = original_flags & COMPRESSED ? std::span<const char>(original_storage = Inflate(data, pool)) : data;
+					std::span<const char> b = blob.flags & COMPRESSED ? std::span<const char>(blob_storage = Inflate(blob.data, pool)) : blob.data;
+					return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size()) == 0;
+				};
+
+				if (pool)
+					pool->parallel_for(end - begin, 1, load_batch);
+				else
+					load_batch(0, end - begin);
+				for (size_t i = begin; i < end; i++) {
+					Blob& blob = blobs[i - begin];
+					auto [iter, inserted] = contents.try_emplace(blob.content_hash, i);
+					ENSURE(!inserted || !blob.shared, "Shared asset has no earlier asset to share: " + std::string(assets[i].key));
+					if (inserted || (!blob.shared && !same_contents(blob, iter->second)))
+						continue;
+					blob.duplicate = iter->second;
+					blob.buffer = std::vector<char>();
+				}
+				if (pool)
+					pool->parallel_for(end - begin, 1, encode_batch);
+				else
+					encode_batch(0, end - begin);
+
+				for (size_t i = begin; i < end; i++) {
+					const Blob& blob = blobs[i - begin];
+					entries[i].content_hash = blob.content_hash;
+					if (blob.duplicate != NO_DUPLICATE) {
+						const Entry& original = entries[blob.duplicate];
+						entries[i].offset = original.offset;
+						entries[i].size = original.size;
+						entries[i].flags = original.flags;
+						stats.deduplicated_size += original.size;
+						continue;
+					}
+					for (uint64_t aligned = Align(offset, uint64_t(1) << entries[i].alignment_log2); offset < aligned; offset++)
+						file.put(0);
+					entries[i].offset = offset;
+					entries[i].size = blob.data.size();
+					entries[i].flags = blob.flags;
+					file.write(blob.data.data(), blob.data.size());
+					offset += blob.data.size();
+					stats.unique_count++;
+					stats.stored_size += blob.data.size();
+				}
+				begin = end;
+			}
+			// Packs without any assets still need their data offset to be within the file
+			for (; offset < header.data_offset; offset++)
+				file.put(0);
+
+			file.seekp(sizeof(Header));
+			file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+			ENSURE(file, "Failed to write asset pack: " + std::string(filename));
+		}
+		std::error_code error;
+		std::filesystem::rename(temporary, filename, error);
+		if (error) {
+			std::string reason = error.message();
+			std::filesystem::remove(temporary, error);
+			throw ZORE_EXCEPTION("Failed to replace asset pack " + std::string(filename) + ", which may still be loaded: " + reason);
+		}
+		return stats;
 	}
 
 	bool AssetPack::Has(std::string_view path) const {
-		return m_assets.find(path) != m_assets.end();
+		return m_files.find(path) != m_files.end() || m_assets.find(path) != m_assets.end() || Find(path);
 	}
 
 	std::span<const char> AssetPack::Get(std::string_view path) const {
+		auto file = m_files.find(path);
+		if (file != m_files.end()) {
+			{
+				std::lock_guard<std::mutex> lock(*m_mutex);
+				auto iter = m_loaded.find(path);
+				if (iter != m_loaded.end())
+					return std::span<const char>(iter->second.data(), iter->second.size());
+			}
+			std::vector<char> buffer = ReadFile(file->second);
+			std::lock_guard<std::mutex> lock(*m_mutex);
+			auto [iter, inserted] = m_loaded.try_emplace(file->first, std::move(buffer));
+			return std::span<const char>(iter->second.data(), iter->second.size());
+		}
+
 		auto iter = m_assets.find(path);
 		if (iter != m_assets.end())
 			return std::span<const char>(iter->second.data(), iter->second.size());
+		if (const Entry* entry = Find(path))
+			return entry->flags & COMPRESSED ? Decompress(*entry) : GetData(*entry);
 		return std::span<const char>();
 	}
 
+	uint64_t AssetPack::HashKey(std::string_view key) {
+		// 64 bit FNV-1a, spelled out so that the hashes saved in packs do not depend on the platform's size_t
+		uint64_t hash = 14695981039346656037ull;
+		for (char c : key)
+			hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+		return hash;
+	}
+
+	const AssetPack::Entry* AssetPack::Find(std::string_view key) const {
+		const uint64_t hash = HashKey(key);
+		auto iter = std::lower_bound(m_entries.begin(), m_entries.end(), hash, [](const Entry& entry, uint64_t hash) {
+			return entry.hash < hash;
+		});
+		for (; iter != m_entries.end() && iter->hash == hash; ++iter) {
+			if (GetKey(*iter) == key)
+				return &*iter;
+		}
+		return nullptr;
+	}
+
+	const AssetPack::Entry* AssetPack::FindUnchanged(std::string_view key, uint64_t content_hash) const {
+		const Entry* entry = Find(key);
+		return entry && entry->content_hash == content_hash ? entry : nullptr;
+	}
+
+	std::string_view AssetPack::GetKey(const Entry& entry) const {
+		return std::string_view(m_strings + entry.key_offset, entry.key_size);
+	}
+
+	std::span<const char> AssetPack::GetData(const Entry& entry) const {
+		return std::span<const char>(m_file.Data() + entry.offset, entry.size);
+	}
+
+	std::span<const char> AssetPack::Decompress(const Entry& entry) const {
+		{
+			std::lock_guard<std::mutex> lock(*m_mutex);
+			auto iter = m_decompressed.find(entry.offset);
+			if (iter != m_decompressed.end())
+				return std::span<const char>(iter->second.data(), iter->second.size());
+		}
+
+		// Decompress without holding the lock, so that other assets can be decompressed at the same time
+		std::vector<char> buffer = Inflate(entry);
+		// Another thread may have decompressed the same asset in the meantime, in which case its copy is kept
+		std::lock_guard<std::mutex> lock(*m_mutex);
+		auto [iter, inserted] = m_decompressed.try_emplace(entry.offset, std::move(buffer));
+		return std::span<const char>(iter->second.data(), iter->second.size());
+	}
+
+	std::vector<char> AssetPack::Inflate(const Entry& entry) const {
+		return Inflate(GetData(entry), m_pool);
+	}
+
+	std::vector<char> AssetPack::Inflate(std::span<const char> data, thread_pool* pool) {
+		ZoneScoped;
+		BlockFrame frame;
+		ENSURE(data.size() >= sizeof(BlockFrame), "Asset pack file is corrupted");
+		std::memcpy(&frame, data.data(), sizeof(BlockFrame));
+		ENSURE(frame.block_size > 0 && frame.block_count == (frame.size + frame.block_size - 1) / frame.block_size, "Asset pack file is corrupted");
+		ENSURE(data.size() - sizeof(BlockFrame) >= frame.block_count * sizeof(uint32_t), "Asset pack file is corrupted");
+
+		std::vector<uint32_t> sizes(frame.block_count);
+		std::memcpy(sizes.data(), data.data() + sizeof(BlockFrame), sizes.size() * sizeof(uint32_t));
+		std::vector<uint64_t> offsets(frame.block_count + 1);
+		offsets[0] = sizeof(BlockFrame) + sizes.size() * sizeof(uint32_t);
+		for (size_t i = 0; i < sizes.size(); i++)
+			offsets[i + 1] = offsets[i] + sizes[i];
+		ENSURE(offsets.back() <= data.size(), "Asset pack file is corrupted");
+
+		std::vector<char> buffer(frame.size);
+		std::atomic<bool> valid = true;
+		auto decompress = [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				std::span<const char> block = data.subspan(offsets[i], sizes[i]);
+				std::span<char> output = std::span<char>(buffer).subspan(i * frame.block_size, std::min<uint64_t>(frame.block_size, frame.size - i * frame.block_size));
+				if (block.size() == output.size())
+					std::memcpy(output.data(), block.data(), block.size());
+				else if (!Compression::Decompress(block, output))
+					valid = false;
+			}
+		};
+		if (pool && frame.block_count > 1)
+			pool->parallel_for(frame.block_count, 1, decompress);
+		else
+			decompress(0, frame.block_count);
+		ENSURE(valid, "Asset pack file is corrupted");
+		return buffer;
+	}
+
+	bool AssetPack::IsCompressible(std::string_view key, size_t size) {
+		// Formats that are compressed already only get bigger
+		static constexpr std::string_view COMPRESSED_EXTENSIONS[] = {
+			".png", ".jpg", ".jpeg", ".webp", ".ktx2", ".ogg", ".mp3", ".flac", ".zip", ".gz", ".zst", ".lz4"
+		};
+		if (size < MIN_COMPRESSED_SIZE)
+			return false;
+		size_t dot = key.rfind('.');
+		if (dot == std::string_view::npos || key.size() - dot > 8)
+			return true;
+		std::string extension(key.substr(dot));
+		for (char& c : extension)
+			c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+		return std::find(std::begin(COMPRESSED_EXTENSIONS), std::end(COMPRESSED_EXTENSIONS), extension) == std::end(COMPRESSED_EXTENSIONS);
+	}
+
+	std::vector<char> AssetPack::Compress(std::span<const char> data, thread_pool* pool) {
+		ZoneScoped;
+		BlockFrame frame = { data.size(), static_cast<uint32_t>(BLOCK_SIZE), static_cast<uint32_t>((data.size() + BLOCK_SIZE - 1) / BLOCK_SIZE) };
+		std::vector<std::vector<char>> blocks(frame.block_count);
+		auto compress = [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				std::span<const char> block = data.subspan(i * BLOCK_SIZE, std::min(BLOCK_SIZE, data.size() - i * BLOCK_SIZE));
+				blocks[i].resize(Compression::Bound(block.size()));
+				size_t size = Compression::Compress(block, blocks[i]);
+				if (size < block.size())
+					blocks[i].resize(size);
+				else
+					blocks[i].assign(block.begin(), block.end());
+			}
+		};
+		if (pool && frame.block_count > 1)
+			pool->parallel_for(frame.block_count, 1, compress);
+		else
+			compress(0, frame.block_count);
+
+		size_t size = sizeof(BlockFrame) + blocks.size() * sizeof(uint32_t);
+		for (const std::vector<char>& block : blocks)
+			size += block.size();
+		if (static_cast<float>(size) > static_cast<float>(data.size()) * COMPRESSION_RATIO)
+			return {};
+
+		std::vector<char> result(size);
+		char* current = result.data();
+		std::memcpy(current, &frame, sizeof(BlockFrame));
+		current += sizeof(BlockFrame);
+		for (const std::vector<char>& block : blocks) {
+			uint32_t block_size = static_cast<uint32_t>(block.size());
+			std::memcpy(current, &block_size, sizeof(uint32_t));
+			current += sizeof(uint32_t);
+		}
+		for (const std::vector<char>& block : blocks) {
+			std::memcpy(current, block.data(), block.size());
+			current += block.size();
+		}
+		return result;
+	}
+
 	void AssetPack::AddFolder(std::string_view path, std::string_view root) {
 		for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
 			if (!entry.is_regular_file())
@@ -133,14 +543,19 @@ namespace zore {
 	}
 
 	void AssetPack::AddFile(std::string_view path, std::string_view key) {
-		std::ifstream file(path.data(), std::ios::binary | std::ios::ate);
-		ENSURE(file.is_open(), "Failed to add file to asset pack: " + std::string(path));
+		m_files[std::string(key)] = std::string(path);
+		m_loaded.erase(std::string(key));
+	}
+
+	std::vector<char> AssetPack::ReadFile(const std::string& path) {
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		ENSURE(file.is_open(), "Failed to add file to asset pack: " + path);
 
 		std::streamsize size = file.tellg();
 		file.seekg(0, std::ios::beg);
 		std::vector<char> buffer(size);
 		file.read(buffer.data(), size);
-
-		m_assets[std::string(key)] = std::move(buffer);
+		ENSURE(file, "Failed to read file for asset pack: " + path);
+		return buffer;
 	}
 }
\ No newline at end of file
@@ -1,35 +1,175 @@
 #pragma once
 
 #include "zore/structures/string_unordered_map.hpp"
+#include "zore/io/mapped_file.hpp"
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <span>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <limits>
 
 namespace zore {
 
+	class thread_pool;
+
 	//========================================================================
 	//	Asset Pack
 	//========================================================================
 
+	// Packs are saved with a table of contents sorted by key hash, followed by the keys and then the asset data, which is stored
+	// once for every distinct content hash. Loading a pack only maps it into memory, and assets are returned as views into the
+	// mapping, so untouched assets are never read from disk. Added files take priority over the assets in the file, and are only
+	// read once they are saved or requested. Compressed assets are split into blocks which are decompressed in parallel on first
+	// access, and kept for the life of the pack
 	class AssetPack {
+		friend class AssetPatch;
+
+	public:
+		static constexpr uint32_t VERSION = 2;
+		static constexpr uint32_t DEFAULT_ALIGNMENT = 16;
+		static constexpr size_t BLOCK_SIZE = 256 * 1024;
+		// Assets smaller than this, or that do not compress to within COMPRESSION_RATIO of their size, are stored raw
+		static constexpr size_t MIN_COMPRESSED_SIZE = 256;
+		static constexpr float COMPRESSION_RATIO = 0.9f;
+		// Save reads and compresses roughly this many bytes of assets at a time, before streaming them to disk
+		static constexpr size_t SAVE_BATCH_SIZE = 64 * 1024 * 1024;
+
+	private:
+		struct Header {
+			char magic[4];
+			uint32_t version;
+			uint32_t asset_count;
+			uint32_t flags;
+			uint64_t strings_offset;
+			uint64_t data_offset;
+		};
+
+		struct Entry {
+			uint64_t hash;
+			// XXH64 of the uncompressed asset
+			uint64_t content_hash;
+			// Offset of the asset from the start of the file, and of the key from the start of the string table
+			uint64_t offset;
+			uint64_t size;
+			uint32_t key_offset;
+			uint16_t key_size;
+			uint8_t alignment_log2;
+			uint8_t flags;
+		};
+
+		enum HeaderFlags : uint32_t {
+			// Set when the pack was saved with compression turned on
+			PACK_COMPRESSED = 1 << 0
+		};
+
+		enum EntryFlags : uint8_t {
+			COMPRESSED = 1 << 0
+		};
+
+		// Starts the data of compressed assets, followed by the compressed size of each block and then the blocks. Blocks
+		// stored at their full size did not compress, and are stored raw
+		struct BlockFrame {
+			uint64_t size;
+			uint32_t block_size;
+			uint32_t block_count;
+		};
+
+		static constexpr size_t NO_DUPLICATE = std::numeric_limits<size_t>::max();
+
+		// An asset being saved. Loading fills in its data and content hash, and encoding compresses the data unless it was
+		// already loaded in the form it is stored in
+		struct PendingAsset {
+			uint64_t hash;
+			std::string_view key;
+			// Expected size of the asset, used to split saving into batches
+			uint64_t size;
+		};
+
+		struct Blob {
+			std::vector<char> buffer;
+			std::span<const char> data;
+			uint64_t content_hash = 0;
+			uint8_t flags = 0;
+			bool encoded = false;
+			// Set when loading already knows the asset shares the data of the first earlier asset with its content hash, in
+			// which case it is left without data
+			bool shared = false;
+			// The earlier asset with the same contents, whose data this one shares
+			size_t duplicate = NO_DUPLICATE;
+		};
+
+		using BlobCallback = std::function<void(size_t, Blob&)>;
+
+	public:
+		struct SaveStats {
+			size_t asset_count;
+			// Assets with the same contents share their data, which is only counted once
+			size_t unique_count;
+			uint64_t stored_size;
+			// Bytes that would have been written again for duplicate assets
+			uint64_t deduplicated_size;
+		};
+
 	public:
 		AssetPack() = default;
+		AssetPack(const AssetPack&) = delete;
+		AssetPack(AssetPack&&) = default;
+		AssetPack& operator=(const AssetPack&) = delete;
+		AssetPack& operator=(AssetPack&&) = default;
 		~AssetPack() = default;
 
 		static AssetPack Load(std::string_view filename);
 		static AssetPack Create(std::vector<std::string_view> assets = {});
 
+		// Compression and decompression are spread over the pool's threads when one is set
+		AssetPack& SetThreadPool(thread_pool* pool) { m_pool = pool; return *this; }
 		AssetPack& Add(std::string_view path, std::string_view root = "");
-		void Save(std::string_view filename);
+		// Assets whose contents match the asset with the same key in {previous} are copied from it as they are stored there,
+		// which skips compressing them again when rebuilding a pack after small changes. On Windows the file cannot be one that a
+		// loaded pack maps, including {previous}, since a mapped file cannot be replaced there
+		SaveStats Save(std::string_view filename, bool compress = true, const AssetPack* previous = nullptr);
 		bool Has(std::string_view path) const;
+		// The returned span stays valid until the pack is destroyed, or the asset is replaced
 		std::span<const char> Get(std::string_view path) const;
 
 	private:
+		static uint64_t HashKey(std::string_view key);
+		static void LoadLegacy(AssetPack& pack, std::string_view filename);
+		// Streams assets to a pack file in the given order, which has to be sorted by key hash and then key
+		static SaveStats Write(std::string_view filename, uint32_t flags, const std::vector<PendingAsset>& assets, thread_pool* pool,
+			const BlobCallback& load, const BlobCallback& encode);
+		const Entry* Find(std::string_view key) const;
+		std::string_view GetKey(const Entry& entry) const;
+		std::span<const char> GetData(const Entry& entry) const;
+		std::span<const char> Decompress(const Entry& entry) const;
+		std::vector<char> Inflate(const Entry& entry) const;
+		static std::vector<char> Inflate(std::span<const char> data, thread_pool* pool);
+		const Entry* FindUnchanged(std::string_view key, uint64_t content_hash) const;
+		static std::vector<char> ReadFile(const std::string& path);
+		static bool IsCompressible(std::string_view key, size_t size);
+		static std::vector<char> Compress(std::span<const char> data, thread_pool* pool);
 
 		void AddFolder(std::string_view path, std::string_view root);
 		void AddFile(std::string_view path, std::string_view key);
 
 	private:
+		// Assets decoded from version 1 packs, and the paths of added files by key
 		zore::string_unordered_map<std::vector<char>> m_assets;
+		zore::string_unordered_map<std::string> m_files;
+		MappedFile m_file;
+		std::span<const Entry> m_entries;
+		const char* m_strings = nullptr;
+		uint32_t m_flags = 0;
+		thread_pool* m_pool = nullptr;
+
+		// Decompressed assets by data offset, so that keys sharing data share a copy. Nodes never move, so the spans returned by
+		// Get stay valid
+		mutable std::unordered_map<size_t, std::vector<char>> m_decompressed;
+		// Added files that have been requested through Get
+		mutable zore::string_unordered_map<std::vector<char>> m_loaded;
+		std::unique_ptr<std::mutex> m_mutex = std::make_unique<std::mutex>();
 	};
 }
\ No newline at end of file
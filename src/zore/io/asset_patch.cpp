@@ -0,0 +1,339 @@
+#include "zore/io/asset_patch.hpp"
+#include "zore/utils/hash.hpp"
+#include "zore/debug/profiler.hpp"
+#include "zore/debug.hpp"
+#include <unordered_map>
+#include <set>
+#include <cstring>
+#include <fstream>
+
+namespace zore {
+
+	static constexpr char PATCH_MAGIC[4] = { 'Z', 'P', 'T', '1' };
+	static constexpr uint32_t NO_BLOCK = std::numeric_limits<uint32_t>::max();
+	// Bounds the blocks compared against a single weak hash, so that repetitive data cannot make diffing quadratic
+	static constexpr uint32_t MAX_CANDIDATES = 16;
+
+	template<typename T>
+	static void Append(std::vector<char>& buffer, const T& value) {
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+	}
+
+	template<typename T>
+	static T Read(const char*& current, const char* end) {
+		T value;
+		ENSURE(static_cast<size_t>(end - current) >= sizeof(T), "Asset patch is corrupted");
+		std::memcpy(&value, current, sizeof(T));
+		current += sizeof(T);
+		return value;
+	}
+
+	//========================================================================
+	//	Rolling Checksum
+	//========================================================================
+
+	// Adler style checksum of a window of DELTA_BLOCK_SIZE bytes, which can be slid along by a byte in constant time
+	class RollingChecksum {
+	public:
+		explicit RollingChecksum(const uint8_t* data) : m_sum(0), m_weighted(0) {
+			for (uint32_t i = 0; i < AssetPatch::DELTA_BLOCK_SIZE; i++) {
+				m_sum += data[i];
+				m_weighted += (AssetPatch::DELTA_BLOCK_SIZE - i) * data[i];
+			}
+		}
+
+		void Roll(uint8_t removed, uint8_t added) {
+			m_sum += added - removed;
+			m_weighted += m_sum - AssetPatch::DELTA_BLOCK_SIZE * removed;
+		}
+
+		uint32_t Get() const { return (m_sum & 0xFFFF) | (m_weighted << 16); }
+
+	private:
+		uint32_t m_sum;
+		uint32_t m_weighted;
+	};
+
+	//========================================================================
+	//	Asset Patch
+	//========================================================================
+
+	AssetPatch::Stats AssetPatch::Create(const AssetPack& base, const AssetPack& target, std::string_view filename) {
+		ZoneScoped;
+		ENSURE(base.m_files.empty() && base.m_assets.empty() && target.m_files.empty() && target.m_assets.empty(),
+			"Asset patches can only be made between saved packs");
+		std::unordered_map<uint64_t, const AssetPack::Entry*> contents;
+		for (const AssetPack::Entry& entry : base.m_entries)
+			contents.try_emplace(entry.content_hash, &entry);
+		std::vector<std::string_view> removed;
+		for (const AssetPack::Entry& entry : base.m_entries) {
+			if (!target.Find(base.GetKey(entry)))
+				removed.push_back(base.GetKey(entry));
+		}
+
+		Stats stats = { 0, 0, 0, removed.size(), 0 };
+		Header header;
+		std::memcpy(header.magic, PATCH_MAGIC, sizeof(PATCH_MAGIC));
+		header.version = VERSION;
+		header.base_hash = HashContents(base);
+		header.asset_count = static_cast<uint32_t>(target.m_entries.size());
+		header.removed_count = static_cast<uint32_t>(removed.size());
+		header.pack_flags = target.m_flags;
+		header.reserved = 0;
+
+		std::ofstream file(filename.data(), std::ios::binary);
+		ENSURE(file.is_open(), "Failed to save asset patch: " + std::string(filename));
+		file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+		// Duplicates are only recorded where the target pack shares data between assets, which its save already compared
+		std::set<std::pair<uint64_t, uint64_t>> written;
+		for (const AssetPack::Entry& entry : target.m_entries) {
+			const std::string_view key = target.GetKey(entry);
+			Record record = { entry.content_hash, 0, entry.key_size, Operation::ADD, entry.flags, 0 };
+			std::span<const char> payload;
+			std::vector<char> delta;
+
+			auto match = contents.find(entry.content_hash);
+			if (!written.insert({ entry.offset, entry.size }).second) {
+				record.operation = Operation::DUPLICATE;
+			}
+			else if (match != contents.end() && match->second->flags == entry.flags && SameData(base, *match->second, target, entry)) {
+				record.operation = Operation::COPY;
+				stats.unchanged_count++;
+			}
+			else {
+				payload = target.GetData(entry);
+				const AssetPack::Entry* previous = base.Find(key);
+				if (previous) {
+					std::vector<char> target_storage, base_storage;
+					std::span<const char> target_contents = GetContents(target, entry, target_storage);
+					if (target_contents.size() >= DELTA_MIN_SIZE) {
+						delta = Diff(GetContents(base, *previous, base_storage), target_contents);
+						if (delta.size() < payload.size()) {
+							record.operation = Operation::DELTA;
+							payload = delta;
+						}
+					}
+					stats.changed_count++;
+				}
+				else {
+					stats.added_count++;
+				}
+			}
+
+			record.payload_size = payload.size();
+			file.write(reinterpret_cast<const char*>(&record), sizeof(Record));
+			file.write(key.data(), key.size());
+			file.write(payload.data(), payload.size());
+		}
+		for (std::string_view key : removed) {
+			const uint16_t key_size = static_cast<uint16_t>(key.size());
+			file.write(reinterpret_cast<const char*>(&key_size), sizeof(uint16_t));
+			file.write(key.data(), key.size());
+		}
+
+		ENSURE(file, "Failed to write asset patch: " + std::string(filename));
+		stats.patch_size = static_cast<uint64_t>(file.tellp());
+		return stats;
+	}
+
+	void AssetPatch::Apply(const AssetPack& base, std::string_view patch_filename, std::string_view filename, thread_pool* pool) {
+		ZoneScoped;
+		struct Item {
+			Record record;
+			std::string_view key;
+			std::span<const char> payload;
+		};
+
+		MappedFile patch = MappedFile::Open(std::string(patch_filename));
+		const char* current = patch.Data();
+		const char* end = current + patch.Size();
+		Header header = Read<Header>(current, end);
+		ENSURE(std::memcmp(header.magic, PATCH_MAGIC, sizeof(PATCH_MAGIC)) == 0 && header.version == VERSION, "Unsupported asset patch: " + std::string(patch_filename));
+		ENSURE(header.base_hash == HashContents(base), "Asset patch does not apply to this pack: " + std::string(patch_filename));
+
+		std::vector<Item> items(header.asset_count);
+		std::vector<AssetPack::PendingAsset> assets(header.asset_count);
+		for (uint32_t i = 0; i < header.asset_count; i++) {
+			Item& item = items[i];
+			item.record = Read<Record>(current, end);
+			ENSURE(static_cast<size_t>(end - current) >= item.record.key_size, "Asset patch is corrupted");
+			item.key = std::string_view(current, item.record.key_size);
+			current += item.record.key_size;
+			ENSURE(static_cast<uint64_t>(end - current) >= item.record.payload_size, "Asset patch is corrupted");
+			item.payload = std::span<const char>(current, item.record.payload_size);
+			current += item.record.payload_size;
+			assets[i] = { AssetPack::HashKey(item.key), item.key, item.record.payload_size };
+		}
+
+		std::unordered_map<uint64_t, const AssetPack::Entry*> contents;
+		for (const AssetPack::Entry& entry : base.m_entries)
+			contents.try_emplace(entry.content_hash, &entry);
+
+		auto load = [&](size_t index, AssetPack::Blob& blob) {
+			const Item& item = items[index];
+			blob.content_hash = item.record.content_hash;
+			switch (item.record.operation) {
+			case Operation::COPY: {
+				auto match = contents.find(item.record.content_hash);
+				ENSURE(match != contents.end() && match->second->flags == item.record.flags, "Asset patch does not apply to this pack");
+				blob.data = base.GetData(*match->second);
+				blob.flags = item.record.flags;
+				blob.encoded = true;
+				break;
+			}
+			case Operation::ADD:
+				blob.data = item.payload;
+				blob.flags = item.record.flags;
+				blob.encoded = true;
+				break;
+			case Operation::DELTA: {
+				const AssetPack::Entry* previous = base.Find(item.key);
+				ENSURE(previous, "Asset patch does not apply to this pack");
+				std::vector<char> storage;
+				blob.buffer = Patch(GetContents(base, *previous, storage), item.payload);
+				blob.data = blob.buffer;
+				ENSURE(Hash::XXH64(blob.data) == item.record.content_hash, "Asset patch produced the wrong contents for: " + std::string(item.key));
+				blob.encoded = !(item.record.flags & AssetPack::COMPRESSED);
+				break;
+			}
+			case Operation::DUPLICATE:
+				// Writing finds the earlier asset with the same content hash, and shares its data
+				blob.shared = true;
+				break;
+			default:
+				ENSURE(false, "Asset patch is corrupted");
+			}
+		};
+
+		// Compression is deterministic, so recompressing a patched asset reproduces the target pack's data
+		auto encode = [&](size_t index, AssetPack::Blob& blob) {
+			std::vector<char> compressed = AssetPack::Compress(blob.data, pool);
+			ENSURE(!compressed.empty(), "Asset patch produced the wrong contents for: " + std::string(items[index].key));
+			blob.buffer = std::move(compressed);
+			blob.data = blob.buffer;
+			blob.flags = AssetPack::COMPRESSED;
+		};
+
+		AssetPack::Write(filename, header.pack_flags, assets, pool, load, encode);
+	}
+
+	std::span<const char> AssetPatch::GetContents(const AssetPack& pack, const AssetPack::Entry& entry, std::vector<char>& storage) {
+		if (!(entry.flags & AssetPack::COMPRESSED))
+			return pack.GetData(entry);
+		storage = pack.Inflate(entry);
+		return storage;
+	}
+
+	bool AssetPatch::SameData(const AssetPack& first, const AssetPack::Entry& first_entry, const AssetPack& second, const AssetPack::Entry& second_entry) {
+		std::span<const char> a = first.GetData(first_entry);
+		std::span<const char> b = second.GetData(second_entry);
+		return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size()) == 0;
+	}
+
+	uint64_t AssetPatch::HashContents(const AssetPack& pack) {
+		return Hash::XXH64(std::span<const char>(reinterpret_cast<const char*>(pack.m_entries.data()), pack.m_entries.size_bytes()));
+	}
+
+	std::vector<char> AssetPatch::Diff(std::span<const char> base, std::span<const char> target) {
+		ZoneScoped;
+		std::vector<char> delta;
+		size_t literal_start = 0;
+		uint32_t copy_first = NO_BLOCK;
+		uint32_t copy_count = 0;
+		auto flush = [&](size_t literal_end) {
+			if (copy_count > 0) {
+				Append(delta, COPY_BLOCKS);
+				Append(delta, copy_first);
+				Append(delta, copy_count);
+				copy_count = 0;
+			}
+			if (literal_end > literal_start) {
+				Append(delta, LITERAL);
+				Append(delta, static_cast<uint64_t>(literal_end - literal_start));
+				delta.insert(delta.end(), target.begin() + literal_start, target.begin() + literal_end);
+			}
+			literal_start = literal_end;
+		};
+
+		// Only whole blocks of the base are matched. Blocks with the same weak checksum are chained, lowest block first
+		const uint32_t block_count = static_cast<uint32_t>(base.size() / DELTA_BLOCK_SIZE);
+		const uint8_t* base_bytes = reinterpret_cast<const uint8_t*>(base.data());
+		const uint8_t* target_bytes = reinterpret_cast<const uint8_t*>(target.data());
+		std::unordered_map<uint32_t, uint32_t> heads;
+		std::vector<uint32_t> next(block_count, NO_BLOCK);
+		heads.reserve(block_count);
+		for (uint32_t block = block_count; block-- > 0;) {
+			auto [iter, inserted] = heads.try_emplace(RollingChecksum(base_bytes + block * DELTA_BLOCK_SIZE).Get(), block);
+			if (!inserted) {
+				next[block] = iter->second;
+				iter->second = block;
+			}
+		}
+
+		size_t position = 0;
+		if (block_count > 0 && target.size() >= DELTA_BLOCK_SIZE) {
+			RollingChecksum checksum(target_bytes);
+			while (true) {
+				uint32_t found = NO_BLOCK;
+				auto iter = heads.find(checksum.Get());
+				if (iter != heads.end()) {
+					uint32_t candidates = 0;
+					for (uint32_t block = iter->second; block != NO_BLOCK && candidates < MAX_CANDIDATES; block = next[block], candidates++) {
+						if (std::memcmp(base_bytes + block * DELTA_BLOCK_SIZE, target_bytes + position, DELTA_BLOCK_SIZE) == 0) {
+							found = block;
+							break;
+						}
+					}
+				}
+
+				if (found != NO_BLOCK) {
+					// Runs of consecutive base blocks become a single copy
+					if (position > literal_start || copy_count == 0 || copy_first + copy_count != found)
+						flush(position);
+					if (copy_count == 0)
+						copy_first = found;
+					copy_count++;
+					position += DELTA_BLOCK_SIZE;
+					literal_start = position;
+					if (position + DELTA_BLOCK_SIZE > target.size())
+						break;
+					checksum = RollingChecksum(target_bytes + position);
+				}
+				else {
+					if (position + DELTA_BLOCK_SIZE >= target.size())
+						break;
+					checksum.Roll(target_bytes[position], target_bytes[position + DELTA_BLOCK_SIZE]);
+					position++;
+				}
+			}
+		}
+		flush(target.size());
+		return delta;
+	}
+
+	std::vector<char> AssetPatch::Patch(std::span<const char> base, std::span<const char> delta) {
+		ZoneScoped;
+		std::vector<char> result;
+		const char* current = delta.data();
+		const char* end = current + delta.size();
+		while (current < end) {
+			const DeltaCommand command = Read<DeltaCommand>(current, end);
+			if (command == LITERAL) {
+				const uint64_t size = Read<uint64_t>(current, end);
+				ENSURE(static_cast<uint64_t>(end - current) >= size, "Asset patch is corrupted");
+				result.insert(result.end(), current, current + size);
+				current += size;
+			}
+			else {
+				ENSURE(command == COPY_BLOCKS, "Asset patch is corrupted");
+				const uint64_t first = Read<uint32_t>(current, end);
+				const uint64_t count = Read<uint32_t>(current, end);
+				ENSURE((first + count) * DELTA_BLOCK_SIZE <= base.size(), "Asset patch is corrupted");
+				result.insert(result.end(), base.begin() + first * DELTA_BLOCK_SIZE, base.begin() + (first + count) * DELTA_BLOCK_SIZE);
+			}
+		}
+		return result;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "zore/io/asset_pack.hpp"
+
+namespace zore {
+
+	//========================================================================
+	//	Asset Patch
+	//========================================================================
+
+	// Records how to turn one saved asset pack into another. Assets whose contents are in the base pack are referenced rather
+	// than stored, and large assets that changed are stored as a binary diff against the base asset with the same key. Applying a
+	// patch streams the new pack to disk, and produces the same file the target pack was saved as
+	class AssetPatch {
+	public:
+		static constexpr uint32_t VERSION = 1;
+		// Changed assets at least this large are diffed against the base in blocks of DELTA_BLOCK_SIZE bytes, which are matched
+		// at any offset so that inserted and removed bytes do not break up the rest of the asset
+		static constexpr size_t DELTA_MIN_SIZE = 64 * 1024;
+		static constexpr size_t DELTA_BLOCK_SIZE = 4096;
+
+		struct Stats {
+			size_t unchanged_count;
+			size_t added_count;
+			size_t changed_count;
+			size_t removed_count;
+			uint64_t patch_size;
+		};
+
+	private:
+		struct Header {
+			char magic[4];
+			uint32_t version;
+			// Hash of the base pack's table of contents, which the patch can only be applied to
+			uint64_t base_hash;
+			uint32_t asset_count;
+			uint32_t removed_count;
+			uint32_t pack_flags;
+			uint32_t reserved;
+		};
+
+		// Copied assets are stored in the base pack, duplicates have the same contents as an earlier asset of the target pack, and
+		// added assets are stored in the patch as they are stored in the target pack
+		enum class Operation : uint8_t { COPY, DUPLICATE, ADD, DELTA };
+
+		// Follows the header for every asset of the target pack in order, followed by its key and payload. Removed keys come last,
+		// each as a 16 bit size followed by the key
+		struct Record {
+			uint64_t content_hash;
+			uint64_t payload_size;
+			uint16_t key_size;
+			Operation operation;
+			uint8_t flags;
+			uint32_t reserved;
+		};
+
+		enum DeltaCommand : uint8_t { LITERAL, COPY_BLOCKS };
+
+	public:
+		// Both packs have to be loaded from saved files, without any added files
+		static Stats Create(const AssetPack& base, const AssetPack& target, std::string_view filename);
+		// On Windows the output cannot be the file {base} was loaded from, since a mapped file cannot be replaced there
+		static void Apply(const AssetPack& base, std::string_view patch_filename, std::string_view filename, thread_pool* pool = nullptr);
+
+	private:
+		// The uncompressed contents of an entry, which only needs a copy if the entry is compressed
+		static std::span<const char> GetContents(const AssetPack& pack, const AssetPack::Entry& entry, std::vector<char>& storage);
+		static uint64_t HashContents(const AssetPack& pack);
+		// Compares two entries as stored, which is only meaningful for entries with the same flags
+		static bool SameData(const AssetPack& first, const AssetPack::Entry& first_entry, const AssetPack& second, const AssetPack::Entry& second_entry);
+		static std::vector<char> Diff(std::span<const char> base, std::span<const char> target);
+		static std::vector<char> Patch(std::span<const char> base, std::span<const char> delta);
+	};
+}
\ No newline at end of file
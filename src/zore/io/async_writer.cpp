@@ -0,0 +1,350 @@
+#include "zore/io/async_writer.hpp"
+#include "zore/debug/profiler.hpp"
+#include "zore/debug.hpp"
+#include "zore/platform.hpp"
+#include <filesystem>
+#include <algorithm>
+#include <cstdio>
+#include <cerrno>
+
+#if defined(PLATFORM_WINDOWS)
+#include <io.h>
+#elif defined(PLATFORM_LINUX)
+#include "zore/platform/linux/linux_io_ring.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace zore {
+
+	// A file takes at most a write and a sync, and each batch is waited on as a whole, so a linked pair is never split
+	// across two submissions
+	static constexpr uint32_t RING_ENTRIES = 256;
+	static constexpr size_t RING_BATCH = RING_ENTRIES / 2;
+	static constexpr uint64_t SYNC_TAG = 1ull << 32;
+	// The kernel caps a single write below 2GB, and anything left over is finished synchronously
+	static constexpr size_t MAX_RING_WRITE = 1u << 30;
+
+	// Moves a finished temporary file over the target, or removes it if anything failed
+	static bool Replace(const std::string& temporary, const std::string& filename, bool success) {
+		std::error_code error;
+		if (success) {
+			std::filesystem::rename(temporary, filename, error);
+			success = !error;
+		}
+		if (!success)
+			std::filesystem::remove(temporary, error);
+		return success;
+	}
+
+	// Flushes a file written earlier to disk. A file removed since has nothing left to flush
+	static bool SyncFile(const std::string& filename) {
+		std::FILE* file = std::fopen(filename.c_str(), "r+b");
+		if (!file)
+			return errno == ENOENT;
+		bool success = true;
+#if defined(PLATFORM_WINDOWS)
+		success = _commit(_fileno(file)) == 0;
+#elif defined(PLATFORM_LINUX)
+		success = fsync(fileno(file)) == 0;
+#endif
+		return std::fclose(file) == 0 && success;
+	}
+
+	// A rename only survives a crash once the directory holding it is synced. NTFS journals renames itself, so Windows has
+	// nothing to do
+	static bool SyncDirectory(const std::string& directory) {
+#if defined(PLATFORM_LINUX)
+		int handle = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (handle < 0)
+			return errno == ENOENT;
+		bool success = fsync(handle) == 0;
+		return close(handle) == 0 && success;
+#else
+		return true;
+#endif
+	}
+
+	//========================================================================
+	//	Async Writer
+	//========================================================================
+
+	AsyncWriter::AsyncWriter(Sync sync, Backend backend) :
+		m_sync(sync), m_backend(Backend::BLOCKING), m_queued_bytes(0), m_next_ticket(1), m_completed(0), m_running(true),
+		m_bytes_written(0), m_writes(0), m_failures(0), m_latency_count(0), m_total_latency(0.0), m_max_latency(0.f) {
+#if defined(PLATFORM_LINUX)
+		if (backend == Backend::IO_URING) {
+			auto ring = std::make_unique<IORing>();
+			if (ring->Init(RING_ENTRIES) && ring->Supports(IORING_OP_WRITE) && ring->Supports(IORING_OP_FSYNC)) {
+				m_ring = std::move(ring);
+				m_backend = Backend::IO_URING;
+			}
+			else {
+				Logger::Warn("io_uring is not supported by this kernel, falling back to blocking writes");
+			}
+		}
+#else
+		if (backend == Backend::IO_URING)
+			Logger::Warn("io_uring is only available on Linux, falling back to blocking writes");
+#endif
+		m_thread = std::thread(&AsyncWriter::Run, this);
+	}
+
+	AsyncWriter::~AsyncWriter() {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_running = false;
+		}
+		m_queue_condition.notify_one();
+		m_thread.join();
+	}
+
+	AsyncWriter::Ticket AsyncWriter::Write(const std::string& filename, std::string data) {
+		return Enqueue(Operation::WRITE, filename, std::move(data));
+	}
+
+	AsyncWriter::Ticket AsyncWriter::Append(const std::string& filename, std::string data) {
+		return Enqueue(Operation::APPEND, filename, std::move(data));
+	}
+
+	AsyncWriter::Ticket AsyncWriter::Barrier() {
+		return Enqueue(Operation::BARRIER, "", "");
+	}
+
+	void AsyncWriter::Wait(Ticket ticket) {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_complete_condition.wait(lock, [&]() { return IsComplete(ticket); });
+	}
+
+	void AsyncWriter::Flush() {
+		Ticket ticket;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			ticket = m_next_ticket - 1;
+		}
+		Wait(ticket);
+	}
+
+	AsyncWriter::Stats AsyncWriter::GetStats() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return {
+			static_cast<size_t>(m_next_ticket - 1 - m_completed.load(std::memory_order_relaxed)),
+			m_queued_bytes,
+			m_bytes_written,
+			m_writes,
+			m_failures,
+			m_latency_count ? static_cast<float>(m_total_latency / m_latency_count) : 0.f,
+			m_max_latency
+		};
+	}
+
+	AsyncWriter::Ticket AsyncWriter::Enqueue(Operation operation, const std::string& filename, std::string&& data) {
+		Ticket ticket;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_queued_bytes += data.size();
+			m_queue.push_back({ operation, filename, std::move(data), Time::CurrentTime() });
+			ticket = m_next_ticket++;
+		}
+		m_queue_condition.notify_one();
+		return ticket;
+	}
+
+	void AsyncWriter::Run() {
+		std::vector<Request> requests;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_queue_condition.wait(lock, [this]() { return !m_queue.empty() || !m_running; });
+				// The queue is drained before stopping, so nothing queued is lost
+				if (m_queue.empty())
+					return;
+				requests.swap(m_queue);
+			}
+			Process(requests);
+			requests.clear();
+		}
+	}
+
+	void AsyncWriter::Process(std::vector<Request>& requests) {
+		ZoneScoped;
+		// Requests are merged per file up to each barrier. A write replaces whatever was merged for its file before it
+		std::vector<Pending> pending;
+		size_t bytes = 0;
+		for (Request& request : requests) {
+			bytes += request.data.size();
+			if (request.operation == Operation::BARRIER) {
+				WriteAll(pending, true);
+				continue;
+			}
+			auto iter = std::find_if(pending.begin(), pending.end(), [&](const Pending& item) { return item.filename == request.filename; });
+			if (iter == pending.end()) {
+				pending.push_back({ std::move(request.filename), std::move(request.data), request.operation == Operation::WRITE });
+			}
+			else if (request.operation == Operation::WRITE) {
+				iter->data = std::move(request.data);
+				iter->truncate = true;
+			}
+			else {
+				iter->data += request.data;
+			}
+		}
+		WriteAll(pending, false);
+
+		TimePoint now = Time::CurrentTime();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			for (const Request& request : requests) {
+				float latency = Time::Duration(request.queued, now);
+				m_total_latency += latency;
+				m_max_latency = std::max(m_max_latency, latency);
+			}
+			m_latency_count += requests.size();
+			m_queued_bytes -= bytes;
+			m_completed.fetch_add(requests.size(), std::memory_order_release);
+		}
+		m_complete_condition.notify_all();
+	}
+
+	void AsyncWriter::WriteAll(std::vector<Pending>& pending, bool barrier) {
+		bool sync = m_sync == Sync::ALWAYS || (barrier && m_sync == Sync::BARRIER);
+		// Unsynced writes only copy into the page cache, which the ring does no faster, so it is kept for batches that wait on
+		// the disk and gain from having every sync in flight at once
+		if (m_backend == Backend::IO_URING && sync) {
+			for (size_t start = 0; start < pending.size(); start += RING_BATCH)
+				WriteBatch(pending.data() + start, std::min(RING_BATCH, pending.size() - start), sync);
+		}
+		else {
+			for (const Pending& item : pending)
+				Record(item, WriteFile(item, sync));
+		}
+
+		if (sync) {
+			// Files written unsynced by earlier batches are only made durable here, along with every rename since the last sync
+			for (const Pending& item : pending) {
+				m_unsynced_files.erase(item.filename);
+				if (item.truncate)
+					m_unsynced_directories.insert(std::filesystem::path(item.filename).parent_path().string());
+			}
+			uint64_t failures = 0;
+			for (const std::string& filename : m_unsynced_files)
+				failures += SyncFile(filename) ? 0 : 1;
+			for (const std::string& directory : m_unsynced_directories)
+				failures += SyncDirectory(directory) ? 0 : 1;
+			m_unsynced_files.clear();
+			m_unsynced_directories.clear();
+			if (failures > 0) {
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_failures += failures;
+			}
+		}
+		else if (m_sync == Sync::BARRIER) {
+			for (const Pending& item : pending) {
+				m_unsynced_files.insert(item.filename);
+				if (item.truncate)
+					m_unsynced_directories.insert(std::filesystem::path(item.filename).parent_path().string());
+			}
+		}
+		pending.clear();
+	}
+
+	bool AsyncWriter::WriteFile(const Pending& pending, bool sync) {
+		std::string target = pending.truncate ? pending.filename + ".tmp" : pending.filename;
+		std::FILE* file = std::fopen(target.c_str(), pending.truncate ? "wb" : "ab");
+		if (!file)
+			return false;
+		bool success = std::fwrite(pending.data.data(), 1, pending.data.size(), file) == pending.data.size() && std::fflush(file) == 0;
+		if (success && sync) {
+#if defined(PLATFORM_WINDOWS)
+			success = _commit(_fileno(file)) == 0;
+#elif defined(PLATFORM_LINUX)
+			success = fsync(fileno(file)) == 0;
+#endif
+		}
+		success = std::fclose(file) == 0 && success;
+		if (pending.truncate)
+			success = Replace(target, pending.filename, success);
+		return success;
+	}
+
+	void AsyncWriter::WriteBatch(const Pending* pending, size_t count, bool sync) {
+#if defined(PLATFORM_LINUX)
+		ZoneScoped;
+		// Files are opened here rather than through the ring, as the write would otherwise have to wait on the open for its handle
+		std::vector<int> handles(count, -1);
+		std::vector<int> written(count, -1);
+		std::vector<int> synced(count, 0);
+		uint32_t expected = 0;
+		for (size_t i = 0; i < count; i++) {
+			const Pending& item = pending[i];
+			std::string target = item.truncate ? item.filename + ".tmp" : item.filename;
+			handles[i] = open(target.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (item.truncate ? O_TRUNC : O_APPEND), 0644);
+			if (handles[i] < 0)
+				continue;
+			io_uring_sqe* sqe = m_ring->GetSubmission();
+			sqe->opcode = IORING_OP_WRITE;
+			sqe->fd = handles[i];
+			sqe->addr = reinterpret_cast<uint64_t>(item.data.data());
+			sqe->len = static_cast<uint32_t>(std::min(item.data.size(), MAX_RING_WRITE));
+			// Appends write at the file position, which the append flag keeps at the end
+			sqe->off = item.truncate ? 0 : ~0ull;
+			sqe->user_data = i;
+			expected++;
+			if (sync) {
+				// The sync only starts once the write has completed in full, and is cancelled otherwise
+				sqe->flags = IOSQE_IO_LINK;
+				sqe = m_ring->GetSubmission();
+				sqe->opcode = IORING_OP_FSYNC;
+				sqe->fd = handles[i];
+				sqe->user_data = SYNC_TAG | i;
+				expected++;
+			}
+		}
+
+		io_uring_cqe completions[RING_ENTRIES];
+		while (expected > 0) {
+			m_ring->Submit(1);
+			uint32_t reaped = m_ring->Reap(completions, expected);
+			for (uint32_t c = 0; c < reaped; c++) {
+				size_t i = static_cast<size_t>(completions[c].user_data & ~SYNC_TAG);
+				if (completions[c].user_data & SYNC_TAG)
+					synced[i] = completions[c].res;
+				else
+					written[i] = completions[c].res;
+			}
+			expected -= reaped;
+		}
+
+		for (size_t i = 0; i < count; i++) {
+			const Pending& item = pending[i];
+			bool success = handles[i] >= 0 && written[i] >= 0;
+			// Short writes are rare enough that the rest is written here rather than resubmitted
+			size_t offset = success ? static_cast<size_t>(written[i]) : 0;
+			while (success && offset < item.data.size()) {
+				const char* data = item.data.data() + offset;
+				ssize_t result = item.truncate ? pwrite(handles[i], data, item.data.size() - offset, offset) : write(handles[i], data, item.data.size() - offset);
+				if (result < 0 && errno == EINTR)
+					continue;
+				success = result > 0;
+				offset += success ? static_cast<size_t>(result) : 0;
+			}
+			if (success && sync)
+				success = synced[i] == 0 || (synced[i] == -ECANCELED && fsync(handles[i]) == 0);
+			if (handles[i] >= 0)
+				success = close(handles[i]) == 0 && success;
+			if (item.truncate)
+				success = Replace(item.filename + ".tmp", item.filename, success);
+			Record(item, success);
+		}
+#endif
+	}
+
+	void AsyncWriter::Record(const Pending& pending, bool success) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_writes++;
+		if (success)
+			m_bytes_written += pending.data.size();
+		else
+			m_failures++;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "zore/utils/time.hpp"
+#include "zore/platform.hpp"
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+
+namespace zore {
+
+	class IORing;
+
+	//========================================================================
+	//	Async Writer
+	//========================================================================
+
+	// Queues file writes to a background thread, so that saving never stalls the caller. Requests are written in the order they
+	// were queued. Requests that reach the thread together and target the same file are merged into a single write. With
+	// io_uring, files that have to be synced are written and synced through a single call, so that their syncs run concurrently
+	class AsyncWriter {
+	public:
+		using Ticket = uint64_t;
+
+		enum class Sync {
+			// Leaves flushing to the operating system
+			NONE,
+			// Files written before a barrier, and the directories of those it replaced, are synced to disk before the barrier
+			// completes and before anything after it is written
+			BARRIER,
+			// Every write is synced before it completes
+			ALWAYS
+		};
+
+		enum class Backend { BLOCKING, IO_URING };
+
+		struct Stats {
+			size_t queued_requests;
+			size_t queued_bytes;
+			uint64_t bytes_written;
+			// Number of writes issued after merging, and the number that failed
+			uint64_t writes;
+			uint64_t failures;
+			// Seconds from queueing a request until it was written
+			float average_latency;
+			float max_latency;
+		};
+
+	private:
+		enum class Operation { WRITE, APPEND, BARRIER };
+
+		struct Request {
+			Operation operation;
+			std::string filename;
+			std::string data;
+			TimePoint queued;
+		};
+
+		// The merged requests for one file between two barriers
+		struct Pending {
+			std::string filename;
+			std::string data;
+			bool truncate;
+		};
+
+	public:
+		// Falls back to blocking writes if io_uring is requested but not supported
+		AsyncWriter(Sync sync = Sync::BARRIER, Backend backend = Backend::BLOCKING);
+		AsyncWriter(const AsyncWriter&) = delete;
+		AsyncWriter& operator=(const AsyncWriter&) = delete;
+		// Writes everything still queued before returning
+		~AsyncWriter();
+
+		// Replaces the file, through a temporary file so that readers never see it half written
+		Ticket Write(const std::string& filename, std::string data);
+		Ticket Append(const std::string& filename, std::string data);
+		Ticket Barrier();
+
+		bool IsComplete(Ticket ticket) const { return m_completed.load(std::memory_order_acquire) >= ticket; }
+		void Wait(Ticket ticket);
+		// Waits for every request queued so far
+		void Flush();
+
+		Stats GetStats() const;
+		Backend GetBackend() const { return m_backend; }
+
+	private:
+		Ticket Enqueue(Operation operation, const std::string& filename, std::string&& data);
+		void Run();
+		void Process(std::vector<Request>& requests);
+		void WriteAll(std::vector<Pending>& pending, bool barrier);
+		bool WriteFile(const Pending& pending, bool sync);
+		void WriteBatch(const Pending* pending, size_t count, bool sync);
+		void Record(const Pending& pending, bool success);
+
+	private:
+		Sync m_sync;
+		Backend m_backend;
+#if defined(PLATFORM_LINUX)
+		// Only used by the writer thread
+		std::unique_ptr<IORing> m_ring;
+#endif
+		std::thread m_thread;
+		mutable std::mutex m_mutex;
+		std::condition_variable m_queue_condition;
+		std::condition_variable m_complete_condition;
+		std::vector<Request> m_queue;
+		size_t m_queued_bytes;
+		Ticket m_next_ticket;
+		std::atomic<Ticket> m_completed;
+		bool m_running;
+
+		// Only touched by the writer thread, and read under the mutex
+		uint64_t m_bytes_written;
+		uint64_t m_writes;
+		uint64_t m_failures;
+		uint64_t m_latency_count;
+		double m_total_latency;
+		float m_max_latency;
+		// Files written without a sync since the last barrier, and the directories renames were made in, which only the writer
+		// thread touches
+		std::unordered_set<std::string> m_unsynced_files;
+		std::unordered_set<std::string> m_unsynced_directories;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "zore/io/compression.hpp"
+#include "zore/debug/profiler.hpp"
+#include "zore/debug.hpp"
+#include <cstring>
+#include <vector>
+
+namespace zore {
+
+	// The last match has to start this far from the end of the input, and the last bytes are always literals
+	static constexpr size_t MATCH_FIND_LIMIT = 12;
+	static constexpr size_t LAST_LITERALS = 5;
+	static constexpr uint32_t HASH_BITS = 14;
+
+	static uint32_t Read32(const uint8_t* data) {
+		uint32_t value;
+		std::memcpy(&value, data, 4);
+		return value;
+	}
+
+	static uint32_t HashSequence(uint32_t sequence) {
+		return (sequence * 2654435761u) >> (32 - HASH_BITS);
+	}
+
+	static uint8_t* WriteLength(uint8_t* out, size_t length) {
+		for (; length >= 255; length -= 255)
+			*out++ = 255;
+		*out++ = static_cast<uint8_t>(length);
+		return out;
+	}
+
+	static uint8_t* WriteLiterals(uint8_t* out, const uint8_t* literals, size_t length, uint8_t*& token) {
+		token = out++;
+		*token = static_cast<uint8_t>(std::min<size_t>(length, 15) << 4);
+		if (length >= 15)
+			out = WriteLength(out, length - 15);
+		std::memcpy(out, literals, length);
+		return out + length;
+	}
+
+	static bool ReadLength(const uint8_t*& in, const uint8_t* end, size_t& length) {
+		uint8_t byte;
+		do {
+			if (in >= end)
+				return false;
+			byte = *in++;
+			length += byte;
+		} while (byte == 255);
+		return true;
+	}
+
+	//========================================================================
+	//	Compression
+	//========================================================================
+
+	size_t Compression::Compress(std::span<const char> src, std::span<char> dst) {
+		ZoneScoped;
+		DEBUG_ENSURE(dst.size() >= Bound(src.size()), "Compression output is smaller than the compression bound");
+		const uint8_t* begin = reinterpret_cast<const uint8_t*>(src.data());
+		const uint8_t* end = begin + src.size();
+		const uint8_t* anchor = begin;
+		uint8_t* out = reinterpret_cast<uint8_t*>(dst.data());
+		uint8_t* token = nullptr;
+
+		if (src.size() > MATCH_FIND_LIMIT) {
+			// Holds the last position each hashed 4 byte sequence was seen at
+			std::vector<uint32_t> table(size_t(1) << HASH_BITS, 0);
+			const uint8_t* search_end = end - MATCH_FIND_LIMIT;
+			const uint8_t* match_end = end - LAST_LITERALS;
+			const uint8_t* position = begin;
+			while (position < search_end) {
+				const uint32_t sequence = Read32(position);
+				uint32_t& slot = table[HashSequence(sequence)];
+				const uint8_t* match = begin + slot;
+				slot = static_cast<uint32_t>(position - begin);
+				if (match >= position || static_cast<size_t>(position - match) > MAX_OFFSET || Read32(match) != sequence) {
+					// Skip ahead faster the longer nothing has matched, since the data is probably incompressible
+					position += 1 + ((position - anchor) >> 6);
+					continue;
+				}
+
+				while (position > anchor && match > begin && position[-1] == match[-1]) {
+					position--;
+					match--;
+				}
+				size_t length = MIN_MATCH;
+				while (position + length < match_end && position[length] == match[length])
+					length++;
+
+				out = WriteLiterals(out, anchor, position - anchor, token);
+				const uint16_t offset = static_cast<uint16_t>(position - match);
+				*out++ = static_cast<uint8_t>(offset);
+				*out++ = static_cast<uint8_t>(offset >> 8);
+				*token |= static_cast<uint8_t>(std::min<size_t>(length - MIN_MATCH, 15));
+				if (length - MIN_MATCH >= 15)
+					out = WriteLength(out, length - MIN_MATCH - 15);
+
+				position += length;
+				anchor = position;
+				if (position < search_end)
+					table[HashSequence(Read32(position - 2))] = static_cast<uint32_t>(position - 2 - begin);
+			}
+		}
+
+		out = WriteLiterals(out, anchor, end - anchor, token);
+		return out - reinterpret_cast<uint8_t*>(dst.data());
+	}
+
+	bool Compression::Decompress(std::span<const char> src, std::span<char> dst) {
+		ZoneScoped;
+		const uint8_t* in = reinterpret_cast<const uint8_t*>(src.data());
+		const uint8_t* in_end = in + src.size();
+		uint8_t* begin = reinterpret_cast<uint8_t*>(dst.data());
+		uint8_t* out = begin;
+		uint8_t* out_end = begin + dst.size();
+
+		while (in < in_end) {
+			const uint8_t token = *in++;
+			size_t literals = token >> 4;
+			if (literals == 15 && !ReadLength(in, in_end, literals))
+				return false;
+			if (literals > static_cast<size_t>(in_end - in) || literals > static_cast<size_t>(out_end - out))
+				return false;
+			std::memcpy(out, in, literals);
+			in += literals;
+			out += literals;
+			// The last sequence is literals only
+			if (in == in_end)
+				break;
+
+			if (in_end - in < 2)
+				return false;
+			const size_t offset = in[0] | (in[1] << 8);
+			in += 2;
+			size_t length = token & 15;
+			if (length == 15 && !ReadLength(in, in_end, length))
+				return false;
+			length += MIN_MATCH;
+			if (offset == 0 || offset > static_cast<size_t>(out - begin) || length > static_cast<size_t>(out_end - out))
+				return false;
+
+			const uint8_t* match = out - offset;
+			if (offset >= length) {
+				std::memcpy(out, match, length);
+				out += length;
+			}
+			else {
+				// Overlapping matches repeat the last {offset} bytes, so they have to be copied forwards one byte at a time
+				for (size_t i = 0; i < length; i++)
+					*out++ = match[i];
+			}
+		}
+		return out == out_end;
+	}
+}
\ No newline at end of file
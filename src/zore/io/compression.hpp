@@ -0,0 +1,27 @@
+#pragma once
+
+#include <span>
+#include <cstdint>
+
+namespace zore {
+
+	//========================================================================
+	//	Compression
+	//========================================================================
+
+	// A fast byte oriented LZ77 codec, writing the LZ4 block format. Blocks carry no framing, so the caller has to store the
+	// compressed and decompressed sizes itself
+	class Compression {
+	public:
+		static constexpr size_t MIN_MATCH = 4;
+		static constexpr size_t MAX_OFFSET = 65535;
+
+		// The largest compressed size of {size} bytes, for input that does not compress at all
+		static constexpr size_t Bound(size_t size) { return size + size / 255 + 16; }
+
+		// Compresses src into dst, which must hold at least Bound(src.size()) bytes, and returns the compressed size
+		static size_t Compress(std::span<const char> src, std::span<char> dst);
+		// Decompresses src into dst, which must be exactly the decompressed size. Returns false if src is malformed
+		static bool Decompress(std::span<const char> src, std::span<char> dst);
+	};
+}
\ No newline at end of file
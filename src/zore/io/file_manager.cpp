@@ -1,4 +1,6 @@
 #include "zore/io/file_manager.hpp"
+#include "zore/io/file_watcher.hpp"
+#include "zore/io/async_writer.hpp"
 #include "zore/utils/string.hpp"
 #include "zore/debug.hpp"
 #include "path_config.h"
@@ -27,6 +29,28 @@ namespace zore {
 			std::filesystem::create_directories(path);
 	}
 
+	static FileWatcher& Watcher() {
+		static FileWatcher s_watcher;
+		return s_watcher;
+	}
+
+	bool File::Manager::Watch(const std::string& path, bool recursive) {
+		return Watcher().Watch(Path(path), recursive);
+	}
+
+	void File::Manager::Unwatch(const std::string& path) {
+		Watcher().Unwatch(Path(path));
+	}
+
+	bool File::Manager::PollChanges() {
+		return Watcher().Update();
+	}
+
+	AsyncWriter& File::Manager::Writer() {
+		static AsyncWriter s_writer;
+		return s_writer;
+	}
+
 	//========================================================================
 	//	File Class Utility
 	//========================================================================
@@ -8,6 +8,8 @@
 
 namespace zore {
 
+	class AsyncWriter;
+
 	//========================================================================
 	//	File Class
 	//========================================================================
@@ -27,6 +29,14 @@ namespace zore {
 			static std::string Path(const std::string& path);
 			static std::string Path(CommonPaths path);
 			static void EnsureDir(const std::string& path);
+
+			// Watched directories report changed files as a FilesChangedEvent, dispatched from PollChanges
+			static bool Watch(const std::string& path, bool recursive = true);
+			static void Unwatch(const std::string& path);
+			static bool PollChanges();
+
+			// Shared background writer for saves that should not stall the caller
+			static AsyncWriter& Writer();
 		};
 
 		//------------------------------------------------------------------------
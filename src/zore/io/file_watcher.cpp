@@ -0,0 +1,218 @@
+#include "zore/io/file_watcher.hpp"
+#include "zore/events/event_manager.hpp"
+#include "zore/platform.hpp"
+#include "zore/debug.hpp"
+#include <filesystem>
+#include <algorithm>
+
+#if defined(PLATFORM_LINUX)
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <climits>
+#endif
+
+namespace zore {
+
+	//========================================================================
+	//	File Watcher
+	//========================================================================
+
+#if defined(PLATFORM_LINUX)
+	// Saves finish with either a close after writing or a rename over the old file, so plain modifications are not watched
+	static constexpr uint32_t WATCH_MASK = IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_ONLYDIR;
+#endif
+
+	static std::string TrimSeparator(const std::string& directory) {
+		if (directory.size() > 1 && (directory.back() == '/' || directory.back() == '\\'))
+			return directory.substr(0, directory.size() - 1);
+		return directory;
+	}
+
+	static bool IsWithin(const std::string& path, const std::string& directory) {
+		return path.size() > directory.size() && path.compare(0, directory.size(), directory) == 0 && path[directory.size()] == '/';
+	}
+
+	FileWatcher::FileWatcher(float debounce) : m_handle(-1), m_debounce(debounce), m_sequence(0) {
+#if defined(PLATFORM_LINUX)
+		m_handle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		ENSURE(m_handle >= 0, "Failed to initialize inotify");
+#endif
+	}
+
+	FileWatcher::~FileWatcher() {
+#if defined(PLATFORM_LINUX)
+		// Closing the instance removes every watch with it
+		if (m_handle >= 0)
+			close(m_handle);
+#endif
+	}
+
+	bool FileWatcher::Watch(const std::string& directory, bool recursive) {
+		std::error_code error;
+		if (m_handle < 0 || !std::filesystem::is_directory(directory, error))
+			return false;
+		std::string path = TrimSeparator(directory);
+		if (!AddWatch(path, recursive))
+			return false;
+		if (recursive) {
+			auto options = std::filesystem::directory_options::skip_permission_denied;
+			for (auto iter = std::filesystem::recursive_directory_iterator(path, options, error); iter != std::filesystem::recursive_directory_iterator(); iter.increment(error)) {
+				if (error)
+					break;
+				if (iter->is_directory(error))
+					AddWatch(iter->path().generic_string(), true);
+			}
+		}
+		return true;
+	}
+
+	void FileWatcher::Unwatch(const std::string& directory) {
+		std::string path = TrimSeparator(directory);
+		for (auto iter = m_watches.begin(); iter != m_watches.end();) {
+			const std::string& watched = iter->second.first;
+			if (watched == path || IsWithin(watched, path)) {
+#if defined(PLATFORM_LINUX)
+				inotify_rm_watch(m_handle, iter->first);
+#endif
+				iter = m_watches.erase(iter);
+			}
+			else {
+				iter++;
+			}
+		}
+		Forget(path);
+	}
+
+	bool FileWatcher::IsWatching(const std::string& directory) const {
+		std::string path = TrimSeparator(directory);
+		for (const auto& [descriptor, watch] : m_watches)
+			if (watch.first == path)
+				return true;
+		return false;
+	}
+
+	bool FileWatcher::AddWatch(const std::string& directory, bool recursive) {
+#if defined(PLATFORM_LINUX)
+		int descriptor = inotify_add_watch(m_handle, directory.c_str(), WATCH_MASK);
+		if (descriptor < 0)
+			return false;
+		// Watching the same directory twice returns the same descriptor, so the newest options win
+		m_watches[descriptor] = { directory, recursive };
+		std::error_code error;
+		for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+			if (entry.is_regular_file(error))
+				m_files.insert(entry.path().generic_string());
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void FileWatcher::Record(const std::string& path, FileChange::Action action) {
+		TimePoint now = Time::CurrentTime();
+		if (m_pending.empty())
+			m_first_change = now;
+		m_last_change = now;
+
+		auto iter = m_pending.find(path);
+		if (iter == m_pending.end()) {
+			m_pending[path] = { action, m_sequence++ };
+			return;
+		}
+		FileChange::Action previous = iter->second.action;
+		if (previous == FileChange::Action::CREATED && action == FileChange::Action::DELETED)
+			m_pending.erase(iter);
+		else if (previous == FileChange::Action::CREATED && action == FileChange::Action::MODIFIED)
+			return;
+		else if (previous == FileChange::Action::DELETED && action == FileChange::Action::CREATED)
+			iter->second.action = FileChange::Action::MODIFIED;
+		else
+			iter->second.action = action;
+	}
+
+	void FileWatcher::Forget(const std::string& directory) {
+		std::erase_if(m_files, [&](const std::string& path) { return IsWithin(path, directory); });
+	}
+
+	bool FileWatcher::Poll(std::vector<FileChange>& changes) {
+#if defined(PLATFORM_LINUX)
+		alignas(inotify_event) char buffer[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+		while (true) {
+			ssize_t length = read(m_handle, buffer, sizeof(buffer));
+			if (length <= 0)
+				break;
+			for (ssize_t offset = 0; offset < length;) {
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				offset += sizeof(inotify_event) + event->len;
+
+				if (event->mask & IN_Q_OVERFLOW) {
+					Logger::Warn("File watcher queue overflowed, some changes were lost");
+					continue;
+				}
+				auto iter = m_watches.find(event->wd);
+				if (iter == m_watches.end())
+					continue;
+				if (event->mask & IN_IGNORED) {
+					m_watches.erase(iter);
+					continue;
+				}
+				if (event->len == 0)
+					continue;
+
+				const auto [directory, recursive] = iter->second;
+				std::string path = directory + "/" + event->name;
+				if (event->mask & IN_ISDIR) {
+					if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+						Forget(path);
+					// Files can land in a new directory before its watch exists, so they are reported as created
+					if (recursive && (event->mask & (IN_CREATE | IN_MOVED_TO)) && Watch(path, true)) {
+						std::error_code error;
+						for (const auto& entry : std::filesystem::recursive_directory_iterator(path, error))
+							if (entry.is_regular_file(error))
+								Record(entry.path().generic_string(), FileChange::Action::CREATED);
+					}
+					continue;
+				}
+				if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+					// A rename over an existing file raises no delete for it, so it is known to have been replaced
+					bool existed = (event->mask & IN_MOVED_TO) && m_files.count(path) > 0;
+					m_files.insert(path);
+					Record(path, existed ? FileChange::Action::MODIFIED : FileChange::Action::CREATED);
+				}
+				else if (event->mask & IN_CLOSE_WRITE) {
+					m_files.insert(path);
+					Record(path, FileChange::Action::MODIFIED);
+				}
+				else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+					m_files.erase(path);
+					Record(path, FileChange::Action::DELETED);
+				}
+			}
+		}
+#endif
+		if (m_pending.empty())
+			return false;
+		if (Time::Elapsed(m_last_change) < m_debounce && Time::Elapsed(m_first_change) < MAX_LATENCY)
+			return false;
+
+		std::vector<std::pair<size_t, FileChange>> ordered;
+		ordered.reserve(m_pending.size());
+		for (auto& [path, pending] : m_pending)
+			ordered.push_back({ pending.order, { path, pending.action } });
+		std::sort(ordered.begin(), ordered.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		changes.clear();
+		changes.reserve(ordered.size());
+		for (auto& [order, change] : ordered)
+			changes.push_back(std::move(change));
+		m_pending.clear();
+		return true;
+	}
+
+	bool FileWatcher::Update() {
+		std::vector<FileChange> changes;
+		if (!Poll(changes))
+			return false;
+		event::Manager::Dispatch(FilesChangedEvent(changes));
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "zore/events/file_events.hpp"
+#include "zore/utils/time.hpp"
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include <vector>
+
+namespace zore {
+
+	//========================================================================
+	//	File Watcher
+	//========================================================================
+
+	// Watches directories for changed files using inotify. Editors tend to save in bursts of writes, renames and attribute
+	// changes, so changes are coalesced per path and only released as one batch once no change has been seen for the debounce
+	// window. Nothing is watched on platforms without a backend
+	class FileWatcher {
+	public:
+		static constexpr float DEFAULT_DEBOUNCE = 0.1f;
+		// A batch is released after this long even if changes keep arriving
+		static constexpr float MAX_LATENCY = 1.f;
+
+	private:
+		struct Pending {
+			FileChange::Action action;
+			size_t order;
+		};
+
+	public:
+		FileWatcher(float debounce = DEFAULT_DEBOUNCE);
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+		~FileWatcher();
+
+		// Returns false if the directory could not be watched. Recursive watches pick up directories created later on
+		bool Watch(const std::string& directory, bool recursive = true);
+		void Unwatch(const std::string& directory);
+		bool IsWatching(const std::string& directory) const;
+
+		// Reads pending changes without blocking, and fills {changes} once a batch is ready
+		bool Poll(std::vector<FileChange>& changes);
+		// Polls, and dispatches a FilesChangedEvent if a batch is ready
+		bool Update();
+
+	private:
+		bool AddWatch(const std::string& directory, bool recursive);
+		void Record(const std::string& path, FileChange::Action action);
+		void Forget(const std::string& directory);
+
+	private:
+		int m_handle;
+		float m_debounce;
+		// Watch descriptors mapped to the directory they watch, and whether subdirectories are watched too
+		std::unordered_map<int, std::pair<std::string, bool>> m_watches;
+		std::unordered_map<std::string, Pending> m_pending;
+		// Files in watched directories, so that a file renamed over one of them reports it as modified rather than created
+		std::unordered_set<std::string> m_files;
+		size_t m_sequence;
+		TimePoint m_first_change;
+		TimePoint m_last_change;
+	};
+}
\ No newline at end of file
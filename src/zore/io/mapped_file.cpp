@@ -0,0 +1,148 @@
+#include "zore/io/mapped_file.hpp"
+#include "zore/math/simd/simd_core.hpp"
+#include "zore/platform.hpp"
+#include "zore/debug.hpp"
+#include <utility>
+#include <cstring>
+#include <bit>
+
+#if defined(PLATFORM_WINDOWS)
+#include "zore/platform/win32/win32_core.hpp"
+#elif defined(PLATFORM_LINUX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+#include <immintrin.h>
+#endif
+
+namespace zore {
+
+	//========================================================================
+	//	Mapped File
+	//========================================================================
+
+	MappedFile MappedFile::Open(const std::string& filename) {
+		MappedFile file;
+#if defined(PLATFORM_WINDOWS)
+		HANDLE handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		ENSURE(handle != INVALID_HANDLE_VALUE, "Failed to open file for mapping: " + filename);
+		LARGE_INTEGER size;
+		ENSURE(GetFileSizeEx(handle, &size), "Failed to get size of file: " + filename);
+		file.m_size = static_cast<size_t>(size.QuadPart);
+		// Empty files cannot be mapped, but are still valid files
+		if (file.m_size > 0) {
+			HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			ENSURE(mapping, "Failed to map file: " + filename);
+			file.m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			// The view keeps the mapping alive, so neither handle is needed once it exists
+			CloseHandle(mapping);
+			ENSURE(file.m_data, "Failed to map file: " + filename);
+		}
+		CloseHandle(handle);
+#elif defined(PLATFORM_LINUX)
+		int descriptor = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+		ENSURE(descriptor >= 0, "Failed to open file for mapping: " + filename);
+		struct stat status;
+		ENSURE(fstat(descriptor, &status) == 0, "Failed to get size of file: " + filename);
+		file.m_size = static_cast<size_t>(status.st_size);
+		// Empty files cannot be mapped, but are still valid files
+		if (file.m_size > 0) {
+			void* data = mmap(nullptr, file.m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			ENSURE(data != MAP_FAILED, "Failed to map file: " + filename);
+			file.m_data = static_cast<const char*>(data);
+		}
+		// The mapping keeps its own reference to the file
+		close(descriptor);
+#endif
+		file.m_open = true;
+		return file;
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept :
+		m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)), m_open(std::exchange(other.m_open, false)) {
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			Close();
+			m_data = std::exchange(other.m_data, nullptr);
+			m_size = std::exchange(other.m_size, 0);
+			m_open = std::exchange(other.m_open, false);
+		}
+		return *this;
+	}
+
+	MappedFile::~MappedFile() {
+		Close();
+	}
+
+	void MappedFile::Close() {
+		if (m_data) {
+#if defined(PLATFORM_WINDOWS)
+			UnmapViewOfFile(m_data);
+#elif defined(PLATFORM_LINUX)
+			munmap(const_cast<char*>(m_data), m_size);
+#endif
+		}
+		m_data = nullptr;
+		m_size = 0;
+		m_open = false;
+	}
+
+	//------------------------------------------------------------------------
+	//	Mapped File Line Iterator
+	//------------------------------------------------------------------------
+
+	// Returns the first \n in [begin, end), or end if there is none
+	static const char* FindNewline(const char* begin, const char* end) {
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		const __m128i newline = _mm_set1_epi8('\n');
+		// Long lines are scanned 64 bytes at a time, with the four compares merged into a single test
+		while (end - begin >= 64) {
+			const __m128i* block = reinterpret_cast<const __m128i*>(begin);
+			__m128i a = _mm_cmpeq_epi8(_mm_loadu_si128(block), newline);
+			__m128i b = _mm_cmpeq_epi8(_mm_loadu_si128(block + 1), newline);
+			__m128i c = _mm_cmpeq_epi8(_mm_loadu_si128(block + 2), newline);
+			__m128i d = _mm_cmpeq_epi8(_mm_loadu_si128(block + 3), newline);
+			if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)))) {
+				uint64_t mask = static_cast<uint64_t>(_mm_movemask_epi8(a)) | (static_cast<uint64_t>(_mm_movemask_epi8(b)) << 16) |
+					(static_cast<uint64_t>(_mm_movemask_epi8(c)) << 32) | (static_cast<uint64_t>(_mm_movemask_epi8(d)) << 48);
+				return begin + std::countr_zero(mask);
+			}
+			begin += 64;
+		}
+		while (end - begin >= 16) {
+			int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin)), newline));
+			if (mask)
+				return begin + std::countr_zero(static_cast<uint32_t>(mask));
+			begin += 16;
+		}
+#endif
+		const void* found = std::memchr(begin, '\n', end - begin);
+		return found ? static_cast<const char*>(found) : end;
+	}
+
+	MappedFile::LineIterator::LineIterator(const char* begin, const char* end) : m_position(begin), m_end(end) {
+		if (m_position)
+			++(*this);
+	}
+
+	MappedFile::LineIterator& MappedFile::LineIterator::operator++() {
+		// Like std::getline, a trailing line break does not start another line
+		if (m_position == m_end) {
+			m_position = nullptr;
+			return *this;
+		}
+		const char* newline = FindNewline(m_position, m_end);
+		size_t length = newline - m_position;
+		if (length > 0 && m_position[length - 1] == '\r')
+			length--;
+		m_line = std::string_view(m_position, length);
+		m_position = newline == m_end ? m_end : newline + 1;
+		return *this;
+	}
+}
\ No newline at end of file
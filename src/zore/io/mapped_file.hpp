@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <span>
+
+namespace zore {
+
+	//========================================================================
+	//	Mapped File
+	//========================================================================
+
+	// Maps a whole file read only into memory, so that pages are only read from disk once they are touched
+	class MappedFile {
+	public:
+
+		//------------------------------------------------------------------------
+		//	Mapped File Line Iterator
+		//------------------------------------------------------------------------
+
+		// Yields each line as a view into the mapping, without its \n or \r\n line break
+		class LineIterator {
+		public:
+			LineIterator(const char* begin, const char* end);
+
+			std::string_view operator*() const { return m_line; }
+			LineIterator& operator++();
+			bool operator!=(const LineIterator& other) const { return m_position != other.m_position; }
+
+		private:
+			const char* m_position;
+			const char* m_end;
+			std::string_view m_line;
+		};
+
+	public:
+		MappedFile() = default;
+		static MappedFile Open(const std::string& filename);
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		~MappedFile();
+
+		bool IsOpen() const { return m_open; }
+		void Close();
+		const char* Data() const { return m_data; }
+		size_t Size() const { return m_size; }
+		std::span<const char> Span() const { return { m_data, m_size }; }
+		std::string_view View() const { return { m_data, m_size }; }
+
+		LineIterator begin() const { return LineIterator(m_data, m_data + m_size); }
+		LineIterator end() const { return LineIterator(nullptr, nullptr); }
+
+	private:
+		const char* m_data = nullptr;
+		size_t m_size = 0;
+		bool m_open = false;
+	};
+}
\ No newline at end of file
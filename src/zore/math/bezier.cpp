@@ -1,52 +1,196 @@
-#include "zore/math/Bezier.hpp"
-#include "zore/Debug.hpp"
+#include "zore/math/bezier.hpp"
+#include "zore/math/simd.hpp"
+#include "zore/debug.hpp"
 
 namespace zm {
 
-	void Bezier::Quadratic(const zm::vec2& a, const zm::vec2& b, const zm::vec2& c, int count, zm::vec2* out, bool includeEndPoints) {
+	//========================================================================
+	//	Bezier Curve Utilities
+	//========================================================================
+
+	static constexpr int MAX_SUBDIVISION_DEPTH = 16;
+	// Uniform flattening is capped at the finest subdivision the adaptive path reaches
+	static constexpr int MAX_SEGMENTS = 1 << MAX_SUBDIVISION_DEPTH;
+
+	// Power basis form of a curve: p3*t^3 + p2*t^2 + p1*t + p0
+	struct Polynomial {
+		vec2 p3, p2, p1, p0;
+		vec2 end;
+	};
+
+	static inline Polynomial ToPolynomial(const vec2& a, const vec2& b, const vec2& c) {
+		return { vec2(0.f), a - (c * 2.f) + b, (c - a) * 2.f, a, b };
+	}
+
+	static inline Polynomial ToPolynomial(const vec2& a, const vec2& b, const vec2& c, const vec2& d) {
+		return { b - a + ((c - d) * 3.f), (a - (c * 2.f) + d) * 3.f, (c - a) * 3.f, a, b };
+	}
+
+	static inline vec2 Evaluate(const Polynomial& p, float t) {
+		return ((p.p3 * t + p.p2) * t + p.p1) * t + p.p0;
+	}
+
+	// Evaluates the curve at segments + 1 uniformly spaced parameters. May write up to 3 points past the end of out
+	static void EvaluateUniform(const Polynomial& p, int segments, vec2* out) {
+		const float h = 1.f / static_cast<float>(segments);
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		// Each lane runs its own forward difference with a step of 4h, so every iteration emits 4 consecutive points
+		simd<float, 4> x[4], y[4];
+		simd<float, 4> t(0.f, h, 2.f * h, 3.f * h);
+		for (int k = 0; k < 4; k++, t += 4.f * h) {
+			x[k] = ((simd<float, 4>(p.p3.x) * t + p.p2.x) * t + p.p1.x) * t + p.p0.x;
+			y[k] = ((simd<float, 4>(p.p3.y) * t + p.p2.y) * t + p.p1.y) * t + p.p0.y;
+		}
+
+		simd<float, 4> fx = x[0], dx1 = x[1] - x[0], dx2 = x[2] - (x[1] * 2.f) + x[0], dx3 = x[3] - ((x[2] - x[1]) * 3.f) - x[0];
+		simd<float, 4> fy = y[0], dy1 = y[1] - y[0], dy2 = y[2] - (y[1] * 2.f) + y[0], dy3 = y[3] - ((y[2] - y[1]) * 3.f) - y[0];
+		float* dst = reinterpret_cast<float*>(out);
+		for (int i = 0; i <= segments; i += 4, dst += 8) {
+			simd<float, 4> lo = shuffle<0, 1, 0, 1>(fx, fy);
+			simd<float, 4> hi = shuffle<2, 3, 2, 3>(fx, fy);
+			shuffle<0, 2, 1, 3>(lo, lo).unload(dst);
+			shuffle<0, 2, 1, 3>(hi, hi).unload(dst + 4);
+			fx += dx1; dx1 += dx2; dx2 += dx3;
+			fy += dy1; dy1 += dy2; dy2 += dy3;
+		}
+#else
+		vec2 f = p.p0;
+		vec2 d1 = ((p.p3 * h + p.p2) * h + p.p1) * h;
+		vec2 d3 = p.p3 * (6.f * h * h * h);
+		vec2 d2 = (p.p2 * (2.f * h * h)) + d3;
+		for (int i = 0; i <= segments; i++) {
+			out[i] = f;
+			f += d1; d1 += d2; d2 += d3;
+		}
+#endif
+		// Pin the end points, so that accumulated error never opens gaps between joined curves
+		out[0] = p.p0;
+		out[segments] = p.end;
+	}
+
+	static void FillUniform(const Polynomial& p, int count, vec2* out, bool includeEndPoints) {
+		DEBUG_ENSURE(count >= 2 || !includeEndPoints, "Point count on bezier curve must be atleast 2");
+		if (includeEndPoints) {
+			float s = 1.f / static_cast<float>(count - 1);
+			for (int i = 0; i < count; i++)
+				out[i] = Evaluate(p, static_cast<float>(i) * s);
+			out[count - 1] = p.end;
+		}
+		else {
+			float s = 1.f / static_cast<float>(count + 1);
+			for (int i = 0; i < count; i++)
+				out[i] = Evaluate(p, static_cast<float>(i + 1) * s);
+		}
+	}
+
+	static void SubdivideQuadratic(const vec2& p0, const vec2& p1, const vec2& p2, float tolerance_sq, int depth, std::vector<vec2>& out) {
+		// The furthest a quadratic strays from its chord is a quarter of its second difference
+		vec2 dd = p0 - (p1 * 2.f) + p2;
+		if (depth >= MAX_SUBDIVISION_DEPTH || dd.Dot(dd) <= 16.f * tolerance_sq) {
+			out.push_back(p2);
+			return;
+		}
+		vec2 p01 = (p0 + p1) * 0.5f;
+		vec2 p12 = (p1 + p2) * 0.5f;
+		vec2 mid = (p01 + p12) * 0.5f;
+		SubdivideQuadratic(p0, p01, mid, tolerance_sq, depth + 1, out);
+		SubdivideQuadratic(mid, p12, p2, tolerance_sq, depth + 1, out);
+	}
+
+	static void SubdivideCubic(const vec2& p0, const vec2& p1, const vec2& p2, const vec2& p3, float tolerance_sq, int depth, std::vector<vec2>& out) {
+		// Bounds the distance between the curve and its chord (Roger Willcocks' flatness test)
+		vec2 u = (p1 * 3.f) - (p0 * 2.f) - p3;
+		vec2 v = (p2 * 3.f) - p0 - (p3 * 2.f);
+		u *= u;
+		v *= v;
+		if (depth >= MAX_SUBDIVISION_DEPTH || zm::Max(u.x, v.x) + zm::Max(u.y, v.y) <= 16.f * tolerance_sq) {
+			out.push_back(p3);
+			return;
+		}
+		vec2 p01 = (p0 + p1) * 0.5f;
+		vec2 p12 = (p1 + p2) * 0.5f;
+		vec2 p23 = (p2 + p3) * 0.5f;
+		vec2 p012 = (p01 + p12) * 0.5f;
+		vec2 p123 = (p12 + p23) * 0.5f;
+		vec2 mid = (p012 + p123) * 0.5f;
+		SubdivideCubic(p0, p01, p012, mid, tolerance_sq, depth + 1, out);
+		SubdivideCubic(mid, p123, p23, p3, tolerance_sq, depth + 1, out);
+	}
 
+	// Clamps before the cast, since a tiny tolerance or a degenerate curve can give an estimate no int holds
+	static inline int ClampSegments(float segments) {
+		if (!(segments >= 1.f))
+			return 1;
+		if (segments >= static_cast<float>(MAX_SEGMENTS))
+			return MAX_SEGMENTS;
+		return static_cast<int>(std::ceil(segments));
+	}
+
+	template <typename C>
+	static void FlattenBatchImpl(const C* curves, size_t count, float tolerance, std::vector<vec2>& out, std::vector<uint32_t>& offsets) {
+		offsets.resize(count + 1);
+		offsets[0] = static_cast<uint32_t>(out.size());
+		for (size_t i = 0; i < count; i++)
+			offsets[i + 1] = offsets[i] + Bezier::Segments(curves[i], tolerance) + 1;
+
+		out.resize(offsets[count] + 3);
+		for (size_t i = 0; i < count; i++) {
+			const C& c = curves[i];
+			Polynomial p;
+			if constexpr (std::is_same_v<C, Bezier::CubicCurve>)
+				p = ToPolynomial(c.a, c.b, c.c, c.d);
+			else
+				p = ToPolynomial(c.a, c.b, c.c);
+			EvaluateUniform(p, offsets[i + 1] - offsets[i] - 1, out.data() + offsets[i]);
+		}
+		out.resize(offsets[count]);
+	}
+
+	//========================================================================
+	//	Bezier Curves
+	//========================================================================
+
+	void Bezier::Quadratic(const zm::vec2& a, const zm::vec2& b, const zm::vec2& c, int count, zm::vec2* out, bool includeEndPoints) {
+		FillUniform(ToPolynomial(a, b, c), count, out, includeEndPoints);
 	}
 
 	void Bezier::Cubic(const zm::vec2& a, const zm::vec2& b, const zm::vec2& c, const zm::vec2& d, int count, zm::vec2* out, bool includeEndPoints) {
+		FillUniform(ToPolynomial(a, b, c, d), count, out, includeEndPoints);
+	}
 
+	int Bezier::Segments(const QuadraticCurve& curve, float tolerance) {
+		DEBUG_ENSURE(tolerance > 0.f, "Bezier tolerance must be positive");
+		// Wang's formula, for degree 2
+		vec2 dd = curve.a - (curve.c * 2.f) + curve.b;
+		return ClampSegments(std::sqrt(dd.Length() / (4.f * tolerance)));
 	}
 
-	//void Bezier::Quadratic(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, int count, glm::vec2* out, bool includeEndPoints) {
-	//	DEBUG_ENSURE(count >= 2, "Point count on bezier curve must be atleast 2");
-	//	int steps = count - 1;
-	//	float t = 0.f;
-	//	float s = 1.f / steps;
-	//	int offset = 0;
-
-	//	if (includeEndPoints) {
-	//		out[0] = a;
-	//		out[steps] = c;
-	//		offset = 1;
-	//	}
-
-	//	for (int i = 0; i < steps - 1; i++) {
-	//		out[i + offset] = a + (2.f * t * (b - a)) + (t * t * (c - (2.f * b) + a));
-	//		t += s;
-	//	}
-	//}
-
-	//void Bezier::Cubic(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, const glm::vec2& d, int count, glm::vec2* out, bool includeEndPoints) {
-	//	DEBUG_ENSURE(count >= 2, "Point count on bezier curve must be atleast 2");
-	//	int steps = count - 1;
-	//	float t = 0.f;
-	//	float s = 1.f / steps;
-	//	int offset = 0;
-
-	//	if (includeEndPoints) {
-	//		out[0] = a;
-	//		out[steps] = c;
-	//		offset = 1;
-	//	}
-
-	//	for (int i = 0; i < steps - 1; i++) {
-	//		float ts = t * t;
-	//		out[i + offset] = a + (3.f * t * (b - a)) + (3.f * ts * (c - (2.f * b) + a)) + (ts * t * (d - (3.f * c) + (3.f * b) - a));
-	//		t += s;
-	//	}
-	//}
+	int Bezier::Segments(const CubicCurve& curve, float tolerance) {
+		DEBUG_ENSURE(tolerance > 0.f, "Bezier tolerance must be positive");
+		// Wang's formula, for degree 3
+		vec2 dd0 = curve.a - (curve.c * 2.f) + curve.d;
+		vec2 dd1 = curve.c - (curve.d * 2.f) + curve.b;
+		float m = zm::Max(dd0.Length(), dd1.Length());
+		return ClampSegments(std::sqrt(0.75f * m / tolerance));
+	}
+
+	void Bezier::Flatten(const QuadraticCurve& curve, float tolerance, std::vector<zm::vec2>& out, bool includeStartPoint) {
+		if (includeStartPoint)
+			out.push_back(curve.a);
+		SubdivideQuadratic(curve.a, curve.c, curve.b, tolerance * tolerance, 0, out);
+	}
+
+	void Bezier::Flatten(const CubicCurve& curve, float tolerance, std::vector<zm::vec2>& out, bool includeStartPoint) {
+		if (includeStartPoint)
+			out.push_back(curve.a);
+		SubdivideCubic(curve.a, curve.c, curve.d, curve.b, tolerance * tolerance, 0, out);
+	}
+
+	void Bezier::FlattenBatch(const QuadraticCurve* curves, size_t count, float tolerance, std::vector<zm::vec2>& out, std::vector<uint32_t>& offsets) {
+		FlattenBatchImpl(curves, count, tolerance, out, offsets);
+	}
+
+	void Bezier::FlattenBatch(const CubicCurve* curves, size_t count, float tolerance, std::vector<zm::vec2>& out, std::vector<uint32_t>& offsets) {
+		FlattenBatchImpl(curves, count, tolerance, out, offsets);
+	}
 }
\ No newline at end of file
@@ -1,14 +1,38 @@
 #pragma once
 #include "zore/math/vector/vec2.hpp"
+#include <vector>
 
 namespace zm {
 
 	class Bezier {
+	public:
+		struct QuadraticCurve {
+			zm::vec2 a, b, c;
+		};
+
+		struct CubicCurve {
+			zm::vec2 a, b, c, d;
+		};
+
 	public:
 		// Returns a set of {count} points that pass through end points a and b, augmented by control point c
 		static void Quadratic(const zm::vec2& a, const zm::vec2& b, const zm::vec2& c, int count, zm::vec2* out, bool includeEndPoints = true);
 
 		// Returns a set of {count} points that pass through end points a and b, augmented by control points c and d
 		static void Cubic(const zm::vec2& a, const zm::vec2& b, const zm::vec2& c, const zm::vec2& d, int count, zm::vec2* out, bool includeEndPoints = true);
+
+		// Returns the number of uniform segments needed for the flattened curve to stay within {tolerance} of the true curve, up
+		// to 65536. {tolerance} must be positive
+		static int Segments(const QuadraticCurve& curve, float tolerance);
+		static int Segments(const CubicCurve& curve, float tolerance);
+
+		// Appends a polyline within {tolerance} of the curve to out, subdividing only where the curve bends
+		static void Flatten(const QuadraticCurve& curve, float tolerance, std::vector<zm::vec2>& out, bool includeStartPoint = true);
+		static void Flatten(const CubicCurve& curve, float tolerance, std::vector<zm::vec2>& out, bool includeStartPoint = true);
+
+		// Flattens {count} curves into out by forward differencing, with the segment count of each curve chosen from {tolerance}.
+		// offsets receives count + 1 entries, such that curve i occupies out[offsets[i], offsets[i + 1])
+		static void FlattenBatch(const QuadraticCurve* curves, size_t count, float tolerance, std::vector<zm::vec2>& out, std::vector<uint32_t>& offsets);
+		static void FlattenBatch(const CubicCurve* curves, size_t count, float tolerance, std::vector<zm::vec2>& out, std::vector<uint32_t>& offsets);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,426 @@
+#include "zore/math/space_curve.hpp"
+#include "zore/math/simd.hpp"
+#include "zore/platform/processor.hpp"
+#include "zore/platform.hpp"
+#include "zore/debug.hpp"
+
+#if defined(ARCHITECTURE_x86_64)
+#include <immintrin.h>
+#define SPACE_CURVE_PDEP
+#if defined(COMPILER_GCC)
+#define TARGET_BMI2 __attribute__((target("bmi2")))
+#else
+#define TARGET_BMI2
+#endif
+#endif
+
+namespace zm {
+
+	//========================================================================
+	//	Bit Interleaving
+	//========================================================================
+
+	// The 32 bit helpers are shared between the scalar and SIMD paths
+
+	template <typename T>
+	static inline T Part1By1(T x) {
+		x &= 0x0000FFFFu;
+		x = (x | (x << 8)) & 0x00FF00FFu;
+		x = (x | (x << 4)) & 0x0F0F0F0Fu;
+		x = (x | (x << 2)) & 0x33333333u;
+		x = (x | (x << 1)) & 0x55555555u;
+		return x;
+	}
+
+	template <typename T>
+	static inline T Compact1By1(T x) {
+		x &= 0x55555555u;
+		x = (x | (x >> 1)) & 0x33333333u;
+		x = (x | (x >> 2)) & 0x0F0F0F0Fu;
+		x = (x | (x >> 4)) & 0x00FF00FFu;
+		x = (x | (x >> 8)) & 0x0000FFFFu;
+		return x;
+	}
+
+	template <typename T>
+	static inline T Part1By2(T x) {
+		x &= 0x000003FFu;
+		x = (x | (x << 16)) & 0x030000FFu;
+		x = (x | (x << 8)) & 0x0300F00Fu;
+		x = (x | (x << 4)) & 0x030C30C3u;
+		x = (x | (x << 2)) & 0x09249249u;
+		return x;
+	}
+
+	template <typename T>
+	static inline T Compact1By2(T x) {
+		x &= 0x09249249u;
+		x = (x | (x >> 2)) & 0x030C30C3u;
+		x = (x | (x >> 4)) & 0x0300F00Fu;
+		x = (x | (x >> 8)) & 0x030000FFu;
+		x = (x | (x >> 16)) & 0x000003FFu;
+		return x;
+	}
+
+	static inline uint64_t Part1By1(uint64_t x) {
+		x &= 0x00000000FFFFFFFFull;
+		x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+		x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+		x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+		x = (x | (x << 2)) & 0x3333333333333333ull;
+		x = (x | (x << 1)) & 0x5555555555555555ull;
+		return x;
+	}
+
+	static inline uint64_t Compact1By1(uint64_t x) {
+		x &= 0x5555555555555555ull;
+		x = (x | (x >> 1)) & 0x3333333333333333ull;
+		x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+		x = (x | (x >> 4)) & 0x00FF00FF00FF00FFull;
+		x = (x | (x >> 8)) & 0x0000FFFF0000FFFFull;
+		x = (x | (x >> 16)) & 0x00000000FFFFFFFFull;
+		return x;
+	}
+
+	static inline uint64_t Part1By2(uint64_t x) {
+		x &= 0x00000000001FFFFFull;
+		x = (x | (x << 32)) & 0x001F00000000FFFFull;
+		x = (x | (x << 16)) & 0x001F0000FF0000FFull;
+		x = (x | (x << 8)) & 0x100F00F00F00F00Full;
+		x = (x | (x << 4)) & 0x10C30C30C30C30C3ull;
+		x = (x | (x << 2)) & 0x1249249249249249ull;
+		return x;
+	}
+
+	static inline uint64_t Compact1By2(uint64_t x) {
+		x &= 0x1249249249249249ull;
+		x = (x | (x >> 2)) & 0x10C30C30C30C30C3ull;
+		x = (x | (x >> 4)) & 0x100F00F00F00F00Full;
+		x = (x | (x >> 8)) & 0x001F0000FF0000FFull;
+		x = (x | (x >> 16)) & 0x001F00000000FFFFull;
+		x = (x | (x >> 32)) & 0x00000000001FFFFFull;
+		return x;
+	}
+
+#if defined(SPACE_CURVE_PDEP)
+	// PDEP and PEXT are microcoded on AMD processors before Zen 3, where they are far slower than the magic bit fallback.
+	// Resolved on first use, so Processor::Init must have run beforehand for the fast path to be selected
+	static bool UsePDEP() {
+		static const bool s_pdep = zore::Processor::HasBMI2() && !(zore::Processor::GetVendor() == "AMD" && zore::Processor::GetFamily() < 0x19);
+		return s_pdep;
+	}
+
+	TARGET_BMI2 static uint32_t PDEPEncode2D(uint32_t x, uint32_t y) {
+		return _pdep_u32(x, 0x55555555u) | _pdep_u32(y, 0xAAAAAAAAu);
+	}
+
+	TARGET_BMI2 static uint32_t PDEPEncode3D(uint32_t x, uint32_t y, uint32_t z) {
+		return _pdep_u32(x, 0x09249249u) | _pdep_u32(y, 0x12492492u) | _pdep_u32(z, 0x24924924u);
+	}
+
+	TARGET_BMI2 static uint64_t PDEPEncode2D64(uint32_t x, uint32_t y) {
+		return _pdep_u64(x, 0x5555555555555555ull) | _pdep_u64(y, 0xAAAAAAAAAAAAAAAAull);
+	}
+
+	TARGET_BMI2 static uint64_t PDEPEncode3D64(uint32_t x, uint32_t y, uint32_t z) {
+		return _pdep_u64(x, 0x1249249249249249ull) | _pdep_u64(y, 0x2492492492492492ull) | _pdep_u64(z, 0x4924924924924924ull);
+	}
+
+	TARGET_BMI2 static zm::uvec2 PEXTDecode2D(uint32_t code) {
+		return { _pext_u32(code, 0x55555555u), _pext_u32(code, 0xAAAAAAAAu) };
+	}
+
+	TARGET_BMI2 static zm::uvec3 PEXTDecode3D(uint32_t code) {
+		return { _pext_u32(code, 0x09249249u), _pext_u32(code, 0x12492492u), _pext_u32(code, 0x24924924u) };
+	}
+
+	TARGET_BMI2 static zm::uvec2 PEXTDecode2D64(uint64_t code) {
+		return { static_cast<uint32_t>(_pext_u64(code, 0x5555555555555555ull)), static_cast<uint32_t>(_pext_u64(code, 0xAAAAAAAAAAAAAAAAull)) };
+	}
+
+	TARGET_BMI2 static zm::uvec3 PEXTDecode3D64(uint64_t code) {
+		return {
+			static_cast<uint32_t>(_pext_u64(code, 0x1249249249249249ull)),
+			static_cast<uint32_t>(_pext_u64(code, 0x2492492492492492ull)),
+			static_cast<uint32_t>(_pext_u64(code, 0x4924924924924924ull))
+		};
+	}
+
+	TARGET_BMI2 static void PDEPEncode2DBatch(const uint32_t* x, const uint32_t* y, size_t count, uint32_t* out) {
+		for (size_t i = 0; i < count; i++)
+			out[i] = _pdep_u32(x[i], 0x55555555u) | _pdep_u32(y[i], 0xAAAAAAAAu);
+	}
+
+	TARGET_BMI2 static void PDEPEncode3DBatch(const uint32_t* x, const uint32_t* y, const uint32_t* z, size_t count, uint32_t* out) {
+		for (size_t i = 0; i < count; i++)
+			out[i] = _pdep_u32(x[i], 0x09249249u) | _pdep_u32(y[i], 0x12492492u) | _pdep_u32(z[i], 0x24924924u);
+	}
+
+	TARGET_BMI2 static void PEXTDecode2DBatch(const uint32_t* codes, size_t count, uint32_t* x, uint32_t* y) {
+		for (size_t i = 0; i < count; i++) {
+			x[i] = _pext_u32(codes[i], 0x55555555u);
+			y[i] = _pext_u32(codes[i], 0xAAAAAAAAu);
+		}
+	}
+
+	TARGET_BMI2 static void PEXTDecode3DBatch(const uint32_t* codes, size_t count, uint32_t* x, uint32_t* y, uint32_t* z) {
+		for (size_t i = 0; i < count; i++) {
+			x[i] = _pext_u32(codes[i], 0x09249249u);
+			y[i] = _pext_u32(codes[i], 0x12492492u);
+			z[i] = _pext_u32(codes[i], 0x24924924u);
+		}
+	}
+#endif
+
+	//========================================================================
+	//	Morton (Z-Order) Curve
+	//========================================================================
+
+	uint32_t Morton::Encode2D(uint32_t x, uint32_t y) {
+#if defined(SPACE_CURVE_PDEP)
+		if (UsePDEP())
+			return PDEPEncode2D(x, y);
+#endif
+		return Part1By1(x) | (Part1By1(y) << 1);
+	}
+
+	uint32_t Morton::Encode3D(uint32_t x, uint32_t y, uint32_t z) {
+#if defined(SPACE_CURVE_PDEP)
+		if (UsePDEP())
+			return PDEPEncode3D(x, y, z);
+#endif
+		return Part1By2(x) | (Part1By2(y) << 1) | (Part1By2(z) << 2);
+	}
+
+	uint64_t Morton::Encode2D64(uint32_t x, uint32_t y) {
+#if defined(SPACE_CURVE_PDEP)
+		if (UsePDEP())
+			return PDEPEncode2D64(x, y);
+#endif
+		return Part1By1(static_cast<uint64_t>(x)) | (Part1By1(static_cast<uint64_t>(y)) << 1);
+	}
+
+	uint64_t Morton::Encode3D64(uint32_t x, uint32_t y, uint32_t z) {
+#if defined(SPACE_CURVE_PDEP)
+		if (UsePDEP())
+			return PDEPEncode3D64(x, y, z);
+#endif
+		return Part1By2(static_cast<uint64_t>(x)) | (Part1By2(static_cast<uint64_t>(y)) << 1) | (Part1By2(static_cast<uint64_t>(z)) << 2);
+	}
+
+	zm::uvec2 Morton::Decode2D(uint32_t code) {
+#if defined(SPACE_CURVE_PDEP)
+		if (UsePDEP())
+			return PEXTDecode2D(code);
+#endif
+		return { Compact1By1(code), Compact1By1(code >> 1) };
+	}
+
+	zm::uvec3 Morton::Decode3D(uint32_t code) {
+#if defined(SPACE_CURVE_PDEP)
+		if (UsePDEP())
+			return PEXTDecode3D(code);
+#endif
+		return { Compact1By2(code), Compact1By2(code >> 1), Compact1By2(code >> 2) };
+	}
+
+	zm::uvec2 Morton::Decode2D64(uint64_t code) {
+#if defined(SPACE_CURVE_PDEP)
+		if (UsePDEP())
+			return PEXTDecode2D64(code);
+#endif
+		return { static_cast<uint32_t>(Compact1By1(code)), static_cast<uint32_t>(Compact1By1(code >> 1)) };
+	}
+
+	zm::uvec3 Morton::Decode3D64(uint64_t code) {
+#if defined(SPACE_CURVE_PDEP)
+		if (UsePDEP())
+			return PEXTDecode3D64(code);
+#endif
+		return { static_cast<uint32_t>(Compact1By2(code)), static_cast<uint32_t>(Compact1By2(code >> 1)), static_cast<uint32_t>(Compact1By2(code >> 2)) };
+	}
+
+	void Morton::Encode2DBatch(const uint32_t* x, const uint32_t* y, size_t count, uint32_t* out) {
+#if defined(SPACE_CURVE_PDEP)
+		if (UsePDEP())
+			return PDEPEncode2DBatch(x, y, count, out);
+#endif
+		size_t i = 0;
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		for (; i + 4 <= count; i += 4)
+			(Part1By1(simd<uint32_t, 4>(x + i)) | (Part1By1(simd<uint32_t, 4>(y + i)) << 1)).unload(out + i);
+#endif
+		for (; i < count; i++)
+			out[i] = Part1By1(x[i]) | (Part1By1(y[i]) << 1);
+	}
+
+	void Morton::Encode3DBatch(const uint32_t* x, const uint32_t* y, const uint32_t* z, size_t count, uint32_t* out) {
+#if defined(SPACE_CURVE_PDEP)
+		if (UsePDEP())
+			return PDEPEncode3DBatch(x, y, z, count, out);
+#endif
+		size_t i = 0;
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		for (; i + 4 <= count; i += 4) {
+			simd<uint32_t, 4> code = Part1By2(simd<uint32_t, 4>(x + i));
+			code |= Part1By2(simd<uint32_t, 4>(y + i)) << 1;
+			code |= Part1By2(simd<uint32_t, 4>(z + i)) << 2;
+			code.unload(out + i);
+		}
+#endif
+		for (; i < count; i++)
+			out[i] = Part1By2(x[i]) | (Part1By2(y[i]) << 1) | (Part1By2(z[i]) << 2);
+	}
+
+	void Morton::Decode2DBatch(const uint32_t* codes, size_t count, uint32_t* x, uint32_t* y) {
+#if defined(SPACE_CURVE_PDEP)
+		if (UsePDEP())
+			return PEXTDecode2DBatch(codes, count, x, y);
+#endif
+		size_t i = 0;
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		for (; i + 4 <= count; i += 4) {
+			simd<uint32_t, 4> code(codes + i);
+			Compact1By1(code).unload(x + i);
+			Compact1By1(code >> 1).unload(y + i);
+		}
+#endif
+		for (; i < count; i++) {
+			x[i] = Compact1By1(codes[i]);
+			y[i] = Compact1By1(codes[i] >> 1);
+		}
+	}
+
+	void Morton::Decode3DBatch(const uint32_t* codes, size_t count, uint32_t* x, uint32_t* y, uint32_t* z) {
+#if defined(SPACE_CURVE_PDEP)
+		if (UsePDEP())
+			return PEXTDecode3DBatch(codes, count, x, y, z);
+#endif
+		size_t i = 0;
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		for (; i + 4 <= count; i += 4) {
+			simd<uint32_t, 4> code(codes + i);
+			Compact1By2(code).unload(x + i);
+			Compact1By2(code >> 1).unload(y + i);
+			Compact1By2(code >> 2).unload(z + i);
+		}
+#endif
+		for (; i < count; i++) {
+			x[i] = Compact1By2(codes[i]);
+			y[i] = Compact1By2(codes[i] >> 1);
+			z[i] = Compact1By2(codes[i] >> 2);
+		}
+	}
+
+	//========================================================================
+	//	Hilbert Curve
+	//========================================================================
+
+	// Hilbert indices are computed with John Skilling's transpose method, which rotates and reflects the axes in place,
+	// after which the index is simply the axes interleaved with the first axis as the most significant bit.
+	// The steps are written branch free, so that the same code runs on both scalar and SIMD lanes
+
+	template <typename T, int N>
+	static inline void ExchangeLowBits(T* X, int i, int bit) {
+		uint32_t low = (1u << bit) - 1u;
+		T set = T(0u) - ((X[i] >> bit) & 1u);
+		X[0] ^= set & low;
+		T t = ((X[0] ^ X[i]) & low) & ~set;
+		X[0] ^= t;
+		X[i] ^= t;
+	}
+
+	template <typename T, int N>
+	static inline void AxesToTranspose(T* X, int order) {
+		for (int bit = order - 1; bit > 0; bit--)
+			for (int i = 0; i < N; i++)
+				ExchangeLowBits<T, N>(X, i, bit);
+
+		// Gray encode
+		for (int i = 1; i < N; i++)
+			X[i] ^= X[i - 1];
+		T t(0u);
+		for (int bit = order - 1; bit > 0; bit--)
+			t ^= (T(0u) - ((X[N - 1] >> bit) & 1u)) & ((1u << bit) - 1u);
+		for (int i = 0; i < N; i++)
+			X[i] ^= t;
+	}
+
+	template <typename T, int N>
+	static inline void TransposeToAxes(T* X, int order) {
+		// Gray decode
+		T t = X[N - 1] >> 1;
+		for (int i = N - 1; i > 0; i--)
+			X[i] ^= X[i - 1];
+		X[0] ^= t;
+
+		for (int bit = 1; bit < order; bit++)
+			for (int i = N - 1; i >= 0; i--)
+				ExchangeLowBits<T, N>(X, i, bit);
+	}
+
+	uint32_t Hilbert::Encode2D(uint32_t x, uint32_t y, int order) {
+		DEBUG_ENSURE(order > 0 && order <= 16, "Hilbert order out of range");
+		uint32_t mask = ~(~0u << order);
+		uint32_t X[2] = { x & mask, y & mask };
+		AxesToTranspose<uint32_t, 2>(X, order);
+		return Morton::Encode2D(X[1], X[0]);
+	}
+
+	uint64_t Hilbert::Encode3D(uint32_t x, uint32_t y, uint32_t z, int order) {
+		DEBUG_ENSURE(order > 0 && order <= 21, "Hilbert order out of range");
+		uint32_t mask = ~(~0u << order);
+		uint32_t X[3] = { x & mask, y & mask, z & mask };
+		AxesToTranspose<uint32_t, 3>(X, order);
+		return Morton::Encode3D64(X[2], X[1], X[0]);
+	}
+
+	zm::uvec2 Hilbert::Decode2D(uint32_t index, int order) {
+		DEBUG_ENSURE(order > 0 && order <= 16, "Hilbert order out of range");
+		zm::uvec2 axes = Morton::Decode2D(index);
+		uint32_t X[2] = { axes.y, axes.x };
+		TransposeToAxes<uint32_t, 2>(X, order);
+		return { X[0], X[1] };
+	}
+
+	zm::uvec3 Hilbert::Decode3D(uint64_t index, int order) {
+		DEBUG_ENSURE(order > 0 && order <= 21, "Hilbert order out of range");
+		zm::uvec3 axes = Morton::Decode3D64(index);
+		uint32_t X[3] = { axes.z, axes.y, axes.x };
+		TransposeToAxes<uint32_t, 3>(X, order);
+		return { X[0], X[1], X[2] };
+	}
+
+	void Hilbert::Encode2DBatch(const uint32_t* x, const uint32_t* y, size_t count, int order, uint32_t* out) {
+		DEBUG_ENSURE(order > 0 && order <= 16, "Hilbert order out of range");
+		size_t i = 0;
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		uint32_t mask = ~(~0u << order);
+		for (; i + 4 <= count; i += 4) {
+			simd<uint32_t, 4> X[2] = { simd<uint32_t, 4>(x + i) & mask, simd<uint32_t, 4>(y + i) & mask };
+			AxesToTranspose<simd<uint32_t, 4>, 2>(X, order);
+			(Part1By1(X[1]) | (Part1By1(X[0]) << 1)).unload(out + i);
+		}
+#endif
+		for (; i < count; i++)
+			out[i] = Encode2D(x[i], y[i], order);
+	}
+
+	void Hilbert::Encode3DBatch(const uint32_t* x, const uint32_t* y, const uint32_t* z, size_t count, int order, uint32_t* out) {
+		DEBUG_ENSURE(order > 0 && order <= 10, "Hilbert order out of range for a 32 bit batch");
+		size_t i = 0;
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		uint32_t mask = ~(~0u << order);
+		for (; i + 4 <= count; i += 4) {
+			simd<uint32_t, 4> X[3] = { simd<uint32_t, 4>(x + i) & mask, simd<uint32_t, 4>(y + i) & mask, simd<uint32_t, 4>(z + i) & mask };
+			AxesToTranspose<simd<uint32_t, 4>, 3>(X, order);
+			simd<uint32_t, 4> code = Part1By2(X[2]);
+			code |= Part1By2(X[1]) << 1;
+			code |= Part1By2(X[0]) << 2;
+			code.unload(out + i);
+		}
+#endif
+		for (; i < count; i++)
+			out[i] = static_cast<uint32_t>(Encode3D(x[i], y[i], z[i], order));
+	}
+}
\ No newline at end of file
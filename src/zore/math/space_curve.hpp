@@ -0,0 +1,51 @@
+#pragma once
+
+#include "zore/math/vector/vec2.hpp"
+#include "zore/math/vector/vec3.hpp"
+
+namespace zm {
+
+	//========================================================================
+	//	Morton (Z-Order) Curve
+	//========================================================================
+
+	class Morton {
+	public:
+		// x occupies the lowest bit of every interleaved group. 32 bit codes hold 16 bits per axis in 2D and 10 in 3D,
+		// while 64 bit codes hold 32 bits per axis in 2D and 21 in 3D. Higher bits of each axis are discarded
+		static uint32_t Encode2D(uint32_t x, uint32_t y);
+		static uint32_t Encode3D(uint32_t x, uint32_t y, uint32_t z);
+		static uint64_t Encode2D64(uint32_t x, uint32_t y);
+		static uint64_t Encode3D64(uint32_t x, uint32_t y, uint32_t z);
+
+		static zm::uvec2 Decode2D(uint32_t code);
+		static zm::uvec3 Decode3D(uint32_t code);
+		static zm::uvec2 Decode2D64(uint64_t code);
+		static zm::uvec3 Decode3D64(uint64_t code);
+
+		// Batched 32 bit variants, taking each axis as a separate array
+		static void Encode2DBatch(const uint32_t* x, const uint32_t* y, size_t count, uint32_t* out);
+		static void Encode3DBatch(const uint32_t* x, const uint32_t* y, const uint32_t* z, size_t count, uint32_t* out);
+		static void Decode2DBatch(const uint32_t* codes, size_t count, uint32_t* x, uint32_t* y);
+		static void Decode3DBatch(const uint32_t* codes, size_t count, uint32_t* x, uint32_t* y, uint32_t* z);
+	};
+
+	//========================================================================
+	//	Hilbert Curve
+	//========================================================================
+
+	class Hilbert {
+	public:
+		// {order} is the number of bits per axis, such that the curve covers a grid of 2^order cells along each axis.
+		// 2D indices support orders up to 16 and 3D indices support orders up to 21
+		static uint32_t Encode2D(uint32_t x, uint32_t y, int order);
+		static uint64_t Encode3D(uint32_t x, uint32_t y, uint32_t z, int order);
+
+		static zm::uvec2 Decode2D(uint32_t index, int order);
+		static zm::uvec3 Decode3D(uint64_t index, int order);
+
+		// Batched variants, taking each axis as a separate array. 3D batches are limited to orders up to 10
+		static void Encode2DBatch(const uint32_t* x, const uint32_t* y, size_t count, int order, uint32_t* out);
+		static void Encode3DBatch(const uint32_t* x, const uint32_t* y, const uint32_t* z, size_t count, int order, uint32_t* out);
+	};
+}
\ No newline at end of file
@@ -1,22 +1,179 @@
-#include "zore/math/Spline.hpp"
-#include "zore/Debug.hpp"
-
-#include <glm/mat4x4.hpp>
+#include "zore/math/spline.hpp"
+#include "zore/math/simd.hpp"
+#include "zore/math/math.hpp"
+#include "zore/debug.hpp"
 
 namespace zm {
 
-	Spline::Spline(std::vector<glm::vec2>& points) {
-		glm::mat4 m;
-		glm::vec4 y;
-		for (int i = 0; i < 4; i++) {
-			float x = points[i].x;
-			y[i] = points[i].y;
-			m[0][i] = 1.f;
-			m[1][i] = x;
-			m[2][i] = x * x;
-			m[3][i] = x * x * x;
+	//========================================================================
+	//	Spline Utilities
+	//========================================================================
+
+	// 3 point Gauss-Legendre quadrature, used to integrate the speed of each arc length sample
+	static constexpr float GAUSS_NODE = 0.77459666924148337704f;
+	static constexpr float GAUSS_WEIGHT_CENTER = 8.f / 9.f;
+	static constexpr float GAUSS_WEIGHT_EDGE = 5.f / 9.f;
+
+	static inline zm::vec3 ToVec3(const zm::vec4& v) {
+		return { v.x, v.y, v.z };
+	}
+
+	//========================================================================
+	//	Cubic Spline
+	//========================================================================
+
+	Spline::Spline(const std::vector<zm::vec3>& points, Type type, bool closed, uint32_t samples) : m_length(0.f), m_invDistanceStep(0.f), m_closed(closed) {
+		const int32_t count = static_cast<int32_t>(points.size());
+		ENSURE(count >= (closed ? 3 : 2), "Not enough points to build a spline");
+		ENSURE(samples > 0, "Spline must take atleast one arc length sample per segment");
+
+		// Open splines are padded with mirrored phantom points, so that both types pass through the end points
+		auto point = [&](int32_t i) -> zm::vec4 {
+			if (closed)
+				return zm::vec4(points[WrapClamp(i, 0, count)], 0.f);
+			if (i < 0)
+				return zm::vec4((points[0] * 2.f) - points[1], 0.f);
+			if (i >= count)
+				return zm::vec4((points[count - 1] * 2.f) - points[count - 2], 0.f);
+			return zm::vec4(points[i], 0.f);
+		};
+
+		const int32_t segments = closed ? count : count - 1;
+		m_segments.reserve(segments);
+		for (int32_t i = 0; i < segments; i++) {
+			zm::vec4 p0 = point(i - 1), p1 = point(i), p2 = point(i + 1), p3 = point(i + 2);
+			Segment& s = m_segments.emplace_back();
+			if (type == Type::CATMULL_ROM) {
+				s.a = ((p1 - p2) * 3.f + p3 - p0) * 0.5f;
+				s.b = ((p0 * 2.f) - (p1 * 5.f) + (p2 * 4.f) - p3) * 0.5f;
+				s.c = (p2 - p0) * 0.5f;
+				s.d = p1;
+			}
+			else {
+				s.a = ((p1 - p2) * 3.f + p3 - p0) * (1.f / 6.f);
+				s.b = (p0 - (p1 * 2.f) + p2) * 0.5f;
+				s.c = (p2 - p0) * 0.5f;
+				s.d = (p0 + (p1 * 4.f) + p2) * (1.f / 6.f);
+			}
+		}
+		BuildDistanceTable(samples);
+	}
+
+	zm::vec3 Spline::Evaluate(float t) const {
+		return ToVec3(EvaluateSegment(SegmentParameter(t)));
+	}
+
+	zm::vec3 Spline::Tangent(float t) const {
+		return ToVec3(DerivativeSegment(SegmentParameter(t)));
+	}
+
+	zm::vec3 Spline::EvaluateAtDistance(float distance) const {
+		return ToVec3(EvaluateSegment(SegmentParameterAtDistance(distance)));
+	}
+
+	zm::vec3 Spline::TangentAtDistance(float distance) const {
+		return ToVec3(DerivativeSegment(SegmentParameterAtDistance(distance)));
+	}
+
+	float Spline::ParameterAtDistance(float distance) const {
+		return SegmentParameterAtDistance(distance) / static_cast<float>(m_segments.size());
+	}
+
+	void Spline::EvaluateBatch(const float* t, size_t count, zm::vec3* out) const {
+		for (size_t i = 0; i < count; i++)
+			out[i] = ToVec3(EvaluateSegment(SegmentParameter(t[i])));
+	}
+
+	void Spline::EvaluateAtDistanceBatch(const float* distances, size_t count, zm::vec3* out) const {
+		size_t i = 0;
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		// Maps 4 distances to table positions at once, leaving only the table reads and segment evaluation scalar
+		const simd<float, 4> length(m_length);
+		const simd<float, 4> invLength(m_length > 0.f ? 1.f / m_length : 0.f);
+		const simd<float, 4> last(static_cast<float>(m_distanceTable.size() - 1));
+		alignas(16) int32_t index[4];
+		alignas(16) float fraction[4];
+		for (; i + 4 <= count; i += 4) {
+			simd<float, 4> d(distances + i);
+			if (m_closed)
+				d -= floor(d * invLength) * length;
+			simd<float, 4> x = min(max(d * m_invDistanceStep, simd<float, 4>(0.f)), last);
+			simd<int32_t, 4> base(x);
+			(x - simd<float, 4>(base)).unload_aligned(fraction);
+			base.unload_aligned(index);
+			for (int j = 0; j < 4; j++) {
+				int32_t k = zm::Min(index[j], static_cast<int32_t>(m_distanceTable.size()) - 2);
+				float u = Lerp(m_distanceTable[k], m_distanceTable[k + 1], fraction[j] + static_cast<float>(index[j] - k));
+				out[i + j] = ToVec3(EvaluateSegment(u));
+			}
 		}
+#endif
+		for (; i < count; i++)
+			out[i] = ToVec3(EvaluateSegment(SegmentParameterAtDistance(distances[i])));
+	}
 
-		y = glm::inverse(m) * y;
+	float Spline::SegmentParameter(float t) const {
+		t = m_closed ? t - std::floor(t) : Clamp(t, 0.f, 1.f);
+		return t * static_cast<float>(m_segments.size());
+	}
+
+	float Spline::SegmentParameterAtDistance(float distance) const {
+		distance = m_closed ? WrapClamp(distance, 0.f, m_length) : Clamp(distance, 0.f, m_length);
+		float x = distance * m_invDistanceStep;
+		uint32_t i = zm::Min(static_cast<uint32_t>(x), static_cast<uint32_t>(m_distanceTable.size()) - 2);
+		return Lerp(m_distanceTable[i], m_distanceTable[i + 1], x - static_cast<float>(i));
+	}
+
+	zm::vec4 Spline::EvaluateSegment(float u) const {
+		uint32_t i = zm::Min(static_cast<uint32_t>(u), static_cast<uint32_t>(m_segments.size()) - 1);
+		const Segment& s = m_segments[i];
+		float t = u - static_cast<float>(i);
+		return ((s.a * t + s.b) * t + s.c) * t + s.d;
+	}
+
+	zm::vec4 Spline::DerivativeSegment(float u) const {
+		uint32_t i = zm::Min(static_cast<uint32_t>(u), static_cast<uint32_t>(m_segments.size()) - 1);
+		const Segment& s = m_segments[i];
+		float t = u - static_cast<float>(i);
+		return ((s.a * (3.f * t)) + (s.b * 2.f)) * t + s.c;
+	}
+
+	void Spline::BuildDistanceTable(uint32_t samples) {
+		const uint32_t intervals = static_cast<uint32_t>(m_segments.size()) * samples;
+		const float h = 1.f / static_cast<float>(samples);
+
+		// Cumulative arc length at uniformly spaced segment parameters
+		std::vector<float> distances(intervals + 1);
+		distances[0] = 0.f;
+		for (uint32_t i = 0; i < intervals; i++) {
+			float mid = (static_cast<float>(i) + 0.5f) * h;
+			float offset = 0.5f * h * GAUSS_NODE;
+			float speed = DerivativeSegment(mid).Length() * GAUSS_WEIGHT_CENTER;
+			speed += (DerivativeSegment(mid - offset).Length() + DerivativeSegment(mid + offset).Length()) * GAUSS_WEIGHT_EDGE;
+			distances[i + 1] = distances[i] + speed * 0.5f * h;
+		}
+		m_length = distances[intervals];
+
+		// Invert the table, resampling it at uniformly spaced distances
+		m_distanceTable.resize(intervals + 1);
+		m_distanceTable[0] = 0.f;
+		m_distanceTable[intervals] = static_cast<float>(m_segments.size());
+		if (m_length <= 0.f) {
+			for (uint32_t i = 1; i < intervals; i++)
+				m_distanceTable[i] = 0.f;
+			return;
+		}
+
+		const float step = m_length / static_cast<float>(intervals);
+		m_invDistanceStep = 1.f / step;
+		uint32_t j = 0;
+		for (uint32_t i = 1; i < intervals; i++) {
+			float target = static_cast<float>(i) * step;
+			while (j < intervals - 1 && distances[j + 1] < target)
+				j++;
+			float span = distances[j + 1] - distances[j];
+			float f = span > 0.f ? Clamp((target - distances[j]) / span, 0.f, 1.f) : 0.f;
+			m_distanceTable[i] = (static_cast<float>(j) + f) * h;
+		}
 	}
 }
\ No newline at end of file
@@ -1,20 +1,61 @@
 #pragma once
+
+#include "zore/math/vector/vec3.hpp"
+#include "zore/math/vector/vec4.hpp"
 #include <vector>
-#include <glm/vec2.hpp>
-#include <glm/vec4.hpp>
 
 namespace zm {
 
-	struct Curve {
-		glm::vec4 exponents;
-		float threshold;
-	};
+	//========================================================================
+	//	Cubic Spline
+	//========================================================================
 
 	class Spline {
 	public:
-		Spline(std::vector<glm::vec2>& points);
+		enum class Type { CATMULL_ROM, B_SPLINE };
+		static constexpr uint32_t DEFAULT_SAMPLES = 16;
+
+	private:
+		// Power basis coefficients of a single segment: a*t^3 + b*t^2 + c*t + d, with w left at zero
+		struct Segment {
+			zm::vec4 a, b, c, d;
+		};
+
+	public:
+		// Catmull-Rom splines pass through every point, while B-splines only pass through the end points of an open spline.
+		// {samples} is the number of arc length samples taken per segment when building the distance lookup table
+		Spline(const std::vector<zm::vec3>& points, Type type = Type::CATMULL_ROM, bool closed = false, uint32_t samples = DEFAULT_SAMPLES);
+		~Spline() = default;
+
+		// Evaluates the spline at t in the range [0, 1], where every segment spans an equal range of t
+		zm::vec3 Evaluate(float t) const;
+		zm::vec3 Tangent(float t) const;
+
+		// Evaluates the spline {distance} units along its length, for constant speed traversal
+		zm::vec3 EvaluateAtDistance(float distance) const;
+		zm::vec3 TangentAtDistance(float distance) const;
+		float ParameterAtDistance(float distance) const;
+
+		void EvaluateBatch(const float* t, size_t count, zm::vec3* out) const;
+		void EvaluateAtDistanceBatch(const float* distances, size_t count, zm::vec3* out) const;
+
+		float GetLength() const { return m_length; }
+		uint32_t GetSegmentCount() const { return static_cast<uint32_t>(m_segments.size()); }
+		bool IsClosed() const { return m_closed; }
+
+	private:
+		float SegmentParameter(float t) const;
+		float SegmentParameterAtDistance(float distance) const;
+		zm::vec4 EvaluateSegment(float u) const;
+		zm::vec4 DerivativeSegment(float u) const;
+		void BuildDistanceTable(uint32_t samples);
 
 	private:
-		std::vector<Curve> curves;
+		std::vector<Segment> m_segments;
+		// Segment space parameter at uniformly spaced distances along the spline, so lookups never need to search
+		std::vector<float> m_distanceTable;
+		float m_length;
+		float m_invDistanceStep;
+		bool m_closed;
 	};
 }
\ No newline at end of file
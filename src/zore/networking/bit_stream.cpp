@@ -0,0 +1,169 @@
+#include "zore/networking/bit_stream.hpp"
+#include "zore/debug.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+namespace zore::net {
+
+	uint32_t QuantizationSteps(float min, float max, float precision) {
+		DEBUG_ENSURE(max > min && precision > 0.f, "Quantized ranges need a positive size and precision");
+		return static_cast<uint32_t>(std::ceil((max - min) / precision));
+	}
+
+	uint32_t Quantize(float value, float min, float max, uint32_t steps) {
+		float normalized = (std::clamp(value, min, max) - min) / (max - min);
+		return static_cast<uint32_t>(std::lround(normalized * steps));
+	}
+
+	float Dequantize(uint32_t value, float min, float max, uint32_t steps) {
+		return min + (max - min) * (static_cast<float>(std::min(value, steps)) / steps);
+	}
+
+	static uint64_t ZigZag(int64_t value) {
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+	}
+
+	static int64_t UnZigZag(uint64_t value) {
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+
+	//========================================================================
+	//	Bit Writer
+	//========================================================================
+
+	void BitWriter::WriteRanged(int32_t value, int32_t min, int32_t max) {
+		DEBUG_ENSURE(min <= max && value >= min && value <= max, "Ranged value is outside of its range");
+		uint32_t range = static_cast<uint32_t>(max) - static_cast<uint32_t>(min);
+		WriteBits(static_cast<uint32_t>(value) - static_cast<uint32_t>(min), BitsRequired(range));
+	}
+
+	void BitWriter::WriteFloat(float value, float min, float max, float precision) {
+		uint32_t steps = QuantizationSteps(min, max, precision);
+		WriteBits(Quantize(value, min, max, steps), BitsRequired(steps));
+	}
+
+	void BitWriter::WriteVector(const zm::vec3& value, float min, float max, float precision) {
+		for (int i = 0; i < 3; i++)
+			WriteFloat(value[i], min, max, precision);
+	}
+
+	void BitWriter::WriteVarint(uint64_t value) {
+		while (value >= 0x80) {
+			WriteBits(static_cast<uint32_t>(value & 0x7F) | 0x80, 8);
+			value >>= 7;
+		}
+		WriteBits(static_cast<uint32_t>(value), 8);
+	}
+
+	void BitWriter::WriteSignedVarint(int64_t value) {
+		WriteVarint(ZigZag(value));
+	}
+
+	void BitWriter::WriteBytes(const void* data, size_t size) {
+		Flush();
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		m_data.insert(m_data.end(), bytes, bytes + size);
+	}
+
+	void BitWriter::Flush() {
+		for (uint32_t bytes = (m_scratch_bits + 7) / 8; bytes > 0; bytes--) {
+			m_data.push_back(static_cast<uint8_t>(m_scratch));
+			m_scratch >>= 8;
+		}
+		m_scratch = 0;
+		m_scratch_bits = 0;
+	}
+
+	void BitWriter::Clear() {
+		m_data.clear();
+		m_scratch = 0;
+		m_scratch_bits = 0;
+	}
+
+	//========================================================================
+	//	Bit Reader
+	//========================================================================
+
+	int32_t BitReader::ReadRanged(int32_t min, int32_t max) {
+		uint32_t range = static_cast<uint32_t>(max) - static_cast<uint32_t>(min);
+		uint32_t value = ReadBits(BitsRequired(range));
+		return static_cast<int32_t>(static_cast<uint32_t>(min) + std::min(value, range));
+	}
+
+	float BitReader::ReadFloat(float min, float max, float precision) {
+		uint32_t steps = QuantizationSteps(min, max, precision);
+		return Dequantize(ReadBits(BitsRequired(steps)), min, max, steps);
+	}
+
+	zm::vec3 BitReader::ReadVector(float min, float max, float precision) {
+		float x = ReadFloat(min, max, precision);
+		float y = ReadFloat(min, max, precision);
+		float z = ReadFloat(min, max, precision);
+		return { x, y, z };
+	}
+
+	uint64_t BitReader::ReadVarint() {
+		uint64_t value = 0;
+		for (uint32_t shift = 0; shift < 64; shift += 7) {
+			uint32_t byte = ReadBits(8);
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				return value;
+		}
+		// More than ten bytes is never written, so the data is corrupt
+		m_overflow = true;
+		return 0;
+	}
+
+	int64_t BitReader::ReadSignedVarint() {
+		return UnZigZag(ReadVarint());
+	}
+
+	void BitReader::ReadBytes(void* data, size_t size) {
+		Align();
+		// Whole bytes left in the scratch word come first, then the rest is copied straight from the data
+		uint8_t* bytes = static_cast<uint8_t*>(data);
+		while (size > 0 && m_scratch_bits > 0) {
+			*bytes++ = static_cast<uint8_t>(ReadBits(8));
+			size--;
+		}
+		if (size > m_data.size() - m_position) {
+			m_overflow = true;
+			m_position = m_data.size();
+			std::memset(bytes, 0, size);
+			return;
+		}
+		if (size > 0)
+			std::memcpy(bytes, m_data.data() + m_position, size);
+		m_position += size;
+	}
+
+	void BitReader::Align() {
+		uint32_t skip = m_scratch_bits % 8;
+		m_scratch >>= skip;
+		m_scratch_bits -= skip;
+	}
+
+	bool BitReader::Refill(uint32_t bits) {
+		// Loads a whole word when one is left, and single bytes at the end of the data
+		if (m_data.size() - m_position >= 4 && m_scratch_bits <= 32) {
+			uint32_t word;
+			std::memcpy(&word, m_data.data() + m_position, sizeof(word));
+			m_scratch |= static_cast<uint64_t>(word) << m_scratch_bits;
+			m_scratch_bits += 32;
+			m_position += 4;
+		}
+		while (m_scratch_bits < bits && m_position < m_data.size()) {
+			m_scratch |= static_cast<uint64_t>(m_data[m_position++]) << m_scratch_bits;
+			m_scratch_bits += 8;
+		}
+		if (m_scratch_bits >= bits)
+			return true;
+		m_overflow = true;
+		m_scratch = 0;
+		m_scratch_bits = 0;
+		m_position = m_data.size();
+		return false;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "zore/math/vector.hpp"
+#include "zore/utils/sized_integer.hpp"
+#include <vector>
+#include <span>
+#include <bit>
+
+namespace zore::net {
+
+	// Number of bits needed to store every value in [0, max]
+	constexpr uint32_t BitsRequired(uint32_t max) { return max ? std::bit_width(max) : 1; }
+
+	// Floats in [min, max] are quantized to integers in [0, steps], with steps chosen so that no step is wider than precision
+	uint32_t QuantizationSteps(float min, float max, float precision);
+	uint32_t Quantize(float value, float min, float max, uint32_t steps);
+	float Dequantize(uint32_t value, float min, float max, uint32_t steps);
+
+	// Snapshot fields are usually much smaller than their in memory types, so they are packed into the fewest bits their range
+	// allows. Bits fill a 64 bit scratch word, which is written out and read in 32 bits at a time
+
+	//========================================================================
+	//	Bit Writer
+	//========================================================================
+
+	class BitWriter {
+	public:
+		BitWriter() : m_scratch(0), m_scratch_bits(0) {}
+
+		void WriteBits(uint32_t value, uint32_t bits) {
+			m_scratch |= static_cast<uint64_t>(bits < 32 ? value & ((1u << bits) - 1u) : value) << m_scratch_bits;
+			m_scratch_bits += bits;
+			if (m_scratch_bits >= 32) {
+				uint32_t word = static_cast<uint32_t>(m_scratch);
+				const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&word);
+				m_data.insert(m_data.end(), bytes, bytes + sizeof(word));
+				m_scratch >>= 32;
+				m_scratch_bits -= 32;
+			}
+		}
+		void WriteBool(bool value) { WriteBits(value ? 1u : 0u, 1); }
+		// Stores value - min in as many bits as max - min needs
+		void WriteRanged(int32_t value, int32_t min, int32_t max);
+		// Quantizes value into steps of at most {precision} between min and max, clamping values outside of the range
+		void WriteFloat(float value, float min, float max, float precision);
+		void WriteVector(const zm::vec3& value, float min, float max, float precision);
+		// Seven bits per byte, so that small values take a single byte
+		void WriteVarint(uint64_t value);
+		// Zigzag encodes value first, so that small negative values stay small
+		void WriteSignedVarint(int64_t value);
+		void WriteBytes(const void* data, size_t size);
+
+		// Pads to the next byte and writes out every pending bit. Writing can continue afterwards
+		void Flush();
+		void Clear();
+		size_t BitsWritten() const { return m_data.size() * 8 + m_scratch_bits; }
+		// Only includes bits up to the last flush
+		std::span<const uint8_t> Data() const { return m_data; }
+
+	private:
+		std::vector<uint8_t> m_data;
+		uint64_t m_scratch;
+		uint32_t m_scratch_bits;
+	};
+
+	//========================================================================
+	//	Bit Reader
+	//========================================================================
+
+	// Reads values in the order and with the ranges they were written with. Reading past the end returns zeros and marks the
+	// reader as overflowed, rather than reading out of bounds
+	class BitReader {
+	public:
+		BitReader() : BitReader(std::span<const uint8_t>()) {}
+		BitReader(std::span<const uint8_t> data) : m_data(data), m_position(0), m_scratch(0), m_scratch_bits(0), m_overflow(false) {}
+
+		uint32_t ReadBits(uint32_t bits) {
+			if (m_scratch_bits < bits && !Refill(bits))
+				return 0;
+			uint32_t value = static_cast<uint32_t>(m_scratch) & (bits < 32 ? (1u << bits) - 1u : ~0u);
+			m_scratch >>= bits;
+			m_scratch_bits -= bits;
+			return value;
+		}
+		bool ReadBool() { return ReadBits(1) != 0; }
+		int32_t ReadRanged(int32_t min, int32_t max);
+		float ReadFloat(float min, float max, float precision);
+		zm::vec3 ReadVector(float min, float max, float precision);
+		uint64_t ReadVarint();
+		int64_t ReadSignedVarint();
+		void ReadBytes(void* data, size_t size);
+
+		// Skips to the next byte, matching a flush on the writer
+		void Align();
+		bool IsOverflowed() const { return m_overflow; }
+		size_t BitsRemaining() const { return (m_data.size() - m_position) * 8 + m_scratch_bits; }
+
+	private:
+		bool Refill(uint32_t bits);
+
+	private:
+		std::span<const uint8_t> m_data;
+		size_t m_position;
+		uint64_t m_scratch;
+		uint32_t m_scratch_bits;
+		bool m_overflow;
+	};
+}
\ No newline at end of file
@@ -26,10 +26,28 @@
 #elif defined(PLATFORM_LINUX)
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 #include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <errno.h>
+#include <cstring>
 #define INVALID_SOCKET -1
 #define SOCKET_ERROR -1
+
+#define SOCK_CONNECTION_REFUSED   ECONNREFUSED
+#define SOCK_CONNECTION_RESET     ECONNRESET
+#define SOCK_CONNECTION_ABORTED   ECONNABORTED
+#define SOCK_CONNECTION_TIMED_OUT ETIMEDOUT
+#define SOCK_HOST_UNREACHABLE     EHOSTUNREACH
+#define SOCK_NETWORK_UNREACHABLE  ENETUNREACH
+
+#define SOCK_WOULD_BLOCK          EWOULDBLOCK
+#define SOCK_ALREADY              EALREADY
+#define SOCK_NET_RESET            ENETRESET
+#define SOCK_NOT_CONNECTED        ENOTCONN
+#define SOCK_IS_CONNECTED         EISCONN
 #endif
 
 namespace zore::net {
@@ -40,9 +58,17 @@ namespace zore::net {
 		std::string error_message = zore::WindowsException::GetErrorString(error_code);
 #elif defined(PLATFORM_LINUX)
 		int error_code = errno;
-		std::string error_message(' ', strerrorlen_s(error_code));
-		strerror_s(error_message.data(), error_message.length(), error_code);
+		std::string error_message = strerror(error_code);
 #endif
 		return std::format("Socket error {} executing \"{}\": {}", error_code, function, error_message);
 	}
+
+	// Whether the last socket call failed only because a non blocking socket was not ready
+	static inline bool WouldBlock() {
+#if defined(PLATFORM_WINDOWS)
+		return WSAGetLastError() == SOCK_WOULD_BLOCK;
+#elif defined(PLATFORM_LINUX)
+		return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+	}
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "zore/networking/packet.hpp"
 #include "zore/networking/networking_utils.hpp"
+#include "zore/networking/bit_stream.hpp"
 
 namespace zore::net {
 
@@ -180,68 +181,84 @@ namespace zore::net {
 		return *this;
 	}
 
+	Packet& Packet::operator>>(BitReader& data) {
+		uint32_t size = 0;
+		*this >> size;
+		size = size < Remaining() ? size : Remaining();
+		data = BitReader({ m_data.data() + m_position, size });
+		m_position += size;
+		return *this;
+	}
+
 	//------------------------------------------------------------------------
 	//	Write to the data stream
 	//------------------------------------------------------------------------
 
 	Packet& Packet::operator<<(bool data) {
-        Append({ &data, sizeof(data) });
+        Append({ &data, 1 });
 		return *this;
 	}
 
 	Packet& Packet::operator<<(int8_t data) {
-		Append({ &data, sizeof(data) });
+		Append({ &data, 1 });
 		return *this;
 	}
 
 	Packet& Packet::operator<<(uint8_t data) {
-		Append({ &data, sizeof(data) });
+		Append({ &data, 1 });
 		return *this;
 	}
 
 	Packet& Packet::operator<<(int16_t data) {
 		data = zton(data);
-		Append({ &data, sizeof(data) });
+		Append({ &data, 1 });
 		return *this;
 	}
 
 	Packet& Packet::operator<<(uint16_t data) {
 		data = zton(data);
-		Append({ &data, sizeof(data) });
+		Append({ &data, 1 });
 		return *this;
 	}
 
 	Packet& Packet::operator<<(int32_t data) {
 		data = zton(data);
-		Append({ &data, sizeof(data) });
+		Append({ &data, 1 });
 		return *this;
 	}
 
 	Packet& Packet::operator<<(uint32_t data) {
 		data = zton(data);
-		Append({ &data, sizeof(data) });
+		Append({ &data, 1 });
 		return *this;
 	}
 
 	Packet& Packet::operator<<(int64_t data) {
 		data = zton(data);
-		Append({ &data, sizeof(data) });
+		Append({ &data, 1 });
 		return *this;
 	}
 
 	Packet& Packet::operator<<(uint64_t data) {
 		data = zton(data);
-		Append({ &data, sizeof(data) });
+		Append({ &data, 1 });
 		return *this;
 	}
 
 	Packet& Packet::operator<<(float data) {
-		Append({ &data, sizeof(data) });
+		Append({ &data, 1 });
 		return *this;
 	}
 
 	Packet& Packet::operator<<(double data) {
-		Append({ &data, sizeof(data) });
+		Append({ &data, 1 });
+		return *this;
+	}
+
+	Packet& Packet::operator<<(BitWriter& data) {
+		data.Flush();
+		*this << static_cast<uint32_t>(data.Data().size());
+		Append({ const_cast<uint8_t*>(data.Data().data()), data.Data().size() });
 		return *this;
 	}
 }
\ No newline at end of file
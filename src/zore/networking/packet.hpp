@@ -6,6 +6,9 @@
 
 namespace zore::net {
 
+	class BitWriter;
+	class BitReader;
+
 	class Packet {
 	public:
 		friend class Socket;
@@ -46,6 +49,8 @@ namespace zore::net {
 		Packet& operator>>(uint64_t& data);
 		Packet& operator>>(float& data);
 		Packet& operator>>(double& data);
+		// Points the reader at bit packed data written with operator<<(BitWriter&). The reader refers to this packet's memory
+		Packet& operator>>(BitReader& data);
 
 		//------------------------------------------------------------------------
 		//	Write to the data stream
@@ -62,6 +67,8 @@ namespace zore::net {
 		Packet& operator<<(uint64_t data);
 		Packet& operator<<(float data);
 		Packet& operator<<(double data);
+		// Flushes the writer, and appends its data with a 32 bit byte count
+		Packet& operator<<(BitWriter& data);
 
     private:
         void SetHeader(uint16_t packet_id, uint16_t sequence_id, uint8_t version, uint8_t flags);
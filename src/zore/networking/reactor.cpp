@@ -0,0 +1,520 @@
+#include "zore/networking/reactor.hpp"
+#include "zore/networking/networking_core.hpp"
+#include "zore/debug/profiler.hpp"
+#include "zore/debug.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+#if defined(PLATFORM_LINUX)
+#include "zore/platform/linux/linux_io_ring.hpp"
+#include <sys/epoll.h>
+#endif
+
+namespace zore::net {
+
+#if defined(PLATFORM_LINUX)
+	// A peer that has gone away should fail the send, rather than raise SIGPIPE for the whole process
+	static constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+	static constexpr uint32_t CONNECTION_EVENTS = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+#else
+	static constexpr int SEND_FLAGS = 0;
+#endif
+	static constexpr size_t READ_SIZE = 16384;
+
+	// Event data holds a connection id or listener socket in the low half, and what the event is for in the high half
+	static constexpr uint64_t CONNECTION_TAG = 0;
+	static constexpr uint64_t LISTENER_TAG = 1ull << 32;
+	static constexpr uint64_t RECEIVE_TAG = 2ull << 32;
+	static constexpr uint64_t SEND_TAG = 3ull << 32;
+	static constexpr uint64_t IGNORE_TAG = 4ull << 32;
+	static constexpr uint64_t TAG_MASK = ~0ull << 32;
+
+	static constexpr uint32_t RING_ENTRIES = 4096;
+	// Received data is copied out of these straight away, so the ring only has to cover the completions of one poll
+	static constexpr uint16_t BUFFER_GROUP = 0;
+	static constexpr uint16_t BUFFER_COUNT = 1024;
+	static constexpr uint32_t BUFFER_SIZE = 4096;
+
+	//========================================================================
+	//	Connection Buffer
+	//========================================================================
+
+	uint8_t* Connection::Buffer::Reserve(size_t size) {
+		if (data.size() - end >= size)
+			return data.data() + end;
+		if (start > 0) {
+			std::memmove(data.data(), data.data() + start, end - start);
+			end -= start;
+			start = 0;
+		}
+		if (data.size() - end < size)
+			data.resize(std::max(end + size, data.size() * 2));
+		return data.data() + end;
+	}
+
+	void Connection::Buffer::Append(const void* bytes, size_t size) {
+		std::memcpy(Reserve(size), bytes, size);
+		end += size;
+	}
+
+	void Connection::Buffer::Consume(size_t size) {
+		start += std::min(size, end - start);
+		if (start == end)
+			start = end = 0;
+	}
+
+	//========================================================================
+	//	Connection
+	//========================================================================
+
+	Connection::Connection(Reactor* reactor, uint32_t id, Socket&& socket, Callbacks&& callbacks)
+		: m_reactor(reactor), m_id(id), m_socket(std::move(socket)), m_callbacks(std::move(callbacks)), m_closed(false), m_receiving(false), m_send_in_flight(false) {
+	}
+
+	void Connection::Send(const void* data, size_t size) {
+		if (m_closed || size == 0)
+			return;
+		if (m_reactor->m_backend == Reactor::Backend::IO_URING) {
+			if (m_send_in_flight) {
+				m_write.Append(data, size);
+			}
+			else {
+				m_sending.Append(data, size);
+				m_reactor->SubmitSend(*this);
+			}
+			return;
+		}
+		// With nothing queued the data goes straight to the socket, and only what it does not take is copied
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		while (m_write.Size() == 0 && size > 0) {
+			int result = send(m_socket.GetHandle(), reinterpret_cast<const char*>(bytes), static_cast<int>(std::min<size_t>(size, INT32_MAX)), SEND_FLAGS);
+			if (result < 0) {
+				if (WouldBlock())
+					break;
+				if (errno == EINTR)
+					continue;
+				Logger::Error(GetLastError("send"));
+				Close();
+				return;
+			}
+			bytes += result;
+			size -= result;
+		}
+		if (size > 0)
+			m_write.Append(bytes, size);
+	}
+
+	void Connection::Close() {
+		if (m_closed)
+			return;
+		m_closed = true;
+#if defined(PLATFORM_LINUX)
+		if (m_reactor->m_backend == Reactor::Backend::IO_URING) {
+			// Operations still in flight hold on to the socket, so it is shut down to end them, and only closed once the
+			// connection is released after they complete
+			shutdown(m_socket.GetHandle(), SHUT_RDWR);
+		}
+		else {
+			epoll_ctl(m_reactor->m_handle, EPOLL_CTL_DEL, m_socket.GetHandle(), nullptr);
+			m_socket.Close();
+		}
+#else
+		m_socket.Close();
+#endif
+		m_write.start = m_write.end = 0;
+		m_reactor->m_closed.push_back(m_id);
+		if (m_callbacks.on_close)
+			m_callbacks.on_close(*this);
+	}
+
+	bool Connection::Read(bool hangup) {
+		size_t received = 0;
+		bool disconnected = false;
+		while (true) {
+			uint8_t* destination = m_read.Reserve(READ_SIZE);
+			int result = recv(m_socket.GetHandle(), reinterpret_cast<char*>(destination), static_cast<int>(READ_SIZE), 0);
+			if (result > 0) {
+				m_read.end += result;
+				received += result;
+				// A short read means the socket was drained, and any data arriving later raises a new edge. A hangup raises no
+				// further edge though, so then the socket is read until it reports the disconnect
+				if (static_cast<size_t>(result) < READ_SIZE && !hangup)
+					break;
+			}
+			else if (result == 0) {
+				disconnected = true;
+				break;
+			}
+			else if (WouldBlock()) {
+				break;
+			}
+			else if (errno != EINTR) {
+				Logger::Error(GetLastError("recv"));
+				disconnected = true;
+				break;
+			}
+		}
+		// Data sent just before the peer disconnected is still handed over before the close
+		if (received > 0 && m_callbacks.on_read)
+			m_callbacks.on_read(*this);
+		if (disconnected)
+			Close();
+		return !m_closed;
+	}
+
+	bool Connection::Write() {
+		while (m_write.Size() > 0) {
+			int result = send(m_socket.GetHandle(), reinterpret_cast<const char*>(m_write.data.data() + m_write.start), static_cast<int>(std::min<size_t>(m_write.Size(), INT32_MAX)), SEND_FLAGS);
+			if (result < 0) {
+				if (WouldBlock())
+					return true;
+				if (errno == EINTR)
+					continue;
+				Logger::Error(GetLastError("send"));
+				Close();
+				return false;
+			}
+			m_write.Consume(result);
+		}
+		return true;
+	}
+
+	//========================================================================
+	//	Reactor
+	//========================================================================
+
+	Reactor::Reactor(Backend backend) : m_handle(-1), m_backend(Backend::EPOLL), m_next_id(0) {
+#if defined(PLATFORM_LINUX)
+		if (backend == Backend::IO_URING) {
+			auto ring = std::make_unique<IORing>();
+			// Multishot receives arrived in 6.0 along with zero copy sends, which unlike the receive flag can be probed for
+			if (ring->Init(RING_ENTRIES) && ring->Supports(IORING_OP_SEND_ZC) && ring->RegisterBufferRing(BUFFER_GROUP, BUFFER_COUNT, BUFFER_SIZE)) {
+				m_ring = std::move(ring);
+				m_backend = Backend::IO_URING;
+				return;
+			}
+			Logger::Warn("io_uring is not supported by this kernel, falling back to epoll");
+		}
+		m_handle = epoll_create1(EPOLL_CLOEXEC);
+		ENSURE(m_handle >= 0, "Failed to create epoll instance");
+#else
+		if (backend == Backend::IO_URING)
+			Logger::Warn("io_uring is only available on Linux");
+#endif
+	}
+
+	Reactor::~Reactor() {
+		// Connections are closed without their callbacks, as whatever they refer to may already be gone
+		m_listeners.clear();
+#if defined(PLATFORM_LINUX)
+		if (m_ring) {
+			for (auto& [id, connection] : m_connections) {
+				connection->m_closed = true;
+				shutdown(connection->m_socket.GetHandle(), SHUT_RDWR);
+			}
+			// In flight sends point into connection buffers, so they are given a chance to finish, and the ring is torn down
+			// before anything is freed in case they did not
+			auto in_flight = [&]() {
+				return std::any_of(m_connections.begin(), m_connections.end(), [](const auto& entry) { return entry.second->m_send_in_flight || entry.second->m_receiving; });
+			};
+			for (int i = 0; i < 100 && in_flight(); i++)
+				PollRing(0.01f);
+			m_ring.reset();
+		}
+#endif
+		m_connections.clear();
+#if defined(PLATFORM_LINUX)
+		if (m_handle >= 0)
+			close(m_handle);
+#endif
+	}
+
+	bool Reactor::Add(Listener& listener, AcceptCallback on_accept) {
+		if (!IsValid() || !listener.IsOpen())
+			return false;
+		listener.SetBlocking(false);
+		uint32_t key = static_cast<uint32_t>(listener.GetHandle());
+		if (m_backend == Backend::IO_URING) {
+			// A multishot accept also takes connections queued before it was armed
+			m_listeners[key] = { &listener, std::move(on_accept) };
+			ArmAccept(key);
+			return true;
+		}
+#if defined(PLATFORM_LINUX)
+		epoll_event event = {};
+		event.events = EPOLLIN | EPOLLET;
+		event.data.u64 = LISTENER_TAG | key;
+		if (epoll_ctl(m_handle, EPOLL_CTL_ADD, listener.GetHandle(), &event) != 0) {
+			Logger::Error(GetLastError("epoll_ctl"));
+			return false;
+		}
+#endif
+		m_listeners[key] = { &listener, std::move(on_accept) };
+		// Connections queued before registering raise no edge, so they are taken now
+		Accept(m_listeners[key]);
+		return true;
+	}
+
+	void Reactor::Remove(Listener& listener) {
+		auto iter = m_listeners.find(static_cast<uint32_t>(listener.GetHandle()));
+		if (iter == m_listeners.end())
+			return;
+#if defined(PLATFORM_LINUX)
+		if (m_ring) {
+			// Cancelled straight away, as the listener may be closed and its socket reused as soon as this returns
+			if (io_uring_sqe* sqe = m_ring->GetSubmission()) {
+				sqe->opcode = IORING_OP_ASYNC_CANCEL;
+				sqe->addr = LISTENER_TAG | iter->first;
+				sqe->user_data = IGNORE_TAG;
+				m_ring->Submit();
+			}
+		}
+		else {
+			epoll_ctl(m_handle, EPOLL_CTL_DEL, listener.GetHandle(), nullptr);
+		}
+#endif
+		m_listeners.erase(iter);
+	}
+
+	Connection* Reactor::Add(Socket&& socket, Connection::Callbacks callbacks) {
+		if (!IsValid() || !socket.IsOpen())
+			return nullptr;
+		socket.SetBlocking(false);
+		uint32_t id = m_next_id++;
+		auto connection = std::unique_ptr<Connection>(new Connection(this, id, std::move(socket), std::move(callbacks)));
+		if (m_backend == Backend::IO_URING) {
+			Connection* result = connection.get();
+			m_connections.emplace(id, std::move(connection));
+			ArmReceive(*result);
+			return result;
+		}
+#if defined(PLATFORM_LINUX)
+		// Registering reports the socket as ready straight away if data arrived before it was added
+		epoll_event event = {};
+		event.events = CONNECTION_EVENTS;
+		event.data.u64 = CONNECTION_TAG | id;
+		if (epoll_ctl(m_handle, EPOLL_CTL_ADD, connection->m_socket.GetHandle(), &event) != 0) {
+			Logger::Error(GetLastError("epoll_ctl"));
+			return nullptr;
+		}
+#endif
+		Connection* result = connection.get();
+		m_connections.emplace(id, std::move(connection));
+		return result;
+	}
+
+	Connection* Reactor::Find(uint32_t id) {
+		auto iter = m_connections.find(id);
+		return iter != m_connections.end() && !iter->second->m_closed ? iter->second.get() : nullptr;
+	}
+
+	int Reactor::Poll(float timeout) {
+		ZoneScoped;
+		Release();
+		if (!IsValid())
+			return 0;
+		if (m_backend == Backend::IO_URING)
+			return PollRing(timeout);
+
+#if defined(PLATFORM_LINUX)
+		epoll_event events[MAX_EVENTS];
+		int timeout_ms = timeout < 0.f ? -1 : static_cast<int>(std::ceil(timeout * 1000.f));
+		int count = epoll_wait(m_handle, events, MAX_EVENTS, timeout_ms);
+		if (count < 0) {
+			if (errno != EINTR)
+				Logger::Error(GetLastError("epoll_wait"));
+			return 0;
+		}
+
+		for (int i = 0; i < count; i++) {
+			const uint64_t data = events[i].data.u64;
+			if ((data & TAG_MASK) == LISTENER_TAG) {
+				auto iter = m_listeners.find(static_cast<uint32_t>(data));
+				if (iter != m_listeners.end())
+					Accept(iter->second);
+				continue;
+			}
+
+			// Closed connections are kept until the next poll, so events later in this batch still find them
+			auto iter = m_connections.find(static_cast<uint32_t>(data));
+			if (iter == m_connections.end() || iter->second->m_closed)
+				continue;
+			Connection& connection = *iter->second;
+			const uint32_t flags = events[i].events;
+			if ((flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && !connection.Read((flags & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0))
+				continue;
+			if ((flags & EPOLLOUT) && connection.m_write.Size() > 0 && connection.Write() && connection.m_write.Size() == 0 && connection.m_callbacks.on_write)
+				connection.m_callbacks.on_write(connection);
+		}
+		return count;
+#else
+		return 0;
+#endif
+	}
+
+	void Reactor::Accept(Watch& watch) {
+		std::vector<Socket> accepted;
+		watch.listener->AcceptConnections(accepted);
+		// The callback may remove its own listener, so it is called through a copy
+		AcceptCallback on_accept = watch.on_accept;
+		for (Socket& socket : accepted)
+			on_accept(std::move(socket));
+	}
+
+	void Reactor::Release() {
+		// Connections with operations still in flight are kept until those complete
+		std::erase_if(m_closed, [&](uint32_t id) {
+			auto iter = m_connections.find(id);
+			if (iter != m_connections.end() && (iter->second->m_receiving || iter->second->m_send_in_flight))
+				return false;
+			m_connections.erase(id);
+			return true;
+		});
+	}
+
+	//========================================================================
+	//	Reactor io_uring Backend
+	//========================================================================
+
+	int Reactor::PollRing(float timeout) {
+#if defined(PLATFORM_LINUX)
+		// Everything queued since the last poll is submitted by the same call that waits
+		m_ring->Submit(timeout == 0.f ? 0 : 1, timeout);
+		io_uring_cqe completions[MAX_EVENTS];
+		int total = 0;
+		while (uint32_t count = m_ring->Reap(completions, MAX_EVENTS)) {
+			total += count;
+			for (uint32_t i = 0; i < count; i++) {
+				const io_uring_cqe& completion = completions[i];
+				const uint64_t tag = completion.user_data & TAG_MASK;
+				const uint32_t key = static_cast<uint32_t>(completion.user_data);
+				const bool more = completion.flags & IORING_CQE_F_MORE;
+
+				if (tag == LISTENER_TAG) {
+					auto iter = m_listeners.find(key);
+					if (completion.res >= 0) {
+						Socket socket(static_cast<socket_t>(completion.res), Protocol::TCP, false);
+						if (iter != m_listeners.end()) {
+							AcceptCallback on_accept = iter->second.on_accept;
+							on_accept(std::move(socket));
+						}
+					}
+					else if (completion.res != -ECANCELED) {
+						Logger::Error("io_uring accept failed: " + std::string(strerror(-completion.res)));
+					}
+					// Accepting is only given up on for good if the kernel rejects the request itself
+					iter = m_listeners.find(key);
+					if (!more && iter != m_listeners.end() && completion.res != -EINVAL && completion.res != -EBADF)
+						ArmAccept(key);
+				}
+				else if (tag == RECEIVE_TAG) {
+					auto iter = m_connections.find(key);
+					Connection* connection = iter != m_connections.end() ? iter->second.get() : nullptr;
+					if (connection && !more)
+						connection->m_receiving = false;
+					if (completion.flags & IORING_CQE_F_BUFFER) {
+						uint16_t buffer = static_cast<uint16_t>(completion.flags >> IORING_CQE_BUFFER_SHIFT);
+						if (connection && !connection->m_closed && completion.res > 0) {
+							connection->m_read.Append(m_ring->GetBuffer(buffer), completion.res);
+							if (connection->m_callbacks.on_read)
+								connection->m_callbacks.on_read(*connection);
+						}
+						m_ring->ReturnBuffer(buffer);
+					}
+					if (!connection || connection->m_closed)
+						continue;
+					// Running out of buffers only ends the multishot receive, which is armed again once they are returned
+					if (completion.res == 0) {
+						connection->Close();
+					}
+					else if (completion.res < 0 && completion.res != -ENOBUFS) {
+						Logger::Error("io_uring receive failed: " + std::string(strerror(-completion.res)));
+						connection->Close();
+					}
+					else if (!more) {
+						ArmReceive(*connection);
+					}
+				}
+				else if (tag == SEND_TAG) {
+					auto iter = m_connections.find(key);
+					if (iter == m_connections.end())
+						continue;
+					Connection& connection = *iter->second;
+					connection.m_send_in_flight = false;
+					if (connection.m_closed) {
+						connection.m_sending.start = connection.m_sending.end = 0;
+						continue;
+					}
+					if (completion.res < 0) {
+						Logger::Error("io_uring send failed: " + std::string(strerror(-completion.res)));
+						connection.Close();
+						continue;
+					}
+					connection.m_sending.Consume(completion.res);
+					if (connection.m_sending.Size() == 0)
+						std::swap(connection.m_sending, connection.m_write);
+					if (connection.m_sending.Size() > 0)
+						SubmitSend(connection);
+					else if (connection.m_callbacks.on_write)
+						connection.m_callbacks.on_write(connection);
+				}
+			}
+		}
+		return total;
+#else
+		return 0;
+#endif
+	}
+
+	void Reactor::ArmAccept(uint32_t key) {
+#if defined(PLATFORM_LINUX)
+		io_uring_sqe* sqe = m_ring->GetSubmission();
+		if (!sqe) {
+			Logger::Error("io_uring submission queue is full");
+			return;
+		}
+		sqe->opcode = IORING_OP_ACCEPT;
+		sqe->fd = static_cast<int>(key);
+		sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+		sqe->accept_flags = SOCK_CLOEXEC;
+		sqe->user_data = LISTENER_TAG | key;
+#endif
+	}
+
+	void Reactor::ArmReceive(Connection& connection) {
+#if defined(PLATFORM_LINUX)
+		io_uring_sqe* sqe = m_ring->GetSubmission();
+		if (!sqe) {
+			Logger::Error("io_uring submission queue is full");
+			connection.Close();
+			return;
+		}
+		sqe->opcode = IORING_OP_RECV;
+		sqe->fd = connection.m_socket.GetHandle();
+		sqe->ioprio = IORING_RECV_MULTISHOT;
+		sqe->flags = IOSQE_BUFFER_SELECT;
+		sqe->buf_group = BUFFER_GROUP;
+		sqe->user_data = RECEIVE_TAG | connection.m_id;
+		connection.m_receiving = true;
+#endif
+	}
+
+	void Reactor::SubmitSend(Connection& connection) {
+#if defined(PLATFORM_LINUX)
+		io_uring_sqe* sqe = m_ring->GetSubmission();
+		if (!sqe) {
+			Logger::Error("io_uring submission queue is full");
+			connection.Close();
+			return;
+		}
+		sqe->opcode = IORING_OP_SEND;
+		sqe->fd = connection.m_socket.GetHandle();
+		sqe->addr = reinterpret_cast<uint64_t>(connection.m_sending.data.data() + connection.m_sending.start);
+		sqe->len = static_cast<uint32_t>(std::min<size_t>(connection.m_sending.Size(), UINT32_MAX));
+		sqe->msg_flags = SEND_FLAGS;
+		sqe->user_data = SEND_TAG | connection.m_id;
+		connection.m_send_in_flight = true;
+#endif
+	}
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "zore/networking/socket.hpp"
+#include "zore/platform.hpp"
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <span>
+
+namespace zore {
+	class IORing;
+}
+
+namespace zore::net {
+
+	class Reactor;
+
+	//========================================================================
+	//	Connection
+	//========================================================================
+
+	// A socket registered with a reactor, along with the bytes it has received but not yet consumed and the bytes still
+	// waiting to be sent. Connections are owned by their reactor, and stay valid until the reactor polls after they close
+	class Connection {
+	public:
+		friend class Reactor;
+
+		using Callback = std::function<void(Connection&)>;
+
+		struct Callbacks {
+			// New bytes were appended to the received buffer
+			Callback on_read;
+			// Everything queued has been handed to the socket
+			Callback on_write;
+			// The peer disconnected, the socket failed, or Close was called
+			Callback on_close;
+		};
+
+	private:
+		// Bytes live in [start, end) of the data, which only grows and is compacted once the front is consumed
+		struct Buffer {
+			std::vector<uint8_t> data;
+			size_t start = 0;
+			size_t end = 0;
+
+			size_t Size() const { return end - start; }
+			uint8_t* Reserve(size_t size);
+			void Append(const void* bytes, size_t size);
+			void Consume(size_t size);
+		};
+
+	public:
+		Connection(const Connection&) = delete;
+		Connection& operator=(const Connection&) = delete;
+
+		uint32_t GetID() const { return m_id; }
+		Socket& GetSocket() { return m_socket; }
+		bool IsClosed() const { return m_closed; }
+
+		std::span<const uint8_t> Received() const { return { m_read.data.data() + m_read.start, m_read.Size() }; }
+		void Consume(size_t size) { m_read.Consume(size); }
+		// Queues data behind anything still pending, writing as much as the socket takes straight away
+		void Send(const void* data, size_t size);
+		size_t Pending() const { return m_write.Size() + m_sending.Size(); }
+		// Anything still pending is dropped
+		void Close();
+
+	private:
+		Connection(Reactor* reactor, uint32_t id, Socket&& socket, Callbacks&& callbacks);
+
+		// Reads until the socket would block, or until it disconnects if the peer hung up. Returns false once the connection closed
+		bool Read(bool hangup);
+		// Writes until the socket would block or nothing is pending. Returns false once the connection closed
+		bool Write();
+
+	private:
+		Reactor* m_reactor;
+		uint32_t m_id;
+		Socket m_socket;
+		Callbacks m_callbacks;
+		Buffer m_read;
+		Buffer m_write;
+		// With io_uring the bytes being sent must stay put until the send completes, so new data queues in the write buffer
+		Buffer m_sending;
+		bool m_closed;
+		bool m_receiving;
+		bool m_send_in_flight;
+	};
+
+	//========================================================================
+	//	Reactor
+	//========================================================================
+
+	// Waits on many sockets at once, so that a server only touches the sockets that are ready. With epoll, sockets are edge
+	// triggered, and each is read or written until it would block before its callback runs, since an edge is only reported
+	// once. With io_uring, listeners and connections keep a single multishot accept or receive armed, receives land in a ring
+	// of registered buffers, and every send queued during a poll is submitted along with the next wait. Nothing is
+	// registered on platforms without a backend
+	class Reactor {
+	public:
+		friend class Connection;
+
+		using AcceptCallback = std::function<void(Socket&&)>;
+
+		enum class Backend { EPOLL, IO_URING };
+
+		static constexpr uint32_t MAX_EVENTS = 256;
+
+	private:
+		struct Watch {
+			Listener* listener;
+			AcceptCallback on_accept;
+		};
+
+	public:
+		// Falls back to epoll if io_uring is requested but the kernel does not support everything it needs
+		Reactor(Backend backend = Backend::EPOLL);
+		Reactor(const Reactor&) = delete;
+		Reactor& operator=(const Reactor&) = delete;
+		~Reactor();
+
+		bool IsValid() const { return m_handle >= 0 || m_backend == Backend::IO_URING; }
+		Backend GetBackend() const { return m_backend; }
+
+		// Accepted sockets are handed to the callback, which can Add them or drop them. The listener must outlive its
+		// registration, and is made non blocking
+		bool Add(Listener& listener, AcceptCallback on_accept);
+		void Remove(Listener& listener);
+		// Takes ownership of a connected socket and makes it non blocking. Returns null if it could not be registered
+		Connection* Add(Socket&& socket, Connection::Callbacks callbacks);
+		Connection* Find(uint32_t id);
+		size_t GetConnectionCount() const { return m_connections.size(); }
+
+		// Waits up to timeout seconds for sockets to become ready, with a negative timeout waiting until one does, and runs
+		// their callbacks. Connections closed since the last poll are released first. Returns the number of ready sockets
+		int Poll(float timeout = 0.f);
+
+	private:
+		void Accept(Watch& watch);
+		void Release();
+
+		int PollRing(float timeout);
+		void ArmAccept(uint32_t key);
+		void ArmReceive(Connection& connection);
+		void SubmitSend(Connection& connection);
+
+	private:
+		int m_handle;
+		Backend m_backend;
+#if defined(PLATFORM_LINUX)
+		std::unique_ptr<IORing> m_ring;
+#endif
+		uint32_t m_next_id;
+		std::unordered_map<uint32_t, std::unique_ptr<Connection>> m_connections;
+		std::unordered_map<uint32_t, Watch> m_listeners;
+		std::vector<uint32_t> m_closed;
+	};
+}
\ No newline at end of file
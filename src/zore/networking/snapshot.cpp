@@ -0,0 +1,261 @@
+#include "zore/networking/snapshot.hpp"
+#include "zore/networking/bit_stream.hpp"
+#include "zore/networking/packet.hpp"
+#include "zore/debug/profiler.hpp"
+#include "zore/debug.hpp"
+#include <algorithm>
+
+namespace zore::net {
+
+	//========================================================================
+	//	Snapshot Schema
+	//========================================================================
+
+	SnapshotSchema::FieldID SnapshotSchema::AddBool() {
+		m_fields.push_back({ Type::BOOL, 0, 0.f, 1.f, 1, 1 });
+		return static_cast<FieldID>(m_fields.size() - 1);
+	}
+
+	SnapshotSchema::FieldID SnapshotSchema::AddInteger(int32_t min, int32_t max) {
+		DEBUG_ENSURE(min <= max, "Integer fields need min <= max");
+		uint32_t steps = static_cast<uint32_t>(max) - static_cast<uint32_t>(min);
+		m_fields.push_back({ Type::INTEGER, min, static_cast<float>(min), static_cast<float>(max), steps, BitsRequired(steps) });
+		return static_cast<FieldID>(m_fields.size() - 1);
+	}
+
+	SnapshotSchema::FieldID SnapshotSchema::AddFloat(float min, float max, float precision) {
+		uint32_t steps = QuantizationSteps(min, max, precision);
+		m_fields.push_back({ Type::FLOAT, 0, min, max, steps, BitsRequired(steps) });
+		return static_cast<FieldID>(m_fields.size() - 1);
+	}
+
+	SnapshotSchema::FieldID SnapshotSchema::AddVector(float min, float max, float precision) {
+		FieldID field = AddFloat(min, max, precision);
+		AddFloat(min, max, precision);
+		AddFloat(min, max, precision);
+		return field;
+	}
+
+	//========================================================================
+	//	Snapshot
+	//========================================================================
+
+	Snapshot::Snapshot(const SnapshotSchema* schema, uint32_t tick) : m_schema(schema), m_tick(tick) {}
+
+	void Snapshot::Reset(const SnapshotSchema* schema, uint32_t tick) {
+		m_schema = schema;
+		m_tick = tick;
+		m_ids.clear();
+		m_values.clear();
+	}
+
+	uint32_t Snapshot::Add(uint32_t id) {
+		DEBUG_ENSURE(m_ids.empty() || id > m_ids.back(), "Snapshot entities must be added in increasing id order");
+		m_ids.push_back(id);
+		m_values.resize(m_values.size() + m_schema->GetFieldCount(), 0);
+		return static_cast<uint32_t>(m_ids.size() - 1);
+	}
+
+	uint32_t Snapshot::Find(uint32_t id) const {
+		auto iter = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+		return iter != m_ids.end() && *iter == id ? static_cast<uint32_t>(iter - m_ids.begin()) : NONE;
+	}
+
+	void Snapshot::SetBool(uint32_t index, SnapshotSchema::FieldID field, bool value) {
+		DEBUG_ENSURE(m_schema->GetField(field).type == SnapshotSchema::Type::BOOL, "Snapshot field is not a bool");
+		Value(index, field) = value ? 1 : 0;
+	}
+
+	void Snapshot::SetInteger(uint32_t index, SnapshotSchema::FieldID field, int32_t value) {
+		const SnapshotSchema::Field& desc = m_schema->GetField(field);
+		DEBUG_ENSURE(desc.type == SnapshotSchema::Type::INTEGER, "Snapshot field is not an integer");
+		Value(index, field) = std::min(static_cast<uint32_t>(std::max(value, desc.offset)) - static_cast<uint32_t>(desc.offset), desc.steps);
+	}
+
+	void Snapshot::SetFloat(uint32_t index, SnapshotSchema::FieldID field, float value) {
+		const SnapshotSchema::Field& desc = m_schema->GetField(field);
+		DEBUG_ENSURE(desc.type == SnapshotSchema::Type::FLOAT, "Snapshot field is not a float");
+		Value(index, field) = Quantize(value, desc.min, desc.max, desc.steps);
+	}
+
+	void Snapshot::SetVector(uint32_t index, SnapshotSchema::FieldID field, const zm::vec3& value) {
+		for (uint32_t i = 0; i < 3; i++)
+			SetFloat(index, field + i, value[i]);
+	}
+
+	bool Snapshot::GetBool(uint32_t index, SnapshotSchema::FieldID field) const {
+		return Value(index, field) != 0;
+	}
+
+	int32_t Snapshot::GetInteger(uint32_t index, SnapshotSchema::FieldID field) const {
+		const SnapshotSchema::Field& desc = m_schema->GetField(field);
+		return static_cast<int32_t>(static_cast<uint32_t>(desc.offset) + std::min(Value(index, field), desc.steps));
+	}
+
+	float Snapshot::GetFloat(uint32_t index, SnapshotSchema::FieldID field) const {
+		const SnapshotSchema::Field& desc = m_schema->GetField(field);
+		return Dequantize(Value(index, field), desc.min, desc.max, desc.steps);
+	}
+
+	zm::vec3 Snapshot::GetVector(uint32_t index, SnapshotSchema::FieldID field) const {
+		return { GetFloat(index, field), GetFloat(index, field + 1), GetFloat(index, field + 2) };
+	}
+
+	void Snapshot::Encode(const Snapshot* baseline, BitWriter& writer) const {
+		DEBUG_ENSURE(!baseline || baseline->m_schema == m_schema, "Snapshots can only be encoded against a baseline with the same schema");
+		const size_t field_count = m_schema->GetFieldCount();
+		writer.WriteVarint(m_ids.size());
+		// Both snapshots are sorted by id, so the matching baseline entity is found by walking them together
+		size_t base = 0;
+		for (size_t i = 0; i < m_ids.size(); i++) {
+			const uint32_t id = m_ids[i];
+			writer.WriteVarint(i == 0 ? id : id - m_ids[i - 1] - 1);
+			const uint32_t* values = &m_values[i * field_count];
+			while (baseline && base < baseline->m_ids.size() && baseline->m_ids[base] < id)
+				base++;
+
+			if (baseline && base < baseline->m_ids.size() && baseline->m_ids[base] == id) {
+				const uint32_t* previous = &baseline->m_values[base * field_count];
+				bool changed = !std::equal(values, values + field_count, previous);
+				writer.WriteBool(changed);
+				if (!changed)
+					continue;
+				for (size_t f = 0; f < field_count; f++) {
+					writer.WriteBool(values[f] != previous[f]);
+					if (values[f] != previous[f])
+						writer.WriteBits(values[f], m_schema->GetField(static_cast<SnapshotSchema::FieldID>(f)).bits);
+				}
+			}
+			else {
+				for (size_t f = 0; f < field_count; f++)
+					writer.WriteBits(values[f], m_schema->GetField(static_cast<SnapshotSchema::FieldID>(f)).bits);
+			}
+		}
+	}
+
+	bool Snapshot::Decode(const Snapshot* baseline, BitReader& reader) {
+		const size_t field_count = m_schema->GetFieldCount();
+		uint64_t count = reader.ReadVarint();
+		// Every entity takes at least a byte for its id, so corrupt counts are caught before allocating for them
+		if (reader.IsOverflowed() || count > reader.BitsRemaining() / 8)
+			return false;
+		m_ids.resize(count);
+		m_values.assign(count * field_count, 0);
+
+		size_t base = 0;
+		for (size_t i = 0; i < count; i++) {
+			uint64_t delta = reader.ReadVarint();
+			uint64_t id = i == 0 ? delta : m_ids[i - 1] + 1 + delta;
+			if (id >= NONE)
+				return false;
+			m_ids[i] = static_cast<uint32_t>(id);
+			uint32_t* values = &m_values[i * field_count];
+			while (baseline && base < baseline->m_ids.size() && baseline->m_ids[base] < id)
+				base++;
+
+			if (baseline && base < baseline->m_ids.size() && baseline->m_ids[base] == id) {
+				const uint32_t* previous = &baseline->m_values[base * field_count];
+				std::copy(previous, previous + field_count, values);
+				if (!reader.ReadBool())
+					continue;
+				for (size_t f = 0; f < field_count; f++)
+					if (reader.ReadBool())
+						values[f] = reader.ReadBits(m_schema->GetField(static_cast<SnapshotSchema::FieldID>(f)).bits);
+			}
+			else {
+				for (size_t f = 0; f < field_count; f++)
+					values[f] = reader.ReadBits(m_schema->GetField(static_cast<SnapshotSchema::FieldID>(f)).bits);
+			}
+		}
+		return !reader.IsOverflowed();
+	}
+
+	//========================================================================
+	//	Snapshot Sender
+	//========================================================================
+
+	void SnapshotSender::Encode(const Snapshot& snapshot, BitWriter& writer) {
+		ZoneScoped;
+		const uint32_t tick = snapshot.GetTick();
+		const Snapshot* baseline = nullptr;
+		if (m_acknowledged != Snapshot::NONE && tick > m_acknowledged && tick - m_acknowledged < HISTORY_SIZE) {
+			const Snapshot& candidate = m_history[m_acknowledged % HISTORY_SIZE];
+			if (candidate.IsValid() && candidate.GetTick() == m_acknowledged)
+				baseline = &candidate;
+		}
+
+		size_t start = writer.BitsWritten();
+		writer.WriteVarint(tick);
+		writer.WriteVarint(baseline ? tick - m_acknowledged : 0);
+		snapshot.Encode(baseline, writer);
+		m_history[tick % HISTORY_SIZE] = snapshot;
+
+		m_stats.last_bytes = static_cast<uint32_t>((writer.BitsWritten() - start + 7) / 8);
+		m_stats.bytes += m_stats.last_bytes;
+		if (baseline)
+			m_stats.delta_snapshots++;
+		else
+			m_stats.full_snapshots++;
+	}
+
+	void SnapshotSender::Encode(const Snapshot& snapshot, Packet& packet) {
+		BitWriter writer;
+		Encode(snapshot, writer);
+		packet << writer;
+	}
+
+	void SnapshotSender::Acknowledge(uint32_t tick) {
+		// Acknowledgements can arrive out of order, and only the newest is useful as a baseline
+		if (m_acknowledged == Snapshot::NONE || tick > m_acknowledged)
+			m_acknowledged = tick;
+	}
+
+	void SnapshotSender::Reset() {
+		for (Snapshot& snapshot : m_history)
+			snapshot.Reset(nullptr, 0);
+		m_acknowledged = Snapshot::NONE;
+		m_stats = {};
+	}
+
+	//========================================================================
+	//	Snapshot Receiver
+	//========================================================================
+
+	bool SnapshotReceiver::Decode(BitReader& reader, Snapshot& snapshot) {
+		ZoneScoped;
+		uint64_t tick = reader.ReadVarint();
+		uint64_t offset = reader.ReadVarint();
+		if (reader.IsOverflowed() || tick >= Snapshot::NONE || (m_latest != Snapshot::NONE && tick <= m_latest))
+			return false;
+
+		const Snapshot* baseline = nullptr;
+		if (offset > 0) {
+			if (offset >= SnapshotSender::HISTORY_SIZE || offset > tick)
+				return false;
+			const Snapshot& candidate = m_history[(tick - offset) % SnapshotSender::HISTORY_SIZE];
+			if (!candidate.IsValid() || candidate.GetTick() != tick - offset)
+				return false;
+			baseline = &candidate;
+		}
+
+		Snapshot decoded(m_schema, static_cast<uint32_t>(tick));
+		if (!decoded.Decode(baseline, reader))
+			return false;
+		m_history[tick % SnapshotSender::HISTORY_SIZE] = decoded;
+		m_latest = static_cast<uint32_t>(tick);
+		snapshot = std::move(decoded);
+		return true;
+	}
+
+	bool SnapshotReceiver::Decode(Packet& packet, Snapshot& snapshot) {
+		BitReader reader;
+		packet >> reader;
+		return Decode(reader, snapshot);
+	}
+
+	void SnapshotReceiver::Reset() {
+		for (Snapshot& snapshot : m_history)
+			snapshot.Reset(nullptr, 0);
+		m_latest = Snapshot::NONE;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "zore/math/vector.hpp"
+#include "zore/utils/sized_integer.hpp"
+#include <vector>
+#include <array>
+
+namespace zore::net {
+
+	class Packet;
+	class BitWriter;
+	class BitReader;
+
+	//========================================================================
+	//	Snapshot Schema
+	//========================================================================
+
+	// Describes the fields every entity in a snapshot has, and the range each one is quantized to
+	class SnapshotSchema {
+	public:
+		using FieldID = uint32_t;
+
+		enum class Type { BOOL, INTEGER, FLOAT };
+
+		struct Field {
+			Type type;
+			// Integers are stored as value - offset, and floats as a step between min and max
+			int32_t offset;
+			float min;
+			float max;
+			uint32_t steps;
+			uint32_t bits;
+		};
+
+	public:
+		FieldID AddBool();
+		FieldID AddInteger(int32_t min, int32_t max);
+		FieldID AddFloat(float min, float max, float precision);
+		// Adds three float fields, and returns the first
+		FieldID AddVector(float min, float max, float precision);
+
+		size_t GetFieldCount() const { return m_fields.size(); }
+		const Field& GetField(FieldID field) const { return m_fields[field]; }
+
+	private:
+		std::vector<Field> m_fields;
+	};
+
+	//========================================================================
+	//	Snapshot
+	//========================================================================
+
+	// The state of every entity at one tick. Fields are kept quantized, so that comparing against a baseline sees exactly the
+	// values a receiver decodes, and noise below a field's precision is never resent
+	class Snapshot {
+	public:
+		static constexpr uint32_t NONE = static_cast<uint32_t>(-1);
+
+	public:
+		Snapshot(const SnapshotSchema* schema = nullptr, uint32_t tick = 0);
+
+		void Reset(const SnapshotSchema* schema, uint32_t tick);
+		bool IsValid() const { return m_schema != nullptr; }
+		uint32_t GetTick() const { return m_tick; }
+
+		// Entities must be added in increasing id order. Returns the entity's index within the snapshot
+		uint32_t Add(uint32_t id);
+		// Returns the index of the entity, or NONE if the snapshot does not hold it
+		uint32_t Find(uint32_t id) const;
+		size_t GetEntityCount() const { return m_ids.size(); }
+		uint32_t GetID(uint32_t index) const { return m_ids[index]; }
+
+		void SetBool(uint32_t index, SnapshotSchema::FieldID field, bool value);
+		void SetInteger(uint32_t index, SnapshotSchema::FieldID field, int32_t value);
+		void SetFloat(uint32_t index, SnapshotSchema::FieldID field, float value);
+		void SetVector(uint32_t index, SnapshotSchema::FieldID field, const zm::vec3& value);
+		bool GetBool(uint32_t index, SnapshotSchema::FieldID field) const;
+		int32_t GetInteger(uint32_t index, SnapshotSchema::FieldID field) const;
+		float GetFloat(uint32_t index, SnapshotSchema::FieldID field) const;
+		zm::vec3 GetVector(uint32_t index, SnapshotSchema::FieldID field) const;
+
+		// Writes every entity, with fields unchanged since the baseline reduced to a single bit. Entities missing from the
+		// baseline are written in full, and a null baseline writes a full snapshot. The tick and baseline used are left to the
+		// caller, as the reader needs them to find the baseline before decoding
+		void Encode(const Snapshot* baseline, BitWriter& writer) const;
+		// Reads entities written by Encode against the same baseline. Returns false if the data is corrupt
+		bool Decode(const Snapshot* baseline, BitReader& reader);
+
+	private:
+		uint32_t& Value(uint32_t index, SnapshotSchema::FieldID field) { return m_values[index * m_schema->GetFieldCount() + field]; }
+		uint32_t Value(uint32_t index, SnapshotSchema::FieldID field) const { return m_values[index * m_schema->GetFieldCount() + field]; }
+
+	private:
+		const SnapshotSchema* m_schema;
+		uint32_t m_tick;
+		std::vector<uint32_t> m_ids;
+		// Quantized field values, field count per entity
+		std::vector<uint32_t> m_values;
+	};
+
+	//========================================================================
+	//	Snapshot Sender
+	//========================================================================
+
+	// Keeps the snapshots recently sent to one client, and encodes each new snapshot against the newest one the client has
+	// acknowledged. Without an acknowledged snapshot still in the history, a full snapshot is sent instead
+	class SnapshotSender {
+	public:
+		static constexpr uint32_t HISTORY_SIZE = 32;
+
+		struct Stats {
+			uint64_t bytes = 0;
+			uint32_t last_bytes = 0;
+			uint32_t full_snapshots = 0;
+			uint32_t delta_snapshots = 0;
+		};
+
+	public:
+		void Encode(const Snapshot& snapshot, BitWriter& writer);
+		void Encode(const Snapshot& snapshot, Packet& packet);
+		void Acknowledge(uint32_t tick);
+		void Reset();
+
+		const Stats& GetStats() const { return m_stats; }
+
+	private:
+		std::array<Snapshot, HISTORY_SIZE> m_history;
+		uint32_t m_acknowledged = Snapshot::NONE;
+		Stats m_stats;
+	};
+
+	//========================================================================
+	//	Snapshot Receiver
+	//========================================================================
+
+	// Keeps recently received snapshots as baselines for the deltas that follow. The tick of the newest snapshot received is the
+	// one to acknowledge back to the sender
+	class SnapshotReceiver {
+	public:
+		explicit SnapshotReceiver(const SnapshotSchema& schema) : m_schema(&schema) {}
+
+		// Returns false if the snapshot is older than the latest one, its baseline is no longer known, or the data is corrupt.
+		// Snapshot is left untouched when decoding fails
+		bool Decode(BitReader& reader, Snapshot& snapshot);
+		bool Decode(Packet& packet, Snapshot& snapshot);
+		void Reset();
+
+		uint32_t GetLatestTick() const { return m_latest; }
+
+	private:
+		const SnapshotSchema* m_schema;
+		std::array<Snapshot, SnapshotSender::HISTORY_SIZE> m_history;
+		uint32_t m_latest = Snapshot::NONE;
+	};
+}
\ No newline at end of file
@@ -11,6 +11,20 @@ namespace zore::net {
 
 	AbstractSocket::AbstractSocket(socket_t socket_id, bool blocking) : m_socket_id(socket_id), m_blocking(blocking) {}
 
+	AbstractSocket::AbstractSocket(AbstractSocket&& other) noexcept : m_socket_id(other.m_socket_id), m_blocking(other.m_blocking) {
+		other.m_socket_id = INVALID_SOCKET;
+	}
+
+	AbstractSocket& AbstractSocket::operator=(AbstractSocket&& other) noexcept {
+		if (this != &other) {
+			Close();
+			m_socket_id = other.m_socket_id;
+			m_blocking = other.m_blocking;
+			other.m_socket_id = INVALID_SOCKET;
+		}
+		return *this;
+	}
+
 	AbstractSocket::~AbstractSocket() {
 		Close();
 	}
@@ -49,6 +63,10 @@ namespace zore::net {
 		}
 	}
 
+	bool AbstractSocket::IsOpen() const {
+		return m_socket_id != INVALID_SOCKET;
+	}
+
 	//========================================================================
 	//	Connection Socket
 	//========================================================================
@@ -84,7 +102,7 @@ namespace zore::net {
 
 	Address Socket::GetSelfAddress() const {
 		sockaddr_in address;
-		int address_size = sizeof(address);
+		socklen_t address_size = sizeof(address);
 		if (getsockname(m_socket_id, reinterpret_cast<sockaddr*>(&address), &address_size) == SOCKET_ERROR) {
 			Logger::Error(GetLastError("getsockname"));
 			return Address(nullptr);
@@ -94,7 +112,7 @@ namespace zore::net {
 
 	Address Socket::GetPeerAddress() const {
 		sockaddr_in address;
-		int address_size = sizeof(address);
+		socklen_t address_size = sizeof(address);
 		if (getpeername(m_socket_id, reinterpret_cast<sockaddr*>(&address), &address_size) == SOCKET_ERROR) {
 			Logger::Error(GetLastError("getpeername"));
 			return Address(nullptr);
@@ -203,23 +221,31 @@ namespace zore::net {
 			Logger::Error(GetLastError("bind"));
 			return;
 		}
-		if (listen(m_socket_id, 10) == -1) {
+		if (listen(m_socket_id, SOMAXCONN) == -1) {
 			Logger::Error(GetLastError("listen"));
 			return;
 		}
+		SetBlocking(m_blocking);
 		Logger::Info("Socket listening on port: " + std::to_string(port));
 	}
 
 	void Listener::AcceptConnections(std::vector<Socket>& connections) {
-		sockaddr_storage address_storage;
-		socklen_t address_size = sizeof(address_storage);
-		sockaddr* address_storage_ptr = reinterpret_cast<sockaddr*>(&address_storage);
-		int new_socket_id = static_cast<int>(accept(m_socket_id, address_storage_ptr, &address_size));
-
-		//if (new_socket_id == INVALID_SOCKET)
-		//	Logger::Error(GetLastError("accept"));
-		//else
-		//	connections.emplace_back(new_socket_id, nullptr);
+		if (m_socket_id == INVALID_SOCKET)
+			return;
+		// Blocking listeners wait for a single connection, and non blocking ones take every connection already queued
+		while (true) {
+			sockaddr_storage address_storage;
+			socklen_t address_size = sizeof(address_storage);
+			socket_t new_socket_id = accept(m_socket_id, reinterpret_cast<sockaddr*>(&address_storage), &address_size);
+			if (new_socket_id == INVALID_SOCKET) {
+				if (!WouldBlock())
+					Logger::Error(GetLastError("accept"));
+				return;
+			}
+			connections.emplace_back(new_socket_id, Protocol::TCP, m_blocking);
+			if (m_blocking)
+				return;
+		}
 	}
 }
 
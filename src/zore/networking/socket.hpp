@@ -13,11 +13,18 @@ namespace zore::net {
 
 	class AbstractSocket {
 	public:
+		AbstractSocket(const AbstractSocket&) = delete;
+		AbstractSocket& operator=(const AbstractSocket&) = delete;
+
 		void SetBlocking(bool blocking);
 		void Close();
+		bool IsOpen() const;
+		socket_t GetHandle() const { return m_socket_id; }
 
 	protected:
 		AbstractSocket(socket_t socket_id, bool blocking = true);
+		AbstractSocket(AbstractSocket&& other) noexcept;
+		AbstractSocket& operator=(AbstractSocket&& other) noexcept;
 		virtual ~AbstractSocket();
 
 	protected:
@@ -42,6 +49,8 @@ namespace zore::net {
         Socket(Protocol protocol, bool blocking = false);
 		Socket(const Address& address, Protocol protocol, bool blocking = false);
 		Socket(socket_t socket_id, Protocol protocol, bool blocking = false);
+		Socket(Socket&&) noexcept = default;
+		Socket& operator=(Socket&&) noexcept = default;
 		~Socket();
 
 		Address GetSelfAddress() const;
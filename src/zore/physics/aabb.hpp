@@ -1,15 +1,155 @@
 #pragma once
 
 #include "zore/math/vector.hpp"
+#include <limits>
 
 namespace zore {
 
+	//========================================================================
+	//	Axis Aligned Bounding Box
+	//========================================================================
+
 	template <typename TYPE, int DIMS>
 	class AABB {
 	public:
+		using vec = zm::vec_base<TYPE, DIMS>;
+
+	public:
+		AABB() = default;
+		AABB(const vec& min, const vec& max) : m_min(min), m_max(max) {}
+		~AABB() = default;
+
+		static AABB FromCenter(const vec& center, const vec& extents) { return AABB(center - extents, center + extents); }
+		// An inverted box, which any merge or expansion will replace entirely
+		static AABB Empty() { return AABB(vec(std::numeric_limits<TYPE>::max()), vec(std::numeric_limits<TYPE>::lowest())); }
+
+		const vec& GetMin() const { return m_min; }
+		const vec& GetMax() const { return m_max; }
+		vec GetCenter() const { return (m_min + m_max) / vec(TYPE(2)); }
+		vec GetSize() const { return m_max - m_min; }
+		vec GetExtents() const { return (m_max - m_min) / vec(TYPE(2)); }
+
+		bool IsValid() const {
+			for (int i = 0; i < DIMS; i++)
+				if (m_min[i] > m_max[i])
+					return false;
+			return true;
+		}
+
+		AABB Merge(const AABB& other) const {
+			AABB result;
+			for (int i = 0; i < DIMS; i++) {
+				result.m_min[i] = zm::Min(m_min[i], other.m_min[i]);
+				result.m_max[i] = zm::Max(m_max[i], other.m_max[i]);
+			}
+			return result;
+		}
+
+		AABB& Expand(const vec& point) {
+			for (int i = 0; i < DIMS; i++) {
+				m_min[i] = zm::Min(m_min[i], point[i]);
+				m_max[i] = zm::Max(m_max[i], point[i]);
+			}
+			return *this;
+		}
+
+		AABB& Expand(const AABB& other) {
+			return *this = Merge(other);
+		}
+
+		// Grows the box by {amount} on every side. Negative amounts shrink it
+		AABB& Grow(TYPE amount) {
+			m_min -= vec(amount);
+			m_max += vec(amount);
+			return *this;
+		}
+
+		bool Contains(const vec& point) const {
+			for (int i = 0; i < DIMS; i++)
+				if (point[i] < m_min[i] || point[i] > m_max[i])
+					return false;
+			return true;
+		}
+
+		bool Contains(const AABB& other) const {
+			for (int i = 0; i < DIMS; i++)
+				if (other.m_min[i] < m_min[i] || other.m_max[i] > m_max[i])
+					return false;
+			return true;
+		}
+
+		bool Overlaps(const AABB& other) const {
+			for (int i = 0; i < DIMS; i++)
+				if (other.m_max[i] < m_min[i] || other.m_min[i] > m_max[i])
+					return false;
+			return true;
+		}
+
+		TYPE Volume() const {
+			TYPE result = TYPE(1);
+			for (int i = 0; i < DIMS; i++)
+				result *= m_max[i] - m_min[i];
+			return result;
+		}
+
+		// Returns the surface area of a 3D box, or the perimeter of a 2D box, as used by surface area heuristics
+		TYPE SurfaceArea() const requires (DIMS == 2 || DIMS == 3) {
+			vec size = m_max - m_min;
+			if constexpr (DIMS == 2)
+				return TYPE(2) * (size[0] + size[1]);
+			else
+				return TYPE(2) * (size[0] * size[1] + size[1] * size[2] + size[2] * size[0]);
+		}
+
+		// Slab test against a ray given by its origin and reciprocal direction. On a hit, t receives the entry distance,
+		// clamped to tMin when the origin lies inside the box
+		bool Raycast(const vec& origin, const vec& invDirection, TYPE tMin, TYPE tMax, TYPE& t) const requires std::floating_point<TYPE> {
+			for (int i = 0; i < DIMS; i++) {
+				TYPE t1 = (m_min[i] - origin[i]) * invDirection[i];
+				TYPE t2 = (m_max[i] - origin[i]) * invDirection[i];
+				tMin = zm::Max(tMin, zm::Min(t1, t2));
+				tMax = zm::Min(tMax, zm::Max(t1, t2));
+			}
+			t = tMin;
+			return tMin <= tMax;
+		}
+
+		// Sweeps this box by {displacement} against other. On a hit, t receives the fraction of the displacement covered before the
+		// boxes touch, and normal the face of other that was hit. Boxes that already overlap are not reported
+		bool Sweep(const AABB& other, const vec& displacement, TYPE& t, vec& normal) const requires std::floating_point<TYPE> {
+			TYPE t_enter = TYPE(0), t_exit = TYPE(1);
+			int axis = -1;
+			for (int i = 0; i < DIMS; i++) {
+				if (displacement[i] == TYPE(0)) {
+					if (m_max[i] <= other.m_min[i] || m_min[i] >= other.m_max[i])
+						return false;
+					continue;
+				}
+				TYPE inv = TYPE(1) / displacement[i];
+				TYPE t1 = (other.m_min[i] - m_max[i]) * inv;
+				TYPE t2 = (other.m_max[i] - m_min[i]) * inv;
+				TYPE entry = zm::Min(t1, t2);
+				if (entry >= t_enter) {
+					t_enter = entry;
+					axis = i;
+				}
+				t_exit = zm::Min(t_exit, zm::Max(t1, t2));
+				if (t_enter >= t_exit)
+					return false;
+			}
+			if (axis < 0)
+				return false;
+			t = t_enter;
+			normal = vec(TYPE(0));
+			normal[axis] = displacement[axis] > TYPE(0) ? TYPE(-1) : TYPE(1);
+			return true;
+		}
 
 	private:
-		zm::vec_base <TYPE, DIMS> min;
-		zm::vec_base <TYPE, DIMS> max;
+		vec m_min;
+		vec m_max;
 	};
+
+	typedef AABB<float, 2> AABB2D;
+	typedef AABB<float, 3> AABB3D;
 }
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "zore/physics/aabb_batch.hpp"
+#include "zore/math/simd.hpp"
+#include "zore/debug.hpp"
+#include <bit>
+
+namespace zore {
+
+	//========================================================================
+	//	AABB Batch
+	//========================================================================
+
+	// Masks out the padding lanes of the last group, as inverted boxes still pass the ray slab test
+	static inline uint32_t ValidLanes(size_t i, size_t count) {
+		return count - i >= 4 ? 0xF : (1u << (count - i)) - 1u;
+	}
+
+	uint32_t AABBBatch::Add(const AABB3D& box) {
+		if (m_count % 4 == 0) {
+			AABB3D empty = AABB3D::Empty();
+			for (int i = 0; i < 3; i++) {
+				m_bounds[MIN_X + i].resize(m_count + 4, empty.GetMin()[i]);
+				m_bounds[MAX_X + i].resize(m_count + 4, empty.GetMax()[i]);
+			}
+		}
+		Set(static_cast<uint32_t>(m_count), box);
+		return static_cast<uint32_t>(m_count++);
+	}
+
+	void AABBBatch::Set(uint32_t index, const AABB3D& box) {
+		DEBUG_ENSURE(index < m_bounds[0].size(), "AABB batch index out of range");
+		for (int i = 0; i < 3; i++) {
+			m_bounds[MIN_X + i][index] = box.GetMin()[i];
+			m_bounds[MAX_X + i][index] = box.GetMax()[i];
+		}
+	}
+
+	AABB3D AABBBatch::Get(uint32_t index) const {
+		DEBUG_ENSURE(index < m_count, "AABB batch index out of range");
+		return AABB3D(
+			{ m_bounds[MIN_X][index], m_bounds[MIN_Y][index], m_bounds[MIN_Z][index] },
+			{ m_bounds[MAX_X][index], m_bounds[MAX_Y][index], m_bounds[MAX_Z][index] }
+		);
+	}
+
+	void AABBBatch::Reserve(size_t count) {
+		for (std::vector<float>& bounds : m_bounds)
+			bounds.reserve((count + 3) & ~size_t(3));
+	}
+
+	void AABBBatch::Clear() {
+		for (std::vector<float>& bounds : m_bounds)
+			bounds.clear();
+		m_count = 0;
+	}
+
+	void AABBBatch::Overlaps(const AABB3D& box, std::vector<uint32_t>& out) const {
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		const size_t padded = m_bounds[0].size();
+		using float4 = zm::simd<float, 4>;
+		const float4 min_x(box.GetMin().x), min_y(box.GetMin().y), min_z(box.GetMin().z);
+		const float4 max_x(box.GetMax().x), max_y(box.GetMax().y), max_z(box.GetMax().z);
+		for (size_t i = 0; i < padded; i += 4) {
+			float4 hit = (float4(&m_bounds[MIN_X][i]) <= max_x) & (float4(&m_bounds[MAX_X][i]) >= min_x);
+			hit &= (float4(&m_bounds[MIN_Y][i]) <= max_y) & (float4(&m_bounds[MAX_Y][i]) >= min_y);
+			hit &= (float4(&m_bounds[MIN_Z][i]) <= max_z) & (float4(&m_bounds[MAX_Z][i]) >= min_z);
+			for (uint32_t bits = zm::mask(hit); bits; bits &= bits - 1)
+				out.push_back(static_cast<uint32_t>(i) + std::countr_zero(bits));
+		}
+#else
+		for (size_t i = 0; i < m_count; i++)
+			if (Get(static_cast<uint32_t>(i)).Overlaps(box))
+				out.push_back(static_cast<uint32_t>(i));
+#endif
+	}
+
+	void AABBBatch::Raycast(const zm::vec3& origin, const zm::vec3& direction, float maxDistance, std::vector<RayHit>& out) const {
+		const zm::vec3 inv = zm::vec3(1.f) / direction;
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		const size_t padded = m_bounds[0].size();
+		using float4 = zm::simd<float, 4>;
+		const float4 ox(origin.x), oy(origin.y), oz(origin.z);
+		const float4 ix(inv.x), iy(inv.y), iz(inv.z);
+		const float4 zero(0.f), limit(maxDistance);
+		alignas(16) float distances[4];
+		for (size_t i = 0; i < padded; i += 4) {
+			float4 t1 = (float4(&m_bounds[MIN_X][i]) - ox) * ix, t2 = (float4(&m_bounds[MAX_X][i]) - ox) * ix;
+			float4 t_enter = zm::max(zero, zm::min(t1, t2)), t_exit = zm::min(limit, zm::max(t1, t2));
+			t1 = (float4(&m_bounds[MIN_Y][i]) - oy) * iy, t2 = (float4(&m_bounds[MAX_Y][i]) - oy) * iy;
+			t_enter = zm::max(t_enter, zm::min(t1, t2)), t_exit = zm::min(t_exit, zm::max(t1, t2));
+			t1 = (float4(&m_bounds[MIN_Z][i]) - oz) * iz, t2 = (float4(&m_bounds[MAX_Z][i]) - oz) * iz;
+			t_enter = zm::max(t_enter, zm::min(t1, t2)), t_exit = zm::min(t_exit, zm::max(t1, t2));
+
+			uint32_t bits = zm::mask(t_enter <= t_exit) & ValidLanes(i, m_count);
+			if (!bits)
+				continue;
+			t_enter.unload_aligned(distances);
+			for (; bits; bits &= bits - 1) {
+				uint32_t lane = std::countr_zero(bits);
+				out.push_back({ static_cast<uint32_t>(i) + lane, distances[lane] });
+			}
+		}
+#else
+		for (size_t i = 0; i < m_count; i++) {
+			float t;
+			if (Get(static_cast<uint32_t>(i)).Raycast(origin, inv, 0.f, maxDistance, t))
+				out.push_back({ static_cast<uint32_t>(i), t });
+		}
+#endif
+	}
+
+	bool AABBBatch::RaycastClosest(const zm::vec3& origin, const zm::vec3& direction, float maxDistance, RayHit& hit) const {
+		const zm::vec3 inv = zm::vec3(1.f) / direction;
+		bool found = false;
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		const size_t padded = m_bounds[0].size();
+		using float4 = zm::simd<float, 4>;
+		const float4 ox(origin.x), oy(origin.y), oz(origin.z);
+		const float4 ix(inv.x), iy(inv.y), iz(inv.z);
+		const float4 zero(0.f);
+		float4 limit(maxDistance);
+		alignas(16) float distances[4];
+		for (size_t i = 0; i < padded; i += 4) {
+			float4 t1 = (float4(&m_bounds[MIN_X][i]) - ox) * ix, t2 = (float4(&m_bounds[MAX_X][i]) - ox) * ix;
+			float4 t_enter = zm::max(zero, zm::min(t1, t2)), t_exit = zm::min(limit, zm::max(t1, t2));
+			t1 = (float4(&m_bounds[MIN_Y][i]) - oy) * iy, t2 = (float4(&m_bounds[MAX_Y][i]) - oy) * iy;
+			t_enter = zm::max(t_enter, zm::min(t1, t2)), t_exit = zm::min(t_exit, zm::max(t1, t2));
+			t1 = (float4(&m_bounds[MIN_Z][i]) - oz) * iz, t2 = (float4(&m_bounds[MAX_Z][i]) - oz) * iz;
+			t_enter = zm::max(t_enter, zm::min(t1, t2)), t_exit = zm::min(t_exit, zm::max(t1, t2));
+
+			uint32_t bits = zm::mask(t_enter <= t_exit) & ValidLanes(i, m_count);
+			if (!bits)
+				continue;
+			t_enter.unload_aligned(distances);
+			for (; bits; bits &= bits - 1) {
+				uint32_t lane = std::countr_zero(bits);
+				if (!found || distances[lane] < hit.distance) {
+					hit = { static_cast<uint32_t>(i) + lane, distances[lane] };
+					found = true;
+				}
+			}
+			// Later boxes only need to beat the closest hit so far
+			limit = float4(hit.distance);
+		}
+#else
+		for (size_t i = 0; i < m_count; i++) {
+			float t;
+			if (Get(static_cast<uint32_t>(i)).Raycast(origin, inv, 0.f, found ? hit.distance : maxDistance, t)) {
+				hit = { static_cast<uint32_t>(i), t };
+				found = true;
+			}
+		}
+#endif
+		return found;
+	}
+}
\ No newline at end of file
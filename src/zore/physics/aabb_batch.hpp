@@ -0,0 +1,47 @@
+#pragma once
+
+#include "zore/physics/aabb.hpp"
+#include <vector>
+
+namespace zore {
+
+	//========================================================================
+	//	AABB Batch
+	//========================================================================
+
+	// Stores 3D boxes as separate min/max arrays per axis, so that a single box or ray can be tested against four boxes per SIMD lane
+	class AABBBatch {
+	public:
+		struct RayHit {
+			uint32_t index;
+			float distance;
+		};
+
+	public:
+		AABBBatch() = default;
+		~AABBBatch() = default;
+
+		uint32_t Add(const AABB3D& box);
+		void Set(uint32_t index, const AABB3D& box);
+		AABB3D Get(uint32_t index) const;
+		void Reserve(size_t count);
+		void Clear();
+		size_t Size() const { return m_count; }
+
+		// Appends the index of every stored box that overlaps box to out
+		void Overlaps(const AABB3D& box, std::vector<uint32_t>& out) const;
+
+		// Appends every box hit by the ray within {maxDistance} to out, in storage order. direction does not need to be normalized,
+		// in which case distances are measured in multiples of its length
+		void Raycast(const zm::vec3& origin, const zm::vec3& direction, float maxDistance, std::vector<RayHit>& out) const;
+		bool RaycastClosest(const zm::vec3& origin, const zm::vec3& direction, float maxDistance, RayHit& hit) const;
+
+	private:
+		enum Bound { MIN_X, MIN_Y, MIN_Z, MAX_X, MAX_Y, MAX_Z };
+
+	private:
+		// Padded to a multiple of 4 with empty boxes, which never pass an overlap test
+		std::vector<float> m_bounds[6];
+		size_t m_count = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include "zore/physics/dynamic_tree.hpp"
+#include "zore/debug/profiler.hpp"
+
+namespace zore {
+
+	//========================================================================
+	//	Dynamic AABB Tree
+	//========================================================================
+
+	DynamicTree::DynamicTree(float margin) : m_root(NULL_NODE), m_proxy_count(0), m_margin(margin) {}
+
+	int32_t DynamicTree::CreateProxy(const AABB3D& box, uint64_t data) {
+		int32_t proxy = AllocateNode();
+		Node& node = m_nodes[proxy];
+		node.box = AABB3D(box).Grow(m_margin);
+		node.data = data;
+		node.moved = true;
+		InsertLeaf(proxy);
+		m_moved.push_back(proxy);
+		m_proxy_count++;
+		return proxy;
+	}
+
+	void DynamicTree::DestroyProxy(int32_t proxy) {
+		DEBUG_ENSURE(m_nodes[proxy].IsLeaf(), "Dynamic tree proxy is not a leaf");
+		if (m_nodes[proxy].moved) {
+			for (int32_t& moved : m_moved)
+				if (moved == proxy)
+					moved = NULL_NODE;
+		}
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		m_proxy_count--;
+	}
+
+	bool DynamicTree::MoveProxy(int32_t proxy, const AABB3D& box, const zm::vec3& displacement) {
+		DEBUG_ENSURE(m_nodes[proxy].IsLeaf(), "Dynamic tree proxy is not a leaf");
+		zm::vec3 d = displacement * DISPLACEMENT_MULTIPLIER;
+		AABB3D fat_box = AABB3D(box).Grow(m_margin);
+		fat_box = fat_box.Merge(AABB3D(fat_box.GetMin() + d, fat_box.GetMax() + d));
+
+		const AABB3D& tree_box = m_nodes[proxy].box;
+		if (tree_box.Contains(box)) {
+			// Keep the existing fat box, unless it has grown far larger than needed since the proxy slowed down
+			AABB3D huge_box = AABB3D(fat_box).Grow(m_margin * DISPLACEMENT_MULTIPLIER);
+			if (huge_box.Contains(tree_box))
+				return false;
+		}
+
+		RemoveLeaf(proxy);
+		m_nodes[proxy].box = fat_box;
+		InsertLeaf(proxy);
+		if (!m_nodes[proxy].moved) {
+			m_nodes[proxy].moved = true;
+			m_moved.push_back(proxy);
+		}
+		return true;
+	}
+
+	void DynamicTree::FindPairs(std::vector<Pair>& pairs) {
+		ZoneScoped;
+		for (int32_t proxy : m_moved) {
+			if (proxy == NULL_NODE)
+				continue;
+			const AABB3D& box = m_nodes[proxy].box;
+			Query(box, [&](int32_t other) {
+				// Pairs of two moved proxies are only reported from the lower proxy
+				if (other == proxy || (m_nodes[other].moved && other < proxy))
+					return true;
+				pairs.emplace_back(zm::Min(proxy, other), zm::Max(proxy, other));
+				return true;
+			});
+		}
+		for (int32_t proxy : m_moved)
+			if (proxy != NULL_NODE)
+				m_nodes[proxy].moved = false;
+		m_moved.clear();
+	}
+
+	void DynamicTree::RaycastBatch(const RayBatch& rays, RayHits& hits) const {
+		ZoneScoped;
+		hits.Reset(rays.Size());
+		RaycastBatch(rays, [&hits](uint32_t ray, int32_t proxy, float distance) {
+			if (distance < hits.distance[ray]) {
+				hits.distance[ray] = distance;
+				hits.id[ray] = proxy;
+			}
+			return hits.distance[ray];
+		});
+	}
+
+	int32_t DynamicTree::AllocateNode() {
+		return m_nodes.acquire();
+	}
+
+	void DynamicTree::FreeNode(int32_t node) {
+		m_nodes[node].height = -1;
+		m_nodes.release(node);
+	}
+
+	void DynamicTree::InsertLeaf(int32_t leaf) {
+		if (m_root == NULL_NODE) {
+			m_root = leaf;
+			m_nodes[leaf].parent = NULL_NODE;
+			return;
+		}
+
+		// Descend towards the sibling that minimizes the surface area added to the tree
+		const AABB3D leaf_box = m_nodes[leaf].box;
+		int32_t index = m_root;
+		while (!m_nodes[index].IsLeaf()) {
+			const Node& node = m_nodes[index];
+			float area = node.box.SurfaceArea();
+			float combined_area = node.box.Merge(leaf_box).SurfaceArea();
+
+			// Cost of creating a new parent for this node and the leaf, and the cost of pushing the leaf further down
+			float cost = 2.f * combined_area;
+			float inheritance_cost = 2.f * (combined_area - area);
+
+			auto descend_cost = [&](int32_t child) {
+				const Node& c = m_nodes[child];
+				float merged = leaf_box.Merge(c.box).SurfaceArea();
+				return (c.IsLeaf() ? merged : merged - c.box.SurfaceArea()) + inheritance_cost;
+			};
+			float cost1 = descend_cost(node.child1);
+			float cost2 = descend_cost(node.child2);
+
+			if (cost < cost1 && cost < cost2)
+				break;
+			index = cost1 < cost2 ? node.child1 : node.child2;
+		}
+
+		int32_t sibling = index;
+		int32_t old_parent = m_nodes[sibling].parent;
+		int32_t new_parent = AllocateNode();
+		Node& parent = m_nodes[new_parent];
+		parent.parent = old_parent;
+		parent.box = leaf_box.Merge(m_nodes[sibling].box);
+		parent.height = m_nodes[sibling].height + 1;
+		parent.child1 = sibling;
+		parent.child2 = leaf;
+		m_nodes[sibling].parent = new_parent;
+		m_nodes[leaf].parent = new_parent;
+
+		if (old_parent == NULL_NODE)
+			m_root = new_parent;
+		else if (m_nodes[old_parent].child1 == sibling)
+			m_nodes[old_parent].child1 = new_parent;
+		else
+			m_nodes[old_parent].child2 = new_parent;
+
+		Refit(new_parent);
+	}
+
+	void DynamicTree::RemoveLeaf(int32_t leaf) {
+		if (leaf == m_root) {
+			m_root = NULL_NODE;
+			return;
+		}
+
+		int32_t parent = m_nodes[leaf].parent;
+		int32_t grand_parent = m_nodes[parent].parent;
+		int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+		FreeNode(parent);
+
+		m_nodes[sibling].parent = grand_parent;
+		if (grand_parent == NULL_NODE) {
+			m_root = sibling;
+			return;
+		}
+		if (m_nodes[grand_parent].child1 == parent)
+			m_nodes[grand_parent].child1 = sibling;
+		else
+			m_nodes[grand_parent].child2 = sibling;
+		Refit(grand_parent);
+	}
+
+	void DynamicTree::Refit(int32_t node) {
+		// Walk back to the root, rebalancing and refitting every ancestor
+		while (node != NULL_NODE) {
+			node = Balance(node);
+			Node& n = m_nodes[node];
+			const Node& c1 = m_nodes[n.child1];
+			const Node& c2 = m_nodes[n.child2];
+			n.height = 1 + zm::Max(c1.height, c2.height);
+			n.box = c1.box.Merge(c2.box);
+			node = n.parent;
+		}
+	}
+
+	int32_t DynamicTree::Balance(int32_t a) {
+		Node& A = m_nodes[a];
+		if (A.IsLeaf() || A.height < 2)
+			return a;
+
+		int32_t b = A.child1;
+		int32_t c = A.child2;
+		Node& B = m_nodes[b];
+		Node& C = m_nodes[c];
+		int32_t balance = C.height - B.height;
+
+		// Rotates the taller child up into the place of A, which then adopts the shorter of its two children
+		auto rotate = [&](int32_t up, Node& U, int32_t& a_slot, Node& K) {
+			int32_t f = U.child1;
+			int32_t g = U.child2;
+			Node& F = m_nodes[f];
+			Node& G = m_nodes[g];
+
+			U.child1 = a;
+			U.parent = A.parent;
+			A.parent = up;
+			if (U.parent == NULL_NODE)
+				m_root = up;
+			else if (m_nodes[U.parent].child1 == a)
+				m_nodes[U.parent].child1 = up;
+			else
+				m_nodes[U.parent].child2 = up;
+
+			int32_t higher = F.height > G.height ? f : g;
+			int32_t lower = F.height > G.height ? g : f;
+			Node& T = m_nodes[higher];
+			Node& S = m_nodes[lower];
+			U.child2 = higher;
+			a_slot = lower;
+			S.parent = a;
+			A.box = K.box.Merge(S.box);
+			U.box = A.box.Merge(T.box);
+			A.height = 1 + zm::Max(K.height, S.height);
+			U.height = 1 + zm::Max(A.height, T.height);
+			return up;
+		};
+
+		if (balance > 1)
+			return rotate(c, C, A.child2, B);
+		if (balance < -1)
+			return rotate(b, B, A.child1, C);
+		return a;
+	}
+}
\ No newline at end of file
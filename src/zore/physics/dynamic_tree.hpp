@@ -0,0 +1,252 @@
+#pragma once
+
+#include "zore/physics/aabb.hpp"
+#include "zore/physics/ray_batch.hpp"
+#include "zore/math/simd.hpp"
+#include "zore/structures/object_pool.hpp"
+#include "zore/core/camera.hpp"
+#include "zore/debug.hpp"
+#include <vector>
+#include <utility>
+#include <bit>
+
+namespace zore {
+
+	//========================================================================
+	//	Dynamic AABB Tree
+	//========================================================================
+
+	// A bounding volume hierarchy over fattened proxy boxes. Proxies only need to be reinserted once they escape their fat box,
+	// and the tree is kept balanced with rotations as leaves are inserted and removed
+	class DynamicTree {
+	public:
+		static constexpr int32_t NULL_NODE = -1;
+		static constexpr float DEFAULT_MARGIN = 0.1f;
+		// Fat boxes are extended along the displacement of a move by this factor, to anticipate further motion
+		static constexpr float DISPLACEMENT_MULTIPLIER = 4.f;
+		static constexpr int32_t STACK_SIZE = 128;
+
+		using Pair = std::pair<int32_t, int32_t>;
+
+	private:
+		struct Node {
+			AABB3D box;
+			uint64_t data = 0;
+			int32_t parent = NULL_NODE;
+			int32_t child1 = NULL_NODE;
+			int32_t child2 = NULL_NODE;
+			int32_t height = 0;
+			bool moved = false;
+
+			bool IsLeaf() const { return child1 == NULL_NODE; }
+		};
+
+	public:
+		DynamicTree(float margin = DEFAULT_MARGIN);
+		DynamicTree(const DynamicTree&) = delete;
+		DynamicTree& operator=(const DynamicTree&) = delete;
+		~DynamicTree() = default;
+
+		int32_t CreateProxy(const AABB3D& box, uint64_t data = 0);
+		void DestroyProxy(int32_t proxy);
+		// Returns true if the proxy had to be reinserted, in which case it will be reported by the next FindPairs call
+		bool MoveProxy(int32_t proxy, const AABB3D& box, const zm::vec3& displacement = zm::vec3(0.f));
+
+		const AABB3D& GetFatAABB(int32_t proxy) const { return m_nodes[proxy].box; }
+		uint64_t GetData(int32_t proxy) const { return m_nodes[proxy].data; }
+		int32_t GetHeight() const { return m_root == NULL_NODE ? 0 : m_nodes[m_root].height; }
+		size_t GetProxyCount() const { return m_proxy_count; }
+
+		// Appends every pair of overlapping fat boxes involving a proxy created or reinserted since the last call. Each pair is
+		// ordered as (lower proxy, higher proxy) and reported once
+		void FindPairs(std::vector<Pair>& pairs);
+
+		// Calls callback(proxy) for every proxy whose fat box overlaps box. Returning false from the callback stops the query
+		template <typename F>
+		void Query(const AABB3D& box, F&& callback) const;
+
+		// Calls callback(proxy) for every proxy whose fat box passes the camera's frustum test
+		template <typename F>
+		void QueryFrustum(const Camera3D& camera, F&& callback) const;
+
+		// Calls callback(proxy, distance) for every proxy whose fat box is hit by the ray, nearest subtrees first. The callback
+		// returns the new maximum distance of the ray, so returning distance finds the closest hit and returning 0 stops the cast
+		template <typename F>
+		void Raycast(const zm::vec3& origin, const zm::vec3& direction, float max_distance, F&& callback) const;
+
+		// Casts the batch through the tree a packet of four rays at a time, calling callback(ray, proxy, distance) for every fat box
+		// hit. Hits come in no particular order, and the callback returns the new maximum distance of that ray as in Raycast
+		template <typename F>
+		void RaycastBatch(const RayBatch& rays, F&& callback) const;
+		// Records the closest fat box hit by each ray of the batch
+		void RaycastBatch(const RayBatch& rays, RayHits& hits) const;
+
+	private:
+		int32_t AllocateNode();
+		void FreeNode(int32_t node);
+		void InsertLeaf(int32_t leaf);
+		void RemoveLeaf(int32_t leaf);
+		int32_t Balance(int32_t node);
+		void Refit(int32_t node);
+
+	private:
+		object_pool<Node, int32_t> m_nodes;
+		std::vector<int32_t> m_moved;
+		int32_t m_root;
+		size_t m_proxy_count;
+		float m_margin;
+	};
+
+	//========================================================================
+	//	Dynamic AABB Tree Queries
+	//========================================================================
+
+	template <typename F>
+	void DynamicTree::Query(const AABB3D& box, F&& callback) const {
+		int32_t stack[STACK_SIZE];
+		int32_t count = 0;
+		if (m_root != NULL_NODE)
+			stack[count++] = m_root;
+
+		while (count > 0) {
+			int32_t index = stack[--count];
+			const Node& node = m_nodes[index];
+			if (!node.box.Overlaps(box))
+				continue;
+			if (node.IsLeaf()) {
+				if (!callback(index))
+					return;
+				continue;
+			}
+			DEBUG_ENSURE(count + 2 <= STACK_SIZE, "Dynamic tree query stack overflow");
+			stack[count++] = node.child1;
+			stack[count++] = node.child2;
+		}
+	}
+
+	template <typename F>
+	void DynamicTree::QueryFrustum(const Camera3D& camera, F&& callback) const {
+		int32_t stack[STACK_SIZE];
+		int32_t count = 0;
+		if (m_root != NULL_NODE)
+			stack[count++] = m_root;
+
+		while (count > 0) {
+			int32_t index = stack[--count];
+			const Node& node = m_nodes[index];
+			if (!camera.TestAABB(node.box.GetMin(), node.box.GetSize()))
+				continue;
+			if (node.IsLeaf()) {
+				callback(index);
+				continue;
+			}
+			DEBUG_ENSURE(count + 2 <= STACK_SIZE, "Dynamic tree query stack overflow");
+			stack[count++] = node.child1;
+			stack[count++] = node.child2;
+		}
+	}
+
+	template <typename F>
+	void DynamicTree::Raycast(const zm::vec3& origin, const zm::vec3& direction, float max_distance, F&& callback) const {
+		const zm::vec3 inv = zm::vec3(1.f) / direction;
+		struct Entry {
+			int32_t node;
+			float distance;
+		};
+		Entry stack[STACK_SIZE];
+		int32_t count = 0;
+		float distance;
+		if (m_root != NULL_NODE && m_nodes[m_root].box.Raycast(origin, inv, 0.f, max_distance, distance))
+			stack[count++] = { m_root, distance };
+
+		while (count > 0) {
+			Entry entry = stack[--count];
+			// The ray may have been shortened since this node was pushed
+			if (entry.distance > max_distance)
+				continue;
+			const Node& node = m_nodes[entry.node];
+			if (node.IsLeaf()) {
+				max_distance = callback(entry.node, entry.distance);
+				if (max_distance <= 0.f)
+					return;
+				continue;
+			}
+
+			float d1, d2;
+			bool hit1 = m_nodes[node.child1].box.Raycast(origin, inv, 0.f, max_distance, d1);
+			bool hit2 = m_nodes[node.child2].box.Raycast(origin, inv, 0.f, max_distance, d2);
+			DEBUG_ENSURE(count + 2 <= STACK_SIZE, "Dynamic tree query stack overflow");
+			// Push the nearer child last, so that it is visited first
+			if (hit1 && hit2 && d1 < d2) {
+				stack[count++] = { node.child2, d2 };
+				stack[count++] = { node.child1, d1 };
+				continue;
+			}
+			if (hit1)
+				stack[count++] = { node.child1, d1 };
+			if (hit2)
+				stack[count++] = { node.child2, d2 };
+		}
+	}
+
+	template <typename F>
+	void DynamicTree::RaycastBatch(const RayBatch& rays, F&& callback) const {
+		if (m_root == NULL_NODE)
+			return;
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		using float4 = zm::simd<float, 4>;
+		const float4 zero(0.f);
+		alignas(16) float limits[4];
+		alignas(16) float distances[4];
+		int32_t stack[STACK_SIZE];
+
+		for (size_t i = 0; i < rays.Size(); i += RayBatch::PACKET_SIZE) {
+			const float4 ox(rays.GetOrigins(0) + i), oy(rays.GetOrigins(1) + i), oz(rays.GetOrigins(2) + i);
+			const float4 ix(rays.GetInvDirections(0) + i), iy(rays.GetInvDirections(1) + i), iz(rays.GetInvDirections(2) + i);
+			float4 limit(rays.GetMaxDistances() + i);
+			limit.unload_aligned(limits);
+			// Padding lanes are masked out, as well as rays whose callback has stopped them
+			uint32_t active = rays.Size() - i >= 4 ? 0xF : (1u << (rays.Size() - i)) - 1u;
+
+			int32_t count = 0;
+			stack[count++] = m_root;
+			while (count > 0 && active) {
+				int32_t index = stack[--count];
+				const Node& node = m_nodes[index];
+				const AABB3D& box = node.box;
+				float4 t1 = (float4(box.GetMin().x) - ox) * ix, t2 = (float4(box.GetMax().x) - ox) * ix;
+				float4 t_enter = zm::max(zero, zm::min(t1, t2)), t_exit = zm::min(limit, zm::max(t1, t2));
+				t1 = (float4(box.GetMin().y) - oy) * iy, t2 = (float4(box.GetMax().y) - oy) * iy;
+				t_enter = zm::max(t_enter, zm::min(t1, t2)), t_exit = zm::min(t_exit, zm::max(t1, t2));
+				t1 = (float4(box.GetMin().z) - oz) * iz, t2 = (float4(box.GetMax().z) - oz) * iz;
+				t_enter = zm::max(t_enter, zm::min(t1, t2)), t_exit = zm::min(t_exit, zm::max(t1, t2));
+
+				uint32_t bits = zm::mask(t_enter <= t_exit) & active;
+				if (!bits)
+					continue;
+				if (!node.IsLeaf()) {
+					DEBUG_ENSURE(count + 2 <= STACK_SIZE, "Dynamic tree query stack overflow");
+					stack[count++] = node.child2;
+					stack[count++] = node.child1;
+					continue;
+				}
+
+				t_enter.unload_aligned(distances);
+				for (; bits; bits &= bits - 1) {
+					uint32_t lane = std::countr_zero(bits);
+					limits[lane] = callback(static_cast<uint32_t>(i + lane), index, distances[lane]);
+					if (limits[lane] <= 0.f)
+						active &= ~(1u << lane);
+				}
+				limit = float4(limits);
+			}
+		}
+#else
+		for (uint32_t ray = 0; ray < rays.Size(); ray++) {
+			Raycast(rays.GetOrigin(ray), rays.GetDirection(ray), rays.GetMaxDistance(ray), [&](int32_t proxy, float distance) {
+				return callback(ray, proxy, distance);
+			});
+		}
+#endif
+	}
+}
\ No newline at end of file
@@ -0,0 +1,453 @@
+#include "zore/physics/physics_world.hpp"
+#include "zore/structures/thread_pool.hpp"
+#include "zore/math/simd.hpp"
+#include "zore/debug/profiler.hpp"
+#include "zore/debug.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace zore {
+
+	// Islands are handed to each pool job in groups of this size
+	static constexpr size_t ISLAND_GRAIN = 16;
+
+	static inline uint64_t PairKey(int32_t a, int32_t b) {
+		return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+	}
+
+	//========================================================================
+	//	Physics World
+	//========================================================================
+
+	PhysicsWorld::PhysicsWorld(float timestep, thread_pool* pool)
+		: m_timestep(timestep), m_accumulator(0.f), m_gravity(0.f, -9.81f, 0.f), m_pool(pool), m_count(0) {
+		DEBUG_ENSURE(timestep > 0.f, "Physics timestep must be positive");
+	}
+
+	PhysicsWorld::BodyID PhysicsWorld::CreateBody(const BodyDesc& desc) {
+		// Padding bodies are zeroed, which makes them static and keeps them still
+		uint32_t index = static_cast<uint32_t>(m_count);
+		if (m_count % 4 == 0)
+			for (std::vector<float>& field : m_fields)
+				field.resize(m_count + 4, 0.f);
+
+		Set(POSITION_X, index, desc.position);
+		Set(PREVIOUS_X, index, desc.position);
+		Set(VELOCITY_X, index, desc.mass > 0.f ? desc.velocity : zm::vec3(0.f));
+		Set(HALF_X, index, desc.half_extents);
+		m_fields[INV_MASS][index] = desc.mass > 0.f ? 1.f / desc.mass : 0.f;
+		m_fields[RESTITUTION][index] = desc.restitution;
+		m_fields[FRICTION][index] = desc.friction;
+
+		BodyID body = m_index.acquire(index);
+		m_bodies.push_back(body);
+		m_proxies.push_back(m_tree.CreateProxy(GetBox(index), body));
+		m_count++;
+		return body;
+	}
+
+	void PhysicsWorld::DestroyBody(BodyID body) {
+		uint32_t index = m_index[body];
+		uint32_t last = static_cast<uint32_t>(m_count - 1);
+		RemovePairs(m_proxies[index]);
+		m_tree.DestroyProxy(m_proxies[index]);
+
+		if (index != last) {
+			for (std::vector<float>& field : m_fields)
+				field[index] = field[last];
+			m_proxies[index] = m_proxies[last];
+			m_bodies[index] = m_bodies[last];
+			m_index[m_bodies[index]] = index;
+		}
+		for (std::vector<float>& field : m_fields)
+			field[last] = 0.f;
+		m_proxies.pop_back();
+		m_bodies.pop_back();
+		m_index.release(body);
+		m_count--;
+		if (m_count % 4 == 0)
+			for (std::vector<float>& field : m_fields)
+				field.resize(m_count);
+	}
+
+	float PhysicsWorld::Update(float elapsed) {
+		m_accumulator += elapsed;
+		uint32_t steps = 0;
+		while (m_accumulator >= m_timestep && steps < MAX_STEPS) {
+			Step();
+			m_accumulator -= m_timestep;
+			steps++;
+		}
+		// Time beyond the step limit is dropped, and the simulation falls behind real time instead
+		if (m_accumulator >= m_timestep)
+			m_accumulator = std::fmod(m_accumulator, m_timestep);
+		return m_accumulator / m_timestep;
+	}
+
+	void PhysicsWorld::Step() {
+		ZoneScoped;
+		const float dt = m_timestep;
+		for (int i = 0; i < 3; i++)
+			std::copy(m_fields[POSITION_X + i].begin(), m_fields[POSITION_X + i].end(), m_fields[PREVIOUS_X + i].begin());
+
+		IntegrateVelocities(dt);
+		UpdateProxies(dt);
+		FindContacts();
+		BuildIslands();
+
+		// Islands share no dynamic bodies, so they can be solved in any order and on any thread
+		uint32_t islands = static_cast<uint32_t>(GetIslandCount());
+		if (m_pool) {
+			m_pool->parallel_for(islands, ISLAND_GRAIN, [&](size_t begin, size_t end) {
+				for (size_t island = begin; island < end; island++)
+					SolveIsland(static_cast<uint32_t>(island), dt);
+			});
+		}
+		else {
+			for (uint32_t island = 0; island < islands; island++)
+				SolveIsland(island, dt);
+		}
+		IntegratePositions(dt);
+		SolveContinuous(dt);
+	}
+
+	zm::vec3 PhysicsWorld::GetInterpolatedPosition(BodyID body, float alpha) const {
+		uint32_t index = m_index[body];
+		zm::vec3 previous = Get(PREVIOUS_X, index);
+		return previous + (Get(POSITION_X, index) - previous) * zm::vec3(alpha);
+	}
+
+	void PhysicsWorld::SetPosition(BodyID body, const zm::vec3& position) {
+		uint32_t index = m_index[body];
+		Set(POSITION_X, index, position);
+		Set(PREVIOUS_X, index, position);
+		m_tree.MoveProxy(m_proxies[index], GetBox(index));
+	}
+
+	void PhysicsWorld::ApplyImpulse(BodyID body, const zm::vec3& impulse) {
+		uint32_t index = m_index[body];
+		Set(VELOCITY_X, index, Get(VELOCITY_X, index) + impulse * zm::vec3(m_fields[INV_MASS][index]));
+	}
+
+	void PhysicsWorld::Set(Field field, uint32_t index, const zm::vec3& value) {
+		for (int i = 0; i < 3; i++)
+			m_fields[field + i][index] = value[i];
+	}
+
+	AABB3D PhysicsWorld::GetBox(uint32_t index) const {
+		return AABB3D::FromCenter(Get(POSITION_X, index), Get(HALF_X, index));
+	}
+
+	//========================================================================
+	//	Integration
+	//========================================================================
+
+	void PhysicsWorld::IntegrateVelocities(float dt) {
+		ZoneScoped;
+		const zm::vec3 impulse = m_gravity * zm::vec3(dt);
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		using float4 = zm::simd<float, 4>;
+		const float4 zero(0.f);
+		const float4 gx(impulse.x), gy(impulse.y), gz(impulse.z);
+		for (size_t i = 0; i < m_fields[INV_MASS].size(); i += 4) {
+			const float4 dynamic = float4(&m_fields[INV_MASS][i]) > zero;
+			(float4(&m_fields[VELOCITY_X][i]) + (gx & dynamic)).unload(&m_fields[VELOCITY_X][i]);
+			(float4(&m_fields[VELOCITY_Y][i]) + (gy & dynamic)).unload(&m_fields[VELOCITY_Y][i]);
+			(float4(&m_fields[VELOCITY_Z][i]) + (gz & dynamic)).unload(&m_fields[VELOCITY_Z][i]);
+		}
+#else
+		for (size_t i = 0; i < m_count; i++) {
+			if (m_fields[INV_MASS][i] == 0.f)
+				continue;
+			for (int a = 0; a < 3; a++)
+				m_fields[VELOCITY_X + a][i] += impulse[a];
+		}
+#endif
+	}
+
+	void PhysicsWorld::IntegratePositions(float dt) {
+		ZoneScoped;
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		using float4 = zm::simd<float, 4>;
+		const float4 step(dt);
+		for (size_t i = 0; i < m_fields[INV_MASS].size(); i += 4) {
+			for (int a = 0; a < 3; a++) {
+				float* position = &m_fields[POSITION_X + a][i];
+				(float4(position) + float4(&m_fields[VELOCITY_X + a][i]) * step).unload(position);
+			}
+		}
+#else
+		for (size_t i = 0; i < m_count; i++)
+			for (int a = 0; a < 3; a++)
+				m_fields[POSITION_X + a][i] += m_fields[VELOCITY_X + a][i] * dt;
+#endif
+	}
+
+	void PhysicsWorld::SolveContinuous(float dt) {
+		ZoneScoped;
+		for (uint32_t i = 0; i < m_count; i++) {
+			if (m_fields[INV_MASS][i] == 0.f)
+				continue;
+			// Slower bodies cannot skip past anything within a step, and are left to the discrete contacts
+			const zm::vec3 half_extents = Get(HALF_X, i);
+			const float threshold = CONTINUOUS_THRESHOLD * zm::Min(half_extents.x, zm::Min(half_extents.y, half_extents.z));
+			zm::vec3 velocity = Get(VELOCITY_X, i);
+			zm::vec3 motion = velocity * zm::vec3(dt);
+			if (motion.Dot(motion) <= threshold * threshold)
+				continue;
+
+			// Redo this step's motion from where the body started, stopping at each time of impact and sliding the remainder along
+			// the surface that was hit. Motion left over after the last sweep is dropped
+			zm::vec3 position = Get(PREVIOUS_X, i);
+			for (uint32_t sweep = 0; sweep < MAX_SWEEPS; sweep++) {
+				float toi;
+				zm::vec3 normal;
+				if (!SweepBody(i, AABB3D::FromCenter(position, half_extents), motion, toi, normal)) {
+					position += motion;
+					break;
+				}
+				position += motion * zm::vec3(toi);
+				motion = motion * zm::vec3(1.f - toi);
+				motion -= normal * zm::vec3(motion.Dot(normal));
+				velocity -= normal * zm::vec3(zm::Min(velocity.Dot(normal), 0.f));
+			}
+			Set(POSITION_X, i, position);
+			Set(VELOCITY_X, i, velocity);
+		}
+	}
+
+	bool PhysicsWorld::SweepBody(uint32_t index, const AABB3D& box, const zm::vec3& motion, float& toi, zm::vec3& normal) {
+		bool found = false;
+		toi = 1.f;
+		voxel::VoxelHit hit;
+		if (m_voxels && voxel::Sweep(box, motion, m_voxels, hit) && hit.distance < toi) {
+			toi = hit.distance;
+			normal = zm::vec3(hit.normal);
+			found = true;
+		}
+
+		AABB3D swept = box.Merge(AABB3D(box.GetMin() + motion, box.GetMax() + motion));
+		m_tree.Query(swept, [&](int32_t proxy) {
+			uint32_t other = m_index[static_cast<BodyID>(m_tree.GetData(proxy))];
+			float t;
+			zm::vec3 n;
+			if (other != index && m_fields[INV_MASS][other] == 0.f && box.Sweep(GetBox(other), motion, t, n) && t < toi) {
+				toi = t;
+				normal = n;
+				found = true;
+			}
+			return true;
+		});
+		return found;
+	}
+
+	void PhysicsWorld::UpdateProxies(float dt) {
+		ZoneScoped;
+		for (uint32_t i = 0; i < m_count; i++)
+			if (m_fields[INV_MASS][i] > 0.f)
+				m_tree.MoveProxy(m_proxies[i], GetBox(i), Get(VELOCITY_X, i) * zm::vec3(dt));
+	}
+
+	//========================================================================
+	//	Contacts
+	//========================================================================
+
+	void PhysicsWorld::FindContacts() {
+		ZoneScoped;
+		m_contacts.clear();
+		m_new_pairs.clear();
+		m_tree.FindPairs(m_new_pairs);
+		for (const DynamicTree::Pair& pair : m_new_pairs)
+			if (m_pair_keys.insert(PairKey(pair.first, pair.second)).second)
+				m_pairs.push_back(pair);
+
+		for (size_t i = 0; i < m_pairs.size();) {
+			auto [proxy_a, proxy_b] = m_pairs[i];
+			if (!m_tree.GetFatAABB(proxy_a).Overlaps(m_tree.GetFatAABB(proxy_b))) {
+				m_pair_keys.erase(PairKey(proxy_a, proxy_b));
+				m_pairs[i] = m_pairs.back();
+				m_pairs.pop_back();
+				continue;
+			}
+			i++;
+
+			uint32_t a = m_index[static_cast<BodyID>(m_tree.GetData(proxy_a))];
+			uint32_t b = m_index[static_cast<BodyID>(m_tree.GetData(proxy_b))];
+			// The first body of a contact is always dynamic
+			if (m_fields[INV_MASS][a] == 0.f)
+				std::swap(a, b);
+			if (m_fields[INV_MASS][a] == 0.f)
+				continue;
+			float friction = std::sqrt(m_fields[FRICTION][a] * m_fields[FRICTION][b]);
+			AddContact(a, b, GetBox(a), GetBox(b), friction);
+		}
+
+		if (m_voxels) {
+			voxel::BlockSampler sampler(m_voxels);
+			for (uint32_t i = 0; i < m_count; i++)
+				if (m_fields[INV_MASS][i] > 0.f)
+					FindVoxelContacts(i, sampler);
+		}
+	}
+
+	void PhysicsWorld::FindVoxelContacts(uint32_t index, voxel::BlockSampler& sampler) {
+		const AABB3D box = GetBox(index);
+		const zm::ivec3 lower = zm::ivec3(zm::Floor(box.GetMin()));
+		const zm::ivec3 upper = zm::ivec3(zm::Floor(box.GetMax()));
+		for (int32_t x = lower.x; x <= upper.x; x++) {
+			for (int32_t y = lower.y; y <= upper.y; y++) {
+				for (int32_t z = lower.z; z <= upper.z; z++) {
+					zm::ivec3 block(x, y, z);
+					if (sampler.Get(block) == voxel::AIR)
+						continue;
+					zm::vec3 corner = zm::vec3(block);
+					if (!AddContact(index, INVALID_BODY, box, AABB3D(corner, corner + zm::vec3(1.f)), m_fields[FRICTION][index]))
+						continue;
+					// A face shared with another solid block is internal, and would snag bodies sliding across the surface
+					zm::ivec3 normal = zm::ivec3(m_contacts.back().normal);
+					if (sampler.Get(block - normal) != voxel::AIR)
+						m_contacts.pop_back();
+				}
+			}
+		}
+	}
+
+	bool PhysicsWorld::AddContact(uint32_t a, uint32_t b, const AABB3D& box_a, const AABB3D& box_b, float friction) {
+		const zm::vec3 delta = box_b.GetCenter() - box_a.GetCenter();
+		const zm::vec3 reach = box_a.GetExtents() + box_b.GetExtents();
+		zm::vec3 overlap;
+		for (int i = 0; i < 3; i++) {
+			overlap[i] = reach[i] - zm::Abs(delta[i]);
+			if (overlap[i] <= 0.f)
+				return false;
+		}
+
+		// Separate along the axis of least penetration
+		int axis = overlap.x <= overlap.y && overlap.x <= overlap.z ? 0 : (overlap.y <= overlap.z ? 1 : 2);
+		zm::vec3 normal(0.f);
+		normal[axis] = delta[axis] < 0.f ? -1.f : 1.f;
+		m_contacts.push_back({ a, b, normal, overlap[axis], friction, 0.f, 0.f, zm::vec3(0.f) });
+		return true;
+	}
+
+	void PhysicsWorld::RemovePairs(int32_t proxy) {
+		for (size_t i = 0; i < m_pairs.size();) {
+			if (m_pairs[i].first != proxy && m_pairs[i].second != proxy) {
+				i++;
+				continue;
+			}
+			m_pair_keys.erase(PairKey(m_pairs[i].first, m_pairs[i].second));
+			m_pairs[i] = m_pairs.back();
+			m_pairs.pop_back();
+		}
+	}
+
+	//========================================================================
+	//	Islands
+	//========================================================================
+
+	uint32_t PhysicsWorld::FindRoot(uint32_t index) {
+		while (m_parents[index] != index) {
+			m_parents[index] = m_parents[m_parents[index]];
+			index = m_parents[index];
+		}
+		return index;
+	}
+
+	void PhysicsWorld::BuildIslands() {
+		ZoneScoped;
+		m_parents.resize(m_count);
+		for (uint32_t i = 0; i < m_count; i++)
+			m_parents[i] = i;
+
+		// Only contacts between two dynamic bodies join islands, since static bodies are never written to by the solver
+		for (const Contact& contact : m_contacts) {
+			if (contact.b == INVALID_BODY || m_fields[INV_MASS][contact.b] == 0.f)
+				continue;
+			uint32_t root_a = FindRoot(contact.a);
+			uint32_t root_b = FindRoot(contact.b);
+			if (root_a != root_b)
+				m_parents[zm::Max(root_a, root_b)] = zm::Min(root_a, root_b);
+		}
+
+		// Number the islands in order of first appearance, and counting sort the contacts by island
+		m_islands.assign(m_count, INVALID_BODY);
+		m_island_start.assign(1, 0);
+		std::vector<uint32_t> contact_islands(m_contacts.size());
+		for (size_t i = 0; i < m_contacts.size(); i++) {
+			uint32_t root = FindRoot(m_contacts[i].a);
+			if (m_islands[root] == INVALID_BODY) {
+				m_islands[root] = static_cast<uint32_t>(m_island_start.size() - 1);
+				m_island_start.push_back(0);
+			}
+			contact_islands[i] = m_islands[root];
+			m_island_start[contact_islands[i] + 1]++;
+		}
+		for (size_t i = 1; i < m_island_start.size(); i++)
+			m_island_start[i] += m_island_start[i - 1];
+
+		m_island_contacts.resize(m_contacts.size());
+		std::vector<uint32_t> cursors(m_island_start.begin(), m_island_start.end() - 1);
+		for (size_t i = 0; i < m_contacts.size(); i++)
+			m_island_contacts[cursors[contact_islands[i]]++] = static_cast<uint32_t>(i);
+	}
+
+	void PhysicsWorld::SolveIsland(uint32_t island, float dt) {
+		const uint32_t* first = m_island_contacts.data() + m_island_start[island];
+		const uint32_t* last = m_island_contacts.data() + m_island_start[island + 1];
+		const float* inv_mass = m_fields[INV_MASS].data();
+
+		for (const uint32_t* i = first; i < last; i++) {
+			Contact& contact = m_contacts[*i];
+			bool body = contact.b != INVALID_BODY;
+			zm::vec3 relative = (body ? Get(VELOCITY_X, contact.b) : zm::vec3(0.f)) - Get(VELOCITY_X, contact.a);
+			float closing = relative.Dot(contact.normal);
+			float restitution = body ? zm::Max(m_fields[RESTITUTION][contact.a], m_fields[RESTITUTION][contact.b]) : m_fields[RESTITUTION][contact.a];
+			float bounce = closing < -RESTITUTION_THRESHOLD ? -restitution * closing : 0.f;
+			float correction = CORRECTION_FACTOR * zm::Max(contact.depth - PENETRATION_SLOP, 0.f) / dt;
+			// The normal points from a to b, so separating means a negative relative velocity along it
+			contact.target = -zm::Max(bounce, correction);
+			contact.impulse = 0.f;
+			contact.friction_impulse = zm::vec3(0.f);
+		}
+
+		// Sequential impulses, clamping the accumulated normal impulse of each contact so that it can only push bodies apart
+		for (uint32_t iteration = 0; iteration < SOLVER_ITERATIONS; iteration++) {
+			for (const uint32_t* i = first; i < last; i++) {
+				Contact& contact = m_contacts[*i];
+				const bool body = contact.b != INVALID_BODY;
+				const float inv_a = inv_mass[contact.a];
+				const float inv_b = body ? inv_mass[contact.b] : 0.f;
+				const float inv_sum = inv_a + inv_b;
+				zm::vec3 velocity_a = Get(VELOCITY_X, contact.a);
+				zm::vec3 velocity_b = body ? Get(VELOCITY_X, contact.b) : zm::vec3(0.f);
+
+				float approach = (velocity_a - velocity_b).Dot(contact.normal);
+				float lambda = (approach - contact.target) / inv_sum;
+				float impulse = zm::Max(contact.impulse + lambda, 0.f);
+				lambda = impulse - contact.impulse;
+				contact.impulse = impulse;
+				velocity_a -= contact.normal * zm::vec3(lambda * inv_a);
+				velocity_b += contact.normal * zm::vec3(lambda * inv_b);
+
+				// Friction opposes the sliding velocity, with the accumulated friction impulse clamped to the limit set by the
+				// accumulated normal impulse, and only the change applied
+				zm::vec3 relative = velocity_a - velocity_b;
+				zm::vec3 sliding = relative - contact.normal * zm::vec3(relative.Dot(contact.normal));
+				zm::vec3 friction = contact.friction_impulse + sliding * zm::vec3(1.f / inv_sum);
+				float limit = contact.friction * contact.impulse;
+				float magnitude = friction.Length();
+				if (magnitude > limit)
+					friction = friction * zm::vec3(limit / magnitude);
+				zm::vec3 tangent = friction - contact.friction_impulse;
+				contact.friction_impulse = friction;
+				velocity_a -= tangent * zm::vec3(inv_a);
+				velocity_b += tangent * zm::vec3(inv_b);
+
+				Set(VELOCITY_X, contact.a, velocity_a);
+				if (inv_b > 0.f)
+					Set(VELOCITY_X, contact.b, velocity_b);
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "zore/physics/dynamic_tree.hpp"
+#include "zore/voxel/raycast.hpp"
+#include "zore/structures/object_pool.hpp"
+#include <vector>
+#include <unordered_set>
+
+namespace zore {
+
+	class thread_pool;
+
+	//========================================================================
+	//	Physics World
+	//========================================================================
+
+	// Simulates axis aligned box bodies with a fixed timestep. Body state is kept in separate arrays per component, so that
+	// integration runs four bodies at a time. Contacts are grouped into islands of touching bodies, which are solved independently
+	// and in parallel when a thread pool is given. Fast bodies are swept against voxels and static bodies so they cannot tunnel
+	class PhysicsWorld {
+	public:
+		using BodyID = uint32_t;
+
+		static constexpr BodyID INVALID_BODY = static_cast<BodyID>(-1);
+		static constexpr float DEFAULT_TIMESTEP = 1.f / 60.f;
+		// Limits the steps taken by a single Update, so that a slow frame cannot snowball into slower frames
+		static constexpr uint32_t MAX_STEPS = 8;
+		static constexpr uint32_t SOLVER_ITERATIONS = 8;
+		// Penetration allowed before position correction kicks in, and the fraction of the remainder corrected per step
+		static constexpr float PENETRATION_SLOP = 0.01f;
+		static constexpr float CORRECTION_FACTOR = 0.2f;
+		// Closing speeds below this do not bounce, which lets resting contacts settle
+		static constexpr float RESTITUTION_THRESHOLD = 1.f;
+		// Bodies moving further than this fraction of their smallest half extent in one step are swept against static geometry,
+		// and slide along up to MAX_SWEEPS surfaces within the step
+		static constexpr float CONTINUOUS_THRESHOLD = 0.5f;
+		static constexpr uint32_t MAX_SWEEPS = 4;
+
+		struct BodyDesc {
+			zm::vec3 position = zm::vec3(0.f);
+			zm::vec3 half_extents = zm::vec3(0.5f);
+			zm::vec3 velocity = zm::vec3(0.f);
+			// Bodies with zero mass are static
+			float mass = 1.f;
+			float restitution = 0.f;
+			float friction = 0.5f;
+		};
+
+	private:
+		enum Field {
+			POSITION_X, POSITION_Y, POSITION_Z,
+			VELOCITY_X, VELOCITY_Y, VELOCITY_Z,
+			PREVIOUS_X, PREVIOUS_Y, PREVIOUS_Z,
+			HALF_X, HALF_Y, HALF_Z,
+			INV_MASS, RESTITUTION, FRICTION,
+			FIELD_COUNT
+		};
+
+		// A contact between dense body a and dense body b, or a static block when b is INVALID_BODY. The normal points from a to b
+		struct Contact {
+			uint32_t a;
+			uint32_t b;
+			zm::vec3 normal;
+			float depth;
+			float friction;
+			// Separating speed the solver drives the contact towards, from restitution and position correction
+			float target;
+			float impulse;
+			// Accumulated across iterations like the normal impulse, so that it can be held to the friction limit as a whole
+			zm::vec3 friction_impulse;
+		};
+
+	public:
+		PhysicsWorld(float timestep = DEFAULT_TIMESTEP, thread_pool* pool = nullptr);
+		PhysicsWorld(const PhysicsWorld&) = delete;
+		PhysicsWorld& operator=(const PhysicsWorld&) = delete;
+		~PhysicsWorld() = default;
+
+		BodyID CreateBody(const BodyDesc& desc);
+		void DestroyBody(BodyID body);
+
+		// Blocks returned by the lookup collide with every dynamic body. Pass nullptr to remove the voxel world
+		void SetVoxels(voxel::ChunkLookup lookup) { m_voxels = std::move(lookup); }
+		void SetGravity(const zm::vec3& gravity) { m_gravity = gravity; }
+		const zm::vec3& GetGravity() const { return m_gravity; }
+
+		// Runs as many whole timesteps as have accumulated, and returns how far the leftover time is into the next step
+		float Update(float elapsed);
+		void Step();
+
+		zm::vec3 GetPosition(BodyID body) const { return Get(POSITION_X, m_index[body]); }
+		// Blends between the last two steps, using the fraction returned by Update
+		zm::vec3 GetInterpolatedPosition(BodyID body, float alpha) const;
+		zm::vec3 GetVelocity(BodyID body) const { return Get(VELOCITY_X, m_index[body]); }
+		AABB3D GetAABB(BodyID body) const { return GetBox(m_index[body]); }
+		void SetPosition(BodyID body, const zm::vec3& position);
+		void SetVelocity(BodyID body, const zm::vec3& velocity) { Set(VELOCITY_X, m_index[body], velocity); }
+		void ApplyImpulse(BodyID body, const zm::vec3& impulse);
+		bool IsStatic(BodyID body) const { return m_fields[INV_MASS][m_index[body]] == 0.f; }
+
+		float GetTimestep() const { return m_timestep; }
+		size_t GetBodyCount() const { return m_count; }
+		size_t GetContactCount() const { return m_contacts.size(); }
+		size_t GetIslandCount() const { return m_island_start.empty() ? 0 : m_island_start.size() - 1; }
+		const DynamicTree& GetTree() const { return m_tree; }
+
+	private:
+		zm::vec3 Get(Field field, uint32_t index) const { return { m_fields[field][index], m_fields[field + 1][index], m_fields[field + 2][index] }; }
+		void Set(Field field, uint32_t index, const zm::vec3& value);
+		AABB3D GetBox(uint32_t index) const;
+
+		void IntegrateVelocities(float dt);
+		void IntegratePositions(float dt);
+		void SolveContinuous(float dt);
+		bool SweepBody(uint32_t index, const AABB3D& box, const zm::vec3& motion, float& toi, zm::vec3& normal);
+		void UpdateProxies(float dt);
+		void FindContacts();
+		void FindVoxelContacts(uint32_t index, voxel::BlockSampler& sampler);
+		bool AddContact(uint32_t a, uint32_t b, const AABB3D& box_a, const AABB3D& box_b, float friction);
+		void RemovePairs(int32_t proxy);
+		void BuildIslands();
+		void SolveIsland(uint32_t island, float dt);
+		uint32_t FindRoot(uint32_t index);
+
+	private:
+		float m_timestep;
+		float m_accumulator;
+		zm::vec3 m_gravity;
+		thread_pool* m_pool;
+		voxel::ChunkLookup m_voxels;
+		DynamicTree m_tree;
+
+		// Body state is dense and padded to a multiple of 4 with static bodies. Destroyed bodies are swapped with the last body,
+		// so handles are mapped to their current dense index
+		std::vector<float> m_fields[FIELD_COUNT];
+		std::vector<int32_t> m_proxies;
+		std::vector<BodyID> m_bodies;
+		object_pool<uint32_t, BodyID> m_index;
+		size_t m_count;
+
+		// Proxy pairs whose fat boxes overlap, which are kept until the fat boxes separate
+		std::vector<DynamicTree::Pair> m_pairs;
+		std::vector<DynamicTree::Pair> m_new_pairs;
+		std::unordered_set<uint64_t> m_pair_keys;
+
+		std::vector<Contact> m_contacts;
+		std::vector<uint32_t> m_parents;
+		std::vector<uint32_t> m_islands;
+		// Contacts sorted by island, where island i holds m_island_contacts[m_island_start[i], m_island_start[i + 1])
+		std::vector<uint32_t> m_island_contacts;
+		std::vector<uint32_t> m_island_start;
+	};
+}
\ No newline at end of file
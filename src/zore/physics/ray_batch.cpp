@@ -0,0 +1,48 @@
+#include "zore/physics/ray_batch.hpp"
+
+namespace zore {
+
+	//========================================================================
+	//	Ray Batch
+	//========================================================================
+
+	uint32_t RayBatch::Add(const zm::vec3& origin, const zm::vec3& direction, float max_distance) {
+		if (m_count % PACKET_SIZE == 0) {
+			for (int i = 0; i < 3; i++) {
+				m_origin[i].resize(m_count + PACKET_SIZE, 0.f);
+				m_direction[i].resize(m_count + PACKET_SIZE, 0.f);
+				m_inv_direction[i].resize(m_count + PACKET_SIZE, std::numeric_limits<float>::infinity());
+			}
+			m_max_distance.resize(m_count + PACKET_SIZE, -1.f);
+		}
+
+		const zm::vec3 inv = zm::vec3(1.f) / direction;
+		for (int i = 0; i < 3; i++) {
+			m_origin[i][m_count] = origin[i];
+			m_direction[i][m_count] = direction[i];
+			m_inv_direction[i][m_count] = inv[i];
+		}
+		m_max_distance[m_count] = max_distance;
+		return static_cast<uint32_t>(m_count++);
+	}
+
+	void RayBatch::Reserve(size_t count) {
+		count = (count + PACKET_SIZE - 1) & ~size_t(PACKET_SIZE - 1);
+		for (int i = 0; i < 3; i++) {
+			m_origin[i].reserve(count);
+			m_direction[i].reserve(count);
+			m_inv_direction[i].reserve(count);
+		}
+		m_max_distance.reserve(count);
+	}
+
+	void RayBatch::Clear() {
+		for (int i = 0; i < 3; i++) {
+			m_origin[i].clear();
+			m_direction[i].clear();
+			m_inv_direction[i].clear();
+		}
+		m_max_distance.clear();
+		m_count = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "zore/math/vector.hpp"
+#include <vector>
+#include <limits>
+
+namespace zore {
+
+	//========================================================================
+	//	Ray Batch
+	//========================================================================
+
+	// Stores rays as separate arrays per component, padded to a multiple of 4, so that casts can load a packet of four rays per
+	// SIMD register. Padding rays have a negative max distance and never hit anything
+	class RayBatch {
+	public:
+		static constexpr uint32_t PACKET_SIZE = 4;
+
+	public:
+		RayBatch() = default;
+		~RayBatch() = default;
+
+		// direction does not need to be normalized, in which case distances are measured in multiples of its length
+		uint32_t Add(const zm::vec3& origin, const zm::vec3& direction, float max_distance);
+		void Reserve(size_t count);
+		void Clear();
+		size_t Size() const { return m_count; }
+		size_t PaddedSize() const { return m_max_distance.size(); }
+
+		zm::vec3 GetOrigin(uint32_t index) const { return { m_origin[0][index], m_origin[1][index], m_origin[2][index] }; }
+		zm::vec3 GetDirection(uint32_t index) const { return { m_direction[0][index], m_direction[1][index], m_direction[2][index] }; }
+		float GetMaxDistance(uint32_t index) const { return m_max_distance[index]; }
+
+		const float* GetOrigins(int axis) const { return m_origin[axis].data(); }
+		const float* GetDirections(int axis) const { return m_direction[axis].data(); }
+		const float* GetInvDirections(int axis) const { return m_inv_direction[axis].data(); }
+		const float* GetMaxDistances() const { return m_max_distance.data(); }
+
+	private:
+		std::vector<float> m_origin[3];
+		std::vector<float> m_direction[3];
+		std::vector<float> m_inv_direction[3];
+		std::vector<float> m_max_distance;
+		size_t m_count = 0;
+	};
+
+	//========================================================================
+	//	Ray Hit Buffer
+	//========================================================================
+
+	// The closest hit of each ray in a batch, stored as separate arrays
+	struct RayHits {
+		static constexpr int32_t MISS = -1;
+
+		std::vector<float> distance;
+		std::vector<int32_t> id;
+
+		// Resizes to {count} rays, and marks every ray as a miss
+		void Reset(size_t count) {
+			distance.assign(count, std::numeric_limits<float>::infinity());
+			id.assign(count, MISS);
+		}
+
+		size_t Size() const { return id.size(); }
+		bool IsHit(uint32_t index) const { return id[index] != MISS; }
+	};
+}
\ No newline at end of file
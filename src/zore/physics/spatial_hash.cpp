@@ -0,0 +1,230 @@
+#include "zore/physics/spatial_hash.hpp"
+#include "zore/structures/thread_pool.hpp"
+#include "zore/debug/profiler.hpp"
+#include "zore/debug.hpp"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <limits>
+#include <bit>
+
+namespace zore {
+
+	// Points are handed to each pool job in chunks of this size
+	static constexpr size_t BUILD_GRAIN = 4096;
+	// Query centers further out than this many cells are scanned directly, keeping cell coordinates and shell offsets within int32_t
+	static constexpr float MAX_QUERY_CELL = 1 << 30;
+
+	//========================================================================
+	//	Spatial Hash Grid
+	//========================================================================
+
+	SpatialHash::SpatialHash(float cell_size) : m_cell_size(cell_size), m_inv_cell_size(1.f / cell_size), m_mask(0), m_min_cell(0), m_max_cell(0) {
+		DEBUG_ENSURE(cell_size > 0.f, "Spatial hash cell size must be positive");
+	}
+
+	void SpatialHash::Resize(size_t count) {
+		uint32_t table_size = std::bit_ceil(static_cast<uint32_t>(zm::Max(count, size_t(MIN_TABLE_SIZE))));
+		m_mask = table_size - 1;
+		m_bucket_start.assign(table_size + 1, 0);
+		m_keys.resize(count);
+		m_indices.resize(count);
+		m_points.resize(count);
+		m_min_cell = zm::ivec3(std::numeric_limits<int32_t>::max());
+		m_max_cell = zm::ivec3(std::numeric_limits<int32_t>::min());
+	}
+
+	void SpatialHash::Build(const zm::vec3* points, size_t count) {
+		ZoneScoped;
+		Resize(count);
+		for (size_t i = 0; i < count; i++) {
+			zm::ivec3 cell = GetCell(points[i]);
+			m_min_cell = zm::Min(m_min_cell, cell);
+			m_max_cell = zm::Max(m_max_cell, cell);
+			m_keys[i] = Hash(cell);
+			m_bucket_start[m_keys[i]]++;
+		}
+
+		// Exclusive prefix sum of the bucket sizes, then scatter each point to the next free slot of its bucket
+		uint32_t offset = 0;
+		for (uint32_t& start : m_bucket_start) {
+			uint32_t size = start;
+			start = offset;
+			offset += size;
+		}
+		for (size_t i = 0; i < count; i++) {
+			uint32_t slot = m_bucket_start[m_keys[i]]++;
+			m_indices[slot] = static_cast<uint32_t>(i);
+			m_points[slot] = points[i];
+		}
+		// Scattering advanced each start to the start of the following bucket
+		std::copy_backward(m_bucket_start.begin(), m_bucket_start.end() - 1, m_bucket_start.end());
+		m_bucket_start[0] = 0;
+	}
+
+	void SpatialHash::Build(const zm::vec3* points, size_t count, thread_pool& pool) {
+		ZoneScoped;
+		Resize(count);
+		std::mutex bounds_mutex;
+		pool.parallel_for(count, BUILD_GRAIN, [&](size_t begin, size_t end) {
+			zm::ivec3 min_cell = zm::ivec3(std::numeric_limits<int32_t>::max());
+			zm::ivec3 max_cell = zm::ivec3(std::numeric_limits<int32_t>::min());
+			for (size_t i = begin; i < end; i++) {
+				zm::ivec3 cell = GetCell(points[i]);
+				min_cell = zm::Min(min_cell, cell);
+				max_cell = zm::Max(max_cell, cell);
+				m_keys[i] = Hash(cell);
+				std::atomic_ref<uint32_t>(m_bucket_start[m_keys[i]]).fetch_add(1, std::memory_order_relaxed);
+			}
+			std::lock_guard<std::mutex> lock(bounds_mutex);
+			m_min_cell = zm::Min(m_min_cell, min_cell);
+			m_max_cell = zm::Max(m_max_cell, max_cell);
+		});
+
+		uint32_t offset = 0;
+		for (uint32_t& start : m_bucket_start) {
+			uint32_t size = start;
+			start = offset;
+			offset += size;
+		}
+
+		// Slots are claimed from the end of each bucket, which leaves m_bucket_start in place once every point is scattered
+		std::vector<uint32_t> cursors(m_bucket_start.begin() + 1, m_bucket_start.end());
+		pool.parallel_for(count, BUILD_GRAIN, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				uint32_t slot = std::atomic_ref<uint32_t>(cursors[m_keys[i]]).fetch_sub(1, std::memory_order_relaxed) - 1;
+				m_indices[slot] = static_cast<uint32_t>(i);
+			}
+		});
+
+		// Threads scatter in any order, so each bucket is sorted to match the single threaded build before gathering the points
+		pool.parallel_for(m_mask + 1, BUILD_GRAIN, [&](size_t begin, size_t end) {
+			for (size_t bucket = begin; bucket < end; bucket++) {
+				uint32_t* first = m_indices.data() + m_bucket_start[bucket];
+				uint32_t* last = m_indices.data() + m_bucket_start[bucket + 1];
+				if (last - first > 1)
+					std::sort(first, last);
+				for (uint32_t* i = first; i < last; i++)
+					m_points[i - m_indices.data()] = points[*i];
+			}
+		});
+	}
+
+	void SpatialHash::Clear() {
+		m_bucket_start.clear();
+		m_keys.clear();
+		m_indices.clear();
+		m_points.clear();
+	}
+
+	bool SpatialHash::GetCellRange(const zm::vec3& lower, const zm::vec3& upper, zm::ivec3& first, zm::ivec3& last) const {
+		const zm::vec3 low = zm::Floor(lower * zm::vec3(m_inv_cell_size));
+		const zm::vec3 high = zm::Floor(upper * zm::vec3(m_inv_cell_size));
+		// Compared as doubles, which hold every int32_t exactly, so only cells already inside the occupied range are cast back
+		for (int axis = 0; axis < 3; axis++) {
+			double first_cell = std::max(static_cast<double>(low[axis]), static_cast<double>(m_min_cell[axis]));
+			double last_cell = std::min(static_cast<double>(high[axis]), static_cast<double>(m_max_cell[axis]));
+			if (!(first_cell <= last_cell))
+				return false;
+			first[axis] = static_cast<int32_t>(first_cell);
+			last[axis] = static_cast<int32_t>(last_cell);
+		}
+		return true;
+	}
+
+	void SpatialHash::QueryRadius(const zm::vec3& center, float radius, std::vector<uint32_t>& out) const {
+		QueryRadius(center, radius, [&out](uint32_t index, float) {
+			out.push_back(index);
+		});
+	}
+
+	size_t SpatialHash::QueryNearest(const zm::vec3& center, size_t k, float max_distance, std::vector<uint32_t>& out) const {
+		ZoneScoped;
+		struct Candidate {
+			float distance_squared;
+			uint32_t index;
+
+			bool operator<(const Candidate& other) const {
+				return distance_squared < other.distance_squared || (distance_squared == other.distance_squared && index < other.index);
+			}
+		};
+		if (m_points.empty() || k == 0 || std::isnan(max_distance))
+			return 0;
+
+		// Max heap of the k nearest candidates so far
+		std::vector<Candidate> heap;
+		heap.reserve(k);
+		float radius_squared = max_distance * max_distance;
+		auto consider = [&](uint32_t index, float distance_squared) {
+			Candidate candidate = { distance_squared, index };
+			if (heap.size() < k) {
+				heap.push_back(candidate);
+				std::push_heap(heap.begin(), heap.end());
+				if (heap.size() == k)
+					radius_squared = heap.front().distance_squared;
+				return;
+			}
+			if (!(candidate < heap.front()))
+				return;
+			std::pop_heap(heap.begin(), heap.end());
+			heap.back() = candidate;
+			std::push_heap(heap.begin(), heap.end());
+			radius_squared = heap.front().distance_squared;
+		};
+
+		auto scan = [&]() {
+			heap.clear();
+			radius_squared = max_distance * max_distance;
+			for (uint32_t i = 0; i < m_points.size(); i++) {
+				zm::vec3 offset = m_points[i] - center;
+				float distance_squared = offset.Dot(offset);
+				if (distance_squared <= radius_squared)
+					consider(m_indices[i], distance_squared);
+			}
+		};
+
+		const zm::vec3 scaled = center * zm::vec3(m_inv_cell_size);
+		const zm::vec3 floored = zm::Floor(scaled);
+		if (!(zm::Abs(floored.x) < MAX_QUERY_CELL && zm::Abs(floored.y) < MAX_QUERY_CELL && zm::Abs(floored.z) < MAX_QUERY_CELL)) {
+			scan();
+		}
+		else {
+			// Search shells of cells around the center cell, until the next shell cannot hold anything nearer than the k found so far
+			const zm::ivec3 origin = zm::ivec3(floored);
+			const zm::vec3 local = scaled - zm::vec3(origin);
+			const float border = zm::Min(zm::Min(zm::Min(local.x, 1.f - local.x), zm::Min(local.y, 1.f - local.y)), zm::Min(local.z, 1.f - local.z)) * m_cell_size;
+			// No ring past the cells holding points can find anything, which also bounds searches with an unlimited distance
+			int64_t extent = 0;
+			for (int axis = 0; axis < 3; axis++)
+				extent = std::max({ extent, static_cast<int64_t>(origin[axis]) - m_min_cell[axis], static_cast<int64_t>(m_max_cell[axis]) - origin[axis] });
+			extent = std::min<int64_t>(extent, std::numeric_limits<int32_t>::max() - 1);
+			const float rings = max_distance * m_inv_cell_size;
+			const int32_t max_ring = rings < static_cast<float>(extent) ? static_cast<int32_t>(std::ceil(rings)) + 1 : static_cast<int32_t>(extent);
+			for (int32_t ring = 0; ring <= max_ring; ring++) {
+				if (ring > 0) {
+					float nearest = border + (ring - 1) * m_cell_size;
+					if (nearest * nearest > radius_squared)
+						break;
+					// Once a shell has more cells than there are points, scanning every point is cheaper than visiting it
+					if (24 * static_cast<uint64_t>(ring) * ring + 2 > m_points.size()) {
+						scan();
+						break;
+					}
+				}
+				for (int32_t x = -ring; x <= ring; x++) {
+					for (int32_t y = -ring; y <= ring; y++) {
+						// Only the faces of the shell are new, so inner columns just visit their two end cells
+						bool face = zm::Abs(x) == ring || zm::Abs(y) == ring;
+						for (int32_t z = -ring; z <= ring; z += face ? 1 : zm::Max(2 * ring, 1))
+							VisitCell(origin + zm::ivec3(x, y, z), center, radius_squared, consider);
+					}
+				}
+			}
+		}
+
+		std::sort_heap(heap.begin(), heap.end());
+		for (const Candidate& candidate : heap)
+			out.push_back(candidate.index);
+		return heap.size();
+	}
+}
\ No newline at end of file
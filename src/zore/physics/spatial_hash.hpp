@@ -0,0 +1,105 @@
+#pragma once
+
+#include "zore/math/vector.hpp"
+#include <vector>
+#include <cmath>
+
+namespace zore {
+
+	class thread_pool;
+
+	//========================================================================
+	//	Spatial Hash Grid
+	//========================================================================
+
+	// Buckets points into uniform cells, with cell coordinates hashed into a table sized to the point count. The table is
+	// rebuilt from scratch with a counting sort, so points are stored contiguously per bucket and nothing needs updating as they move
+	class SpatialHash {
+	public:
+		static constexpr uint32_t MIN_TABLE_SIZE = 64;
+
+	public:
+		SpatialHash(float cell_size);
+		SpatialHash(const SpatialHash&) = delete;
+		SpatialHash& operator=(const SpatialHash&) = delete;
+		~SpatialHash() = default;
+
+		void Build(const zm::vec3* points, size_t count);
+		void Build(const std::vector<zm::vec3>& points) { Build(points.data(), points.size()); }
+		// Builds the same table as the single threaded path, with the per point passes split across the pool
+		void Build(const zm::vec3* points, size_t count, thread_pool& pool);
+		void Build(const std::vector<zm::vec3>& points, thread_pool& pool) { Build(points.data(), points.size(), pool); }
+		void Clear();
+
+		float GetCellSize() const { return m_cell_size; }
+		size_t Size() const { return m_points.size(); }
+
+		// Calls callback(index, distance_squared) for every point within radius of center, in no particular order
+		template <typename F>
+		void QueryRadius(const zm::vec3& center, float radius, F&& callback) const;
+		void QueryRadius(const zm::vec3& center, float radius, std::vector<uint32_t>& out) const;
+
+		// Writes the indices of up to k points nearest to center and within max_distance to out, nearest first. Returns the number found
+		size_t QueryNearest(const zm::vec3& center, size_t k, float max_distance, std::vector<uint32_t>& out) const;
+
+	private:
+		zm::ivec3 GetCell(const zm::vec3& point) const;
+		// Clamps the cells covering [lower, upper] to those holding points, returning false when none overlap
+		bool GetCellRange(const zm::vec3& lower, const zm::vec3& upper, zm::ivec3& first, zm::ivec3& last) const;
+		uint32_t Hash(const zm::ivec3& cell) const;
+		void Resize(size_t count);
+
+		// Calls callback(index, distance_squared) for every point of the cell within sqrt(radius_squared) of center
+		template <typename F>
+		void VisitCell(const zm::ivec3& cell, const zm::vec3& center, float radius_squared, F&& callback) const;
+
+	private:
+		float m_cell_size;
+		float m_inv_cell_size;
+		uint32_t m_mask;
+		// Cells holding the first and last points along each axis, which bound how far queries have to look
+		zm::ivec3 m_min_cell;
+		zm::ivec3 m_max_cell;
+		// Bucket b holds the points in [m_bucket_start[b], m_bucket_start[b + 1])
+		std::vector<uint32_t> m_bucket_start;
+		std::vector<uint32_t> m_keys;
+		std::vector<uint32_t> m_indices;
+		std::vector<zm::vec3> m_points;
+	};
+
+	//========================================================================
+	//	Spatial Hash Grid Queries
+	//========================================================================
+
+	inline zm::ivec3 SpatialHash::GetCell(const zm::vec3& point) const {
+		return zm::ivec3(zm::Floor(point * zm::vec3(m_inv_cell_size)));
+	}
+
+	inline uint32_t SpatialHash::Hash(const zm::ivec3& cell) const {
+		return ((static_cast<uint32_t>(cell.x) * 73856093u) ^ (static_cast<uint32_t>(cell.y) * 19349663u) ^ (static_cast<uint32_t>(cell.z) * 83492791u)) & m_mask;
+	}
+
+	template <typename F>
+	void SpatialHash::VisitCell(const zm::ivec3& cell, const zm::vec3& center, float radius_squared, F&& callback) const {
+		uint32_t bucket = Hash(cell);
+		for (uint32_t i = m_bucket_start[bucket]; i < m_bucket_start[bucket + 1]; i++) {
+			zm::vec3 offset = m_points[i] - center;
+			float distance_squared = offset.Dot(offset);
+			// Other cells can hash to the same bucket, and are skipped so that no point is reported twice
+			if (distance_squared <= radius_squared && GetCell(m_points[i]) == cell)
+				callback(m_indices[i], distance_squared);
+		}
+	}
+
+	template <typename F>
+	void SpatialHash::QueryRadius(const zm::vec3& center, float radius, F&& callback) const {
+		zm::ivec3 lower, upper;
+		if (m_points.empty() || !std::isfinite(radius) || !GetCellRange(center - zm::vec3(radius), center + zm::vec3(radius), lower, upper))
+			return;
+		float radius_squared = radius * radius;
+		for (int32_t x = lower.x; x <= upper.x; x++)
+			for (int32_t y = lower.y; y <= upper.y; y++)
+				for (int32_t z = lower.z; z <= upper.z; z++)
+					VisitCell(zm::ivec3(x, y, z), center, radius_squared, callback);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "zore/physics/sweep_and_prune.hpp"
+#include "zore/math/simd.hpp"
+#include "zore/debug/profiler.hpp"
+#include "zore/debug.hpp"
+#include <bit>
+
+namespace zore {
+
+	//========================================================================
+	//	Endpoint Sorting
+	//========================================================================
+
+	// Insertion sorts may shift each endpoint this many places on average before the axis is radix sorted instead
+	static constexpr size_t INSERTION_SORT_BUDGET = 8;
+	static constexpr int RADIX_BITS = 11;
+	static constexpr uint32_t RADIX_SIZE = 1 << RADIX_BITS;
+
+	// Maps a float to an unsigned integer with the same ordering
+	static inline uint32_t SortableKey(float value) {
+		uint32_t bits = std::bit_cast<uint32_t>(value);
+		return bits ^ ((bits >> 31) ? 0xFFFFFFFFu : 0x80000000u);
+	}
+
+	// Min endpoints sort before max endpoints of the same value, so that touching boxes are reported as overlapping
+	template <typename E>
+	static inline bool EndpointLess(const E& a, const E& b) {
+		return a.value < b.value || (a.value == b.value && (a.id & 1) < (b.id & 1));
+	}
+
+	template <typename E>
+	static bool InsertionSort(std::vector<E>& endpoints, size_t budget) {
+		size_t shifts = 0;
+		for (size_t i = 1; i < endpoints.size(); i++) {
+			E endpoint = endpoints[i];
+			size_t j = i;
+			for (; j > 0 && EndpointLess(endpoint, endpoints[j - 1]); j--) {
+				endpoints[j] = endpoints[j - 1];
+				if (++shifts > budget) {
+					endpoints[j - 1] = endpoint;
+					return false;
+				}
+			}
+			endpoints[j] = endpoint;
+		}
+		return true;
+	}
+
+	//========================================================================
+	//	Sweep and Prune Broadphase
+	//========================================================================
+
+	SweepAndPrune::SweepAndPrune(float margin) : m_proxy_count(0), m_margin(margin), m_axis(0) {}
+
+	int32_t SweepAndPrune::CreateProxy(const AABB3D& box, uint64_t data) {
+		int32_t proxy = m_proxies.acquire();
+		Proxy& p = m_proxies[proxy];
+		p.box = AABB3D(box).Grow(m_margin);
+		p.data = data;
+		p.alive = true;
+		p.moved = true;
+		m_moved.push_back(proxy);
+
+		if (static_cast<size_t>(proxy) == m_boxes.Size())
+			m_boxes.Add(p.box);
+		else
+			m_boxes.Set(proxy, p.box);
+
+		// New endpoints are appended, and left for the next sort to move into place
+		uint32_t id = static_cast<uint32_t>(proxy) << 1;
+		for (int axis = 0; axis < 3; axis++) {
+			m_endpoints[axis].push_back({ p.box.GetMin()[axis], id });
+			m_endpoints[axis].push_back({ p.box.GetMax()[axis], id | 1 });
+		}
+		m_proxy_count++;
+		return proxy;
+	}
+
+	void SweepAndPrune::DestroyProxy(int32_t proxy) {
+		DEBUG_ENSURE(m_proxies[proxy].alive, "Sweep and prune proxy has already been destroyed");
+		Proxy& p = m_proxies[proxy];
+		p.alive = false;
+		p.moved = false;
+		m_boxes.Set(proxy, AABB3D::Empty());
+
+		uint32_t id = static_cast<uint32_t>(proxy);
+		for (std::vector<Endpoint>& endpoints : m_endpoints)
+			std::erase_if(endpoints, [id](const Endpoint& e) { return (e.id >> 1) == id; });
+		m_proxies.release(proxy);
+		m_proxy_count--;
+	}
+
+	bool SweepAndPrune::MoveProxy(int32_t proxy, const AABB3D& box, const zm::vec3& displacement) {
+		DEBUG_ENSURE(m_proxies[proxy].alive, "Sweep and prune proxy has been destroyed");
+		Proxy& p = m_proxies[proxy];
+		if (p.box.Contains(box))
+			return false;
+
+		// Extend the fat box along the displacement, so that steadily moving proxies escape it less often
+		AABB3D fat_box = AABB3D(box).Grow(m_margin);
+		p.box = fat_box.Merge(AABB3D(fat_box.GetMin() + displacement, fat_box.GetMax() + displacement));
+		m_boxes.Set(proxy, p.box);
+		if (!p.moved) {
+			p.moved = true;
+			m_moved.push_back(proxy);
+		}
+		return true;
+	}
+
+	void SweepAndPrune::FindPairs(std::vector<Pair>& pairs) {
+		ZoneScoped;
+		if (m_moved.empty())
+			return;
+
+		m_axis = ChooseAxis();
+		SortAxis(m_axis);
+		Sweep(m_axis, pairs);
+
+		for (int32_t proxy : m_moved)
+			m_proxies[proxy].moved = false;
+		m_moved.clear();
+	}
+
+	int SweepAndPrune::ChooseAxis() const {
+		// Sweep along the axis with the greatest spread of box centers, which leaves the fewest boxes active at once
+		zm::vec3 sum(0.f), sum_sq(0.f);
+		for (const Proxy& p : m_proxies) {
+			if (!p.alive)
+				continue;
+			zm::vec3 center = p.box.GetCenter();
+			sum += center;
+			sum_sq += center * center;
+		}
+		float n = static_cast<float>(zm::Max(m_proxy_count, size_t(1)));
+		zm::vec3 variance = sum_sq - (sum * sum) / zm::vec3(n);
+		if (variance.x >= variance.y && variance.x >= variance.z)
+			return 0;
+		return variance.y >= variance.z ? 1 : 2;
+	}
+
+	void SweepAndPrune::SortAxis(int axis) {
+		std::vector<Endpoint>& endpoints = m_endpoints[axis];
+		for (Endpoint& e : endpoints) {
+			const AABB3D& box = m_proxies[e.id >> 1].box;
+			e.value = (e.id & 1) ? box.GetMax()[axis] : box.GetMin()[axis];
+		}
+
+		// Coherent motion only moves a few endpoints a few places. Anything else is radix sorted, and then tidied up so that
+		// min endpoints precede max endpoints of equal value
+		if (!InsertionSort(endpoints, endpoints.size() * INSERTION_SORT_BUDGET)) {
+			RadixSort(endpoints);
+			InsertionSort(endpoints, SIZE_MAX);
+		}
+	}
+
+	void SweepAndPrune::RadixSort(std::vector<Endpoint>& endpoints) {
+		ZoneScoped;
+		m_sort_buffer.resize(endpoints.size());
+		std::vector<Endpoint>* src = &endpoints;
+		std::vector<Endpoint>* dst = &m_sort_buffer;
+
+		uint32_t counts[RADIX_SIZE];
+		for (int shift = 0; shift < 32; shift += RADIX_BITS) {
+			std::fill(counts, counts + RADIX_SIZE, 0u);
+			for (const Endpoint& e : *src)
+				counts[(SortableKey(e.value) >> shift) & (RADIX_SIZE - 1)]++;
+			uint32_t offset = 0;
+			for (uint32_t& count : counts) {
+				uint32_t c = count;
+				count = offset;
+				offset += c;
+			}
+			for (const Endpoint& e : *src)
+				(*dst)[counts[(SortableKey(e.value) >> shift) & (RADIX_SIZE - 1)]++] = e;
+			std::swap(src, dst);
+		}
+		// An odd number of passes leaves the result in the scratch buffer
+		if (src != &endpoints)
+			endpoints.swap(m_sort_buffer);
+	}
+
+	void SweepAndPrune::Sweep(int axis, std::vector<Pair>& pairs) {
+		ZoneScoped;
+		const int u = (axis + 1) % 3;
+		const int v = (axis + 2) % 3;
+		m_active.clear();
+		for (std::vector<float>& bounds : m_active_bounds)
+			bounds.clear();
+		m_active_slot.resize(m_proxies.end() - m_proxies.begin());
+
+		for (const Endpoint& e : m_endpoints[axis]) {
+			int32_t proxy = static_cast<int32_t>(e.id >> 1);
+			if (e.id & 1) {
+				RemoveActive(proxy);
+				continue;
+			}
+
+			const Proxy& p = m_proxies[proxy];
+			const float min_u = p.box.GetMin()[u], max_u = p.box.GetMax()[u];
+			const float min_v = p.box.GetMin()[v], max_v = p.box.GetMax()[v];
+			const size_t count = m_active.size();
+			size_t i = 0;
+
+			auto report = [&](int32_t other) {
+				if (p.moved || m_proxies[other].moved)
+					pairs.emplace_back(zm::Min(proxy, other), zm::Max(proxy, other));
+			};
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+			using float4 = zm::simd<float, 4>;
+			const float4 min_u4(min_u), max_u4(max_u), min_v4(min_v), max_v4(max_v);
+			for (; i + 4 <= count; i += 4) {
+				float4 hit = (float4(&m_active_bounds[0][i]) <= max_u4) & (float4(&m_active_bounds[1][i]) >= min_u4);
+				hit &= (float4(&m_active_bounds[2][i]) <= max_v4) & (float4(&m_active_bounds[3][i]) >= min_v4);
+				for (uint32_t bits = zm::mask(hit); bits; bits &= bits - 1)
+					report(m_active[i + std::countr_zero(bits)]);
+			}
+#endif
+			for (; i < count; i++) {
+				if (m_active_bounds[0][i] <= max_u && m_active_bounds[1][i] >= min_u && m_active_bounds[2][i] <= max_v && m_active_bounds[3][i] >= min_v)
+					report(m_active[i]);
+			}
+
+			m_active_slot[proxy] = static_cast<int32_t>(count);
+			m_active.push_back(proxy);
+			m_active_bounds[0].push_back(min_u);
+			m_active_bounds[1].push_back(max_u);
+			m_active_bounds[2].push_back(min_v);
+			m_active_bounds[3].push_back(max_v);
+		}
+	}
+
+	void SweepAndPrune::RemoveActive(int32_t proxy) {
+		size_t slot = m_active_slot[proxy];
+		size_t last = m_active.size() - 1;
+		m_active[slot] = m_active[last];
+		m_active_slot[m_active[slot]] = static_cast<int32_t>(slot);
+		m_active.pop_back();
+		for (std::vector<float>& bounds : m_active_bounds) {
+			bounds[slot] = bounds[last];
+			bounds.pop_back();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "zore/physics/aabb_batch.hpp"
+#include "zore/structures/object_pool.hpp"
+#include "zore/core/camera.hpp"
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace zore {
+
+	//========================================================================
+	//	Sweep and Prune Broadphase
+	//========================================================================
+
+	// Keeps a sorted array of box endpoints along each axis, and sweeps whichever axis currently separates the proxies best.
+	// Coherent motion is resorted with an insertion sort, while stale or heavily shuffled axes are radix sorted.
+	// Shares its interface with DynamicTree, so the two can be swapped on the same scene
+	class SweepAndPrune {
+	public:
+		static constexpr int32_t NULL_PROXY = -1;
+		static constexpr float DEFAULT_MARGIN = 0.1f;
+
+		using Pair = std::pair<int32_t, int32_t>;
+
+	private:
+		struct Proxy {
+			AABB3D box;
+			uint64_t data = 0;
+			bool alive = false;
+			bool moved = false;
+		};
+
+		// The endpoint's proxy is stored in the upper 31 bits of id, and whether it is a max endpoint in the lowest bit
+		struct Endpoint {
+			float value;
+			uint32_t id;
+		};
+
+	public:
+		SweepAndPrune(float margin = DEFAULT_MARGIN);
+		SweepAndPrune(const SweepAndPrune&) = delete;
+		SweepAndPrune& operator=(const SweepAndPrune&) = delete;
+		~SweepAndPrune() = default;
+
+		int32_t CreateProxy(const AABB3D& box, uint64_t data = 0);
+		void DestroyProxy(int32_t proxy);
+		// Returns true if the proxy escaped its fat box, in which case it will be reported by the next FindPairs call
+		bool MoveProxy(int32_t proxy, const AABB3D& box, const zm::vec3& displacement = zm::vec3(0.f));
+
+		const AABB3D& GetFatAABB(int32_t proxy) const { return m_proxies[proxy].box; }
+		uint64_t GetData(int32_t proxy) const { return m_proxies[proxy].data; }
+		size_t GetProxyCount() const { return m_proxy_count; }
+		int GetSweepAxis() const { return m_axis; }
+
+		// Appends every pair of overlapping fat boxes involving a proxy created or moved since the last call. Each pair is
+		// ordered as (lower proxy, higher proxy) and reported once
+		void FindPairs(std::vector<Pair>& pairs);
+
+		// Calls callback(proxy) for every proxy whose fat box overlaps box. Returning false from the callback stops the query
+		template <typename F>
+		void Query(const AABB3D& box, F&& callback) const;
+
+		// Calls callback(proxy) for every proxy whose fat box passes the camera's frustum test
+		template <typename F>
+		void QueryFrustum(const Camera3D& camera, F&& callback) const;
+
+		// Calls callback(proxy, distance) for every proxy whose fat box is hit by the ray, nearest first. The callback returns
+		// the new maximum distance of the ray, so returning distance finds the closest hit and returning 0 stops the cast
+		template <typename F>
+		void Raycast(const zm::vec3& origin, const zm::vec3& direction, float max_distance, F&& callback) const;
+
+	private:
+		int ChooseAxis() const;
+		void SortAxis(int axis);
+		void RadixSort(std::vector<Endpoint>& endpoints);
+		void Sweep(int axis, std::vector<Pair>& pairs);
+		void RemoveActive(int32_t proxy);
+
+	private:
+		object_pool<Proxy, int32_t> m_proxies;
+		AABBBatch m_boxes;
+		std::vector<Endpoint> m_endpoints[3];
+		std::vector<int32_t> m_moved;
+		size_t m_proxy_count;
+		float m_margin;
+		int m_axis;
+
+		// Scratch buffers reused between sweeps
+		std::vector<Endpoint> m_sort_buffer;
+		std::vector<int32_t> m_active;
+		std::vector<float> m_active_bounds[4];
+		std::vector<int32_t> m_active_slot;
+	};
+
+	//========================================================================
+	//	Sweep and Prune Queries
+	//========================================================================
+
+	template <typename F>
+	void SweepAndPrune::Query(const AABB3D& box, F&& callback) const {
+		std::vector<uint32_t> results;
+		m_boxes.Overlaps(box, results);
+		for (uint32_t proxy : results)
+			if (m_proxies[proxy].alive && !callback(static_cast<int32_t>(proxy)))
+				return;
+	}
+
+	template <typename F>
+	void SweepAndPrune::QueryFrustum(const Camera3D& camera, F&& callback) const {
+		int32_t proxy = 0;
+		for (const Proxy& p : m_proxies) {
+			if (p.alive && camera.TestAABB(p.box.GetMin(), p.box.GetSize()))
+				callback(proxy);
+			proxy++;
+		}
+	}
+
+	template <typename F>
+	void SweepAndPrune::Raycast(const zm::vec3& origin, const zm::vec3& direction, float max_distance, F&& callback) const {
+		std::vector<AABBBatch::RayHit> hits;
+		m_boxes.Raycast(origin, direction, max_distance, hits);
+		std::sort(hits.begin(), hits.end(), [](const AABBBatch::RayHit& a, const AABBBatch::RayHit& b) {
+			return a.distance < b.distance;
+		});
+		for (const AABBBatch::RayHit& hit : hits) {
+			if (hit.distance > max_distance)
+				return;
+			if (!m_proxies[hit.index].alive)
+				continue;
+			max_distance = callback(static_cast<int32_t>(hit.index), hit.distance);
+			if (max_distance <= 0.f)
+				return;
+		}
+	}
+}
\ No newline at end of file
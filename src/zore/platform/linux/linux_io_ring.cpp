@@ -0,0 +1,229 @@
+#include "zore/platform.hpp"
+
+#if defined(PLATFORM_LINUX)
+#include "zore/platform/linux/linux_io_ring.hpp"
+#include "zore/debug.hpp"
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+
+namespace zore {
+
+	// The head and tail indices are shared with the kernel, so each side publishes its index only after the entries behind it
+	template<typename T>
+	static T LoadAcquire(T* value) {
+		return std::atomic_ref<T>(*value).load(std::memory_order_acquire);
+	}
+
+	template<typename T>
+	static void StoreRelease(T* value, T data) {
+		std::atomic_ref<T>(*value).store(data, std::memory_order_release);
+	}
+
+	//========================================================================
+	//	IO Ring
+	//========================================================================
+
+	// Every feature here has been in the kernel since 5.11
+	static constexpr uint32_t REQUIRED_FEATURES = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+
+	IORing::IORing() : m_handle(-1), m_features(0), m_ring(MAP_FAILED), m_ring_size(0), m_sqes(nullptr), m_sqes_size(0),
+		m_sq_head(nullptr), m_sq_tail(nullptr), m_sq_mask(0), m_sq_entries(0), m_sq_local_tail(0), m_cq_head(nullptr), m_cq_tail(nullptr),
+		m_cq_mask(0), m_cqes(nullptr), m_buffer_ring(nullptr), m_buffer_ring_size(0), m_buffers(nullptr), m_buffer_size(0), m_buffer_count(0),
+		m_buffer_group(0), m_buffer_tail(0), m_supported() {
+	}
+
+	IORing::~IORing() {
+		Free();
+	}
+
+	bool IORing::Init(uint32_t entries) {
+		Free();
+		io_uring_params params = {};
+		// Completions are only needed when the ring is entered to wait for them, so the kernel need not interrupt the thread
+		params.flags = IORING_SETUP_CLAMP | IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN;
+		m_handle = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+		if (m_handle < 0 && errno == EINVAL) {
+			params = {};
+			params.flags = IORING_SETUP_CLAMP;
+			m_handle = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+		}
+		if (m_handle < 0)
+			return false;
+		m_features = params.features;
+		if ((m_features & REQUIRED_FEATURES) != REQUIRED_FEATURES) {
+			Free();
+			return false;
+		}
+
+		// Both queues share one mapping, with the submission entries themselves in a second one
+		m_ring_size = std::max<size_t>(params.sq_off.array + params.sq_entries * sizeof(uint32_t), params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+		m_ring = mmap(nullptr, m_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_handle, IORING_OFF_SQ_RING);
+		m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+		void* sqes = mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_handle, IORING_OFF_SQES);
+		if (m_ring == MAP_FAILED || sqes == MAP_FAILED) {
+			if (sqes != MAP_FAILED)
+				munmap(sqes, m_sqes_size);
+			Free();
+			return false;
+		}
+		m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+		uint8_t* ring = static_cast<uint8_t*>(m_ring);
+		m_sq_head = reinterpret_cast<uint32_t*>(ring + params.sq_off.head);
+		m_sq_tail = reinterpret_cast<uint32_t*>(ring + params.sq_off.tail);
+		m_sq_mask = *reinterpret_cast<uint32_t*>(ring + params.sq_off.ring_mask);
+		m_sq_entries = params.sq_entries;
+		m_sq_local_tail = *m_sq_tail;
+		m_cq_head = reinterpret_cast<uint32_t*>(ring + params.cq_off.head);
+		m_cq_tail = reinterpret_cast<uint32_t*>(ring + params.cq_off.tail);
+		m_cq_mask = *reinterpret_cast<uint32_t*>(ring + params.cq_off.ring_mask);
+		m_cqes = reinterpret_cast<io_uring_cqe*>(ring + params.cq_off.cqes);
+		// Entries are always submitted in ring order, so the indirection array maps every slot to itself once
+		uint32_t* array = reinterpret_cast<uint32_t*>(ring + params.sq_off.array);
+		for (uint32_t i = 0; i < m_sq_entries; i++)
+			array[i] = i;
+
+		std::vector<uint8_t> probe_data(sizeof(io_uring_probe) + IORING_OP_LAST * sizeof(io_uring_probe_op), 0);
+		io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(probe_data.data());
+		if (syscall(__NR_io_uring_register, m_handle, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) == 0) {
+			for (uint32_t i = 0; i < std::min<uint32_t>(probe->ops_len, IORING_OP_LAST); i++)
+				m_supported[i] = (probe->ops[i].flags & IO_URING_OP_SUPPORTED) != 0;
+		}
+		return true;
+	}
+
+	bool IORing::Supports(uint8_t opcode) const {
+		return IsValid() && opcode < IORING_OP_LAST && m_supported[opcode];
+	}
+
+	io_uring_sqe* IORing::GetSubmission() {
+		if (m_sq_local_tail - LoadAcquire(m_sq_head) >= m_sq_entries) {
+			Submit();
+			if (m_sq_local_tail - LoadAcquire(m_sq_head) >= m_sq_entries)
+				return nullptr;
+		}
+		io_uring_sqe* sqe = &m_sqes[m_sq_local_tail & m_sq_mask];
+		std::memset(sqe, 0, sizeof(io_uring_sqe));
+		m_sq_local_tail++;
+		return sqe;
+	}
+
+	int IORing::Submit(uint32_t wait_for, float timeout) {
+		StoreRelease(m_sq_tail, m_sq_local_tail);
+		uint32_t to_submit = m_sq_local_tail - LoadAcquire(m_sq_head);
+		if (to_submit == 0 && (wait_for == 0 || GetPendingCompletions() >= wait_for))
+			return 0;
+
+		uint32_t flags = wait_for > 0 ? IORING_ENTER_GETEVENTS : 0;
+		__kernel_timespec time = {};
+		io_uring_getevents_arg arg = {};
+		void* argp = nullptr;
+		size_t arg_size = 0;
+		if (wait_for > 0 && timeout >= 0.f) {
+			time.tv_sec = static_cast<int64_t>(timeout);
+			time.tv_nsec = static_cast<int64_t>((timeout - static_cast<float>(time.tv_sec)) * 1e9f);
+			arg.ts = reinterpret_cast<uint64_t>(&time);
+			flags |= IORING_ENTER_EXT_ARG;
+			argp = &arg;
+			arg_size = sizeof(arg);
+		}
+		int result = static_cast<int>(syscall(__NR_io_uring_enter, m_handle, to_submit, wait_for, flags, argp, arg_size));
+		if (result < 0) {
+			// Timing out, being interrupted and a full completion queue all leave completions to be reaped as usual
+			if (errno != ETIME && errno != EINTR && errno != EBUSY && errno != EAGAIN)
+				Logger::Error("io_uring_enter failed: " + std::string(strerror(errno)));
+			return 0;
+		}
+		return result;
+	}
+
+	uint32_t IORing::Reap(io_uring_cqe* completions, uint32_t max) {
+		uint32_t head = *m_cq_head;
+		uint32_t count = std::min(LoadAcquire(m_cq_tail) - head, max);
+		for (uint32_t i = 0; i < count; i++)
+			completions[i] = m_cqes[(head + i) & m_cq_mask];
+		StoreRelease(m_cq_head, head + count);
+		return count;
+	}
+
+	uint32_t IORing::GetPendingCompletions() const {
+		return LoadAcquire(m_cq_tail) - *m_cq_head;
+	}
+
+	bool IORing::RegisterBufferRing(uint16_t group, uint16_t count, uint32_t size) {
+		DEBUG_ENSURE(count > 0 && (count & (count - 1)) == 0, "Buffer ring sizes must be a power of two");
+		if (!IsValid() || m_buffer_ring)
+			return false;
+		m_buffer_ring_size = count * sizeof(io_uring_buf);
+		void* ring = mmap(nullptr, m_buffer_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		void* buffers = mmap(nullptr, static_cast<size_t>(count) * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (ring == MAP_FAILED || buffers == MAP_FAILED) {
+			if (ring != MAP_FAILED)
+				munmap(ring, m_buffer_ring_size);
+			if (buffers != MAP_FAILED)
+				munmap(buffers, static_cast<size_t>(count) * size);
+			return false;
+		}
+
+		io_uring_buf_reg registration = {};
+		registration.ring_addr = reinterpret_cast<uint64_t>(ring);
+		registration.ring_entries = count;
+		registration.bgid = group;
+		if (syscall(__NR_io_uring_register, m_handle, IORING_REGISTER_PBUF_RING, &registration, 1) != 0) {
+			munmap(ring, m_buffer_ring_size);
+			munmap(buffers, static_cast<size_t>(count) * size);
+			return false;
+		}
+		m_buffer_ring = static_cast<io_uring_buf_ring*>(ring);
+		m_buffers = static_cast<uint8_t*>(buffers);
+		m_buffer_size = size;
+		m_buffer_count = count;
+		m_buffer_group = group;
+		m_buffer_tail = 0;
+		for (uint16_t id = 0; id < count; id++)
+			ReturnBuffer(id);
+		return true;
+	}
+
+	void IORing::ReturnBuffer(uint16_t id) {
+		// The header declares the entries as a flexible array behind an empty struct, which C++ gives a size, so they are
+		// indexed from the start of the ring directly. The tail overlays the first entry
+		io_uring_buf& buffer = reinterpret_cast<io_uring_buf*>(m_buffer_ring)[m_buffer_tail & (m_buffer_count - 1)];
+		buffer.addr = reinterpret_cast<uint64_t>(GetBuffer(id));
+		buffer.len = m_buffer_size;
+		buffer.bid = id;
+		StoreRelease(&m_buffer_ring->tail, ++m_buffer_tail);
+	}
+
+	void IORing::Free() {
+		if (m_buffer_ring) {
+			io_uring_buf_reg registration = {};
+			registration.bgid = m_buffer_group;
+			syscall(__NR_io_uring_register, m_handle, IORING_UNREGISTER_PBUF_RING, &registration, 1);
+		}
+		// Closing the ring cancels anything still in flight
+		if (m_handle >= 0)
+			close(m_handle);
+		if (m_buffer_ring) {
+			munmap(m_buffer_ring, m_buffer_ring_size);
+			munmap(m_buffers, static_cast<size_t>(m_buffer_count) * m_buffer_size);
+		}
+		if (m_sqes)
+			munmap(m_sqes, m_sqes_size);
+		if (m_ring != MAP_FAILED)
+			munmap(m_ring, m_ring_size);
+		m_handle = -1;
+		m_ring = MAP_FAILED;
+		m_sqes = nullptr;
+		m_buffer_ring = nullptr;
+		m_buffers = nullptr;
+		std::fill(std::begin(m_supported), std::end(m_supported), 0);
+	}
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "zore/utils/sized_integer.hpp"
+#include <linux/io_uring.h>
+
+namespace zore {
+
+	//========================================================================
+	//	IO Ring
+	//========================================================================
+
+	// A thin wrapper over an io_uring instance, set up through the raw system calls. Submissions are queued in shared memory
+	// and handed to the kernel in a single call, which also waits for completions, so a batch of operations costs one system
+	// call rather than one each. Only one thread may use an instance at a time
+	class IORing {
+	public:
+		IORing();
+		IORing(const IORing&) = delete;
+		IORing& operator=(const IORing&) = delete;
+		~IORing();
+
+		// Returns false if the kernel does not support io_uring, or lacks the features this wrapper relies on
+		bool Init(uint32_t entries);
+		bool IsValid() const { return m_handle >= 0; }
+		bool Supports(uint8_t opcode) const;
+
+		// Returns a cleared submission to fill in, submitting what is queued first if the queue is full
+		io_uring_sqe* GetSubmission();
+		// Submits everything queued, and waits until at least {wait_for} completions are ready or timeout seconds pass. A
+		// negative timeout waits without limit. Returns the number of submissions the kernel took
+		int Submit(uint32_t wait_for = 0, float timeout = -1.f);
+		// Copies out up to {max} ready completions, and frees their slots
+		uint32_t Reap(io_uring_cqe* completions, uint32_t max);
+		uint32_t GetPendingCompletions() const;
+
+		// Registers {count} buffers of {size} bytes as buffer group {group}, for receives that pick their own buffer. The
+		// buffer used is reported in the completion flags, and must be returned once its data has been consumed
+		bool RegisterBufferRing(uint16_t group, uint16_t count, uint32_t size);
+		uint8_t* GetBuffer(uint16_t id) const { return m_buffers + static_cast<size_t>(id) * m_buffer_size; }
+		void ReturnBuffer(uint16_t id);
+
+	private:
+		void Free();
+
+	private:
+		int m_handle;
+		uint32_t m_features;
+		void* m_ring;
+		size_t m_ring_size;
+		io_uring_sqe* m_sqes;
+		size_t m_sqes_size;
+
+		uint32_t* m_sq_head;
+		uint32_t* m_sq_tail;
+		uint32_t m_sq_mask;
+		uint32_t m_sq_entries;
+		// Submissions are filled up to the local tail, and only published to the kernel when submitted
+		uint32_t m_sq_local_tail;
+		uint32_t* m_cq_head;
+		uint32_t* m_cq_tail;
+		uint32_t m_cq_mask;
+		io_uring_cqe* m_cqes;
+
+		io_uring_buf_ring* m_buffer_ring;
+		size_t m_buffer_ring_size;
+		uint8_t* m_buffers;
+		uint32_t m_buffer_size;
+		uint16_t m_buffer_count;
+		uint16_t m_buffer_group;
+		uint16_t m_buffer_tail;
+
+		uint8_t m_supported[IORING_OP_LAST];
+	};
+}
\ No newline at end of file
@@ -15,17 +15,21 @@ namespace zore {
 	//========================================================================
 
 	static int* s_data = nullptr;
+	static int s_function_count = 0;
 
 	void Processor::Init() {
 		delete[] s_data;
-		uint32_t function_count = GetCPUIDCount();
-		s_data = new int[function_count * 4];
-		for (uint32_t i = 0; i < function_count; i++)
+		// The highest supported function id is inclusive
+		s_function_count = GetCPUIDCount() + 1;
+		s_data = new int[s_function_count * 4];
+		for (int i = 0; i < s_function_count; i++)
 			GetCPUID(i, &s_data[i * 4]);
 	}
 
 	void Processor::Free() {
 		delete[] s_data;
+		s_data = nullptr;
+		s_function_count = 0;
 	}
 
 	std::string Processor::GetVendor() {
@@ -39,7 +43,21 @@ namespace zore {
 		return result;
 	}
 
+	int Processor::GetFamily() {
+		int info = Get(1, 0);
+		int family = (info >> 8) & 0xF;
+		if (family == 0xF)
+			family += (info >> 20) & 0xFF;
+		return family;
+	}
+
+	bool Processor::HasBMI2() {
+		return (Get(7, 1) >> 8) & 1;
+	}
+
 	int Processor::Get(int function_id, int reg) {
+		if (function_id >= s_function_count)
+			return 0;
 		return s_data[(function_id * 4) + reg];
 	}
 
@@ -55,9 +73,10 @@ namespace zore {
 
 	void Processor::GetCPUID(int function_id, int info[4]) {
 #if defined(PLATFORM_WINDOWS)
-		__cpuid(info, function_id);
+		__cpuidex(info, function_id, 0);
 #elif defined(PLATFORM_LINUX)
-		__get_cpuid(function_id, &info[0], &info[1], &info[2], &info[3]);
+		unsigned int* registers = reinterpret_cast<unsigned int*>(info);
+		__get_cpuid_count(function_id, 0, &registers[0], &registers[1], &registers[2], &registers[3]);
 #endif
 	}
 }
\ No newline at end of file
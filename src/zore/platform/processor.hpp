@@ -9,6 +9,8 @@ namespace zore {
 		static void Init();
 		static void Free();
 		static std::string GetVendor();
+		static int GetFamily();
+		static bool HasBMI2();
 
 	private:
 		static inline int Get(int function_id, int reg);
@@ -1,8 +1,32 @@
 #include "zore/structures/thread_pool.hpp"
 #include <algorithm>
+#include <limits>
 
 namespace zore {
 
+	//========================================================================
+	//	Parallel For Job
+	//=========================================================================
+
+	void parallel_for_state::run() {
+		size_t finished = 0;
+		for (size_t chunk = next.fetch_add(1); chunk < chunks; chunk = next.fetch_add(1)) {
+			size_t begin = chunk * grain;
+			invoke(func, begin, std::min(begin + grain, count));
+			finished++;
+		}
+		if (finished > 0 && done.fetch_add(finished) + finished == chunks)
+			done.notify_all();
+	}
+
+	void parallel_for_state::wait() {
+		for (size_t finished = done.load(); finished != chunks; finished = done.load())
+			done.wait(finished);
+	}
+
+	// Helper jobs jump the queue, since the thread that dispatched them is blocked until they finish
+	parallel_for_job::parallel_for_job(std::shared_ptr<parallel_for_state> state) : Job(std::numeric_limits<int>::max()), m_state(std::move(state)) {}
+
 	//========================================================================
 	//	Threadpool
 	//=========================================================================
@@ -48,6 +72,18 @@ namespace zore {
 		}
 	}
 
+	void thread_pool::dispatch(const std::shared_ptr<parallel_for_state>& state) {
+		// The calling thread takes one share of the chunks itself
+		size_t helpers = std::min(state->chunks - 1, m_threads.size());
+		if (helpers == 0)
+			return;
+		std::lock_guard<std::mutex> lock(m_job_mutex);
+		m_jobs.insert(m_jobs.begin(), helpers, nullptr);
+		for (size_t i = 0; i < helpers; i++)
+			m_jobs[i] = new parallel_for_job(state);
+		cv.notify_all();
+	}
+
 	Job* thread_pool::pop() {
 		std::unique_lock<std::mutex> lock(m_job_mutex);
 		cv.wait(lock, [&] { return !m_jobs.empty() || !m_running; });
@@ -8,6 +8,9 @@
 #include <unordered_map>
 #include <typeindex>
 #include <functional>
+#include <algorithm>
+#include <atomic>
+#include <memory>
 
 namespace zore {
 
@@ -56,6 +59,35 @@ namespace zore {
 		job_callback<T> m_callback;
 	};
 
+	//========================================================================
+	//	Parallel For Job Class
+	//========================================================================
+
+	// Shared by the calling thread and the helper jobs of a single parallel_for call. Whoever is free claims the next chunk
+	struct parallel_for_state {
+		void (*invoke)(const void*, size_t, size_t) = nullptr;
+		const void* func = nullptr;
+		size_t count = 0;
+		size_t grain = 1;
+		size_t chunks = 0;
+		std::atomic<size_t> next = 0;
+		std::atomic<size_t> done = 0;
+
+		void run();
+		void wait();
+	};
+
+	class parallel_for_job : public Job {
+	public:
+		explicit parallel_for_job(std::shared_ptr<parallel_for_state> state);
+		~parallel_for_job() override = default;
+
+		void execute() override { m_state->run(); }
+
+	private:
+		std::shared_ptr<parallel_for_state> m_state;
+	};
+
 	//========================================================================
 	//	Threadpool Class
 	//========================================================================
@@ -97,9 +129,27 @@ namespace zore {
 			cv.notify_one();
 		}
 
+		// Calls func(begin, end) over [0, count) in chunks of {grain} items, and returns once every chunk has finished. The calling
+		// thread works through chunks as well, so this is safe to call from inside a job
+		template <typename F>
+		void parallel_for(size_t count, size_t grain, F&& func) {
+			if (count == 0)
+				return;
+			std::shared_ptr<parallel_for_state> state = std::make_shared<parallel_for_state>();
+			state->invoke = [](const void* f, size_t begin, size_t end) { (*static_cast<const std::remove_reference_t<F>*>(f))(begin, end); };
+			state->func = &func;
+			state->count = count;
+			state->grain = std::max(grain, size_t(1));
+			state->chunks = (count + state->grain - 1) / state->grain;
+			dispatch(state);
+			state->run();
+			state->wait();
+		}
+
 	private:
 		void thread_loop();
 		Job* pop();
+		void dispatch(const std::shared_ptr<parallel_for_state>& state);
 
 	private:
 		std::vector<std::thread> m_threads;
@@ -0,0 +1,71 @@
+#include "zore/utils/hash.hpp"
+#include <cstring>
+#include <bit>
+
+namespace zore {
+
+	static constexpr uint64_t PRIME_1 = 11400714785074694791ull;
+	static constexpr uint64_t PRIME_2 = 14029467366897019727ull;
+	static constexpr uint64_t PRIME_3 = 1609587929392839161ull;
+	static constexpr uint64_t PRIME_4 = 9650029242287828579ull;
+	static constexpr uint64_t PRIME_5 = 2870177450012600261ull;
+
+	template<typename T>
+	static T Read(const uint8_t* data) {
+		T value;
+		std::memcpy(&value, data, sizeof(T));
+		return value;
+	}
+
+	static uint64_t Round(uint64_t accumulator, uint64_t input) {
+		accumulator += input * PRIME_2;
+		return std::rotl(accumulator, 31) * PRIME_1;
+	}
+
+	static uint64_t Merge(uint64_t hash, uint64_t accumulator) {
+		hash ^= Round(0, accumulator);
+		return hash * PRIME_1 + PRIME_4;
+	}
+
+	//========================================================================
+	//	Hash Utility
+	//========================================================================
+
+	uint64_t Hash::XXH64(std::span<const char> data, uint64_t seed) {
+		const uint8_t* current = reinterpret_cast<const uint8_t*>(data.data());
+		const uint8_t* end = current + data.size();
+		uint64_t hash;
+
+		if (data.size() >= 32) {
+			// Four independent lanes consume 32 byte stripes, so the multiplies can overlap
+			uint64_t lanes[4] = { seed + PRIME_1 + PRIME_2, seed + PRIME_2, seed, seed - PRIME_1 };
+			for (; end - current >= 32; current += 32) {
+				for (int i = 0; i < 4; i++)
+					lanes[i] = Round(lanes[i], Read<uint64_t>(current + i * 8));
+			}
+			hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+			for (int i = 0; i < 4; i++)
+				hash = Merge(hash, lanes[i]);
+		}
+		else {
+			hash = seed + PRIME_5;
+		}
+
+		hash += data.size();
+		for (; end - current >= 8; current += 8)
+			hash = std::rotl(hash ^ Round(0, Read<uint64_t>(current)), 27) * PRIME_1 + PRIME_4;
+		if (end - current >= 4) {
+			hash = std::rotl(hash ^ (Read<uint32_t>(current) * PRIME_1), 23) * PRIME_2 + PRIME_3;
+			current += 4;
+		}
+		for (; current < end; current++)
+			hash = std::rotl(hash ^ (*current * PRIME_5), 11) * PRIME_1;
+
+		hash ^= hash >> 33;
+		hash *= PRIME_2;
+		hash ^= hash >> 29;
+		hash *= PRIME_3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+}
\ No newline at end of file
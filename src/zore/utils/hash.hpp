@@ -0,0 +1,17 @@
+#pragma once
+
+#include <span>
+#include <cstdint>
+
+namespace zore {
+
+	//========================================================================
+	//	Hash Utility
+	//========================================================================
+
+	class Hash {
+	public:
+		// 64 bit xxHash, for telling file contents apart quickly. Not suitable where collisions could be forced on purpose
+		static uint64_t XXH64(std::span<const char> data, uint64_t seed = 0);
+	};
+}
\ No newline at end of file
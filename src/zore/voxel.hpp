@@ -0,0 +1,6 @@
+#pragma once
+
+#include "zore/voxel/palette_storage.hpp"
+#include "zore/voxel/chunk.hpp"
+#include "zore/voxel/mesher.hpp"
+#include "zore/voxel/raycast.hpp"
\ No newline at end of file
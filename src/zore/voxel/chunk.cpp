@@ -0,0 +1,45 @@
+#include "zore/voxel/chunk.hpp"
+#include "zore/debug.hpp"
+
+namespace zore::voxel {
+
+	//========================================================================
+	//	Voxel Chunk
+	//========================================================================
+
+	Chunk::Chunk(block_t fill) : m_blocks(VOLUME, fill) {}
+
+	block_t Chunk::Get(int32_t x, int32_t y, int32_t z) const {
+		DEBUG_ENSURE(x >= 0 && x < SIZE && y >= 0 && y < SIZE && z >= 0 && z < SIZE, "Chunk coordinate out of range");
+		return m_blocks.Get(Index(x, y, z));
+	}
+
+	block_t Chunk::Get(const zm::ivec3& position) const {
+		return Get(position.x, position.y, position.z);
+	}
+
+	void Chunk::Set(int32_t x, int32_t y, int32_t z, block_t block) {
+		DEBUG_ENSURE(x >= 0 && x < SIZE && y >= 0 && y < SIZE && z >= 0 && z < SIZE, "Chunk coordinate out of range");
+		m_blocks.Set(Index(x, y, z), block);
+	}
+
+	void Chunk::Set(const zm::ivec3& position, block_t block) {
+		Set(position.x, position.y, position.z, block);
+	}
+
+	void Chunk::Fill(block_t block) {
+		m_blocks.Fill(block);
+	}
+
+	void Chunk::Unpack(block_t* out) const {
+		m_blocks.Unpack(out);
+	}
+
+	void Chunk::Compact() {
+		m_blocks.Compact();
+	}
+
+	bool Chunk::IsEmpty() const {
+		return m_blocks.GetBitsPerIndex() == 0 && m_blocks.GetPalette()[0] == AIR;
+	}
+}
\ No newline at end of file
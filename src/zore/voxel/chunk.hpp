@@ -0,0 +1,41 @@
+#pragma once
+
+#include "zore/voxel/palette_storage.hpp"
+#include "zore/math/vector/vec3.hpp"
+
+namespace zore::voxel {
+
+	//========================================================================
+	//	Voxel Chunk
+	//========================================================================
+
+	class Chunk {
+	public:
+		static constexpr int32_t SIZE_BITS = 5;
+		static constexpr int32_t SIZE = 1 << SIZE_BITS;
+		static constexpr int32_t AREA = SIZE * SIZE;
+		static constexpr int32_t VOLUME = AREA * SIZE;
+
+	public:
+		Chunk(block_t fill = AIR);
+		~Chunk() = default;
+
+		block_t Get(int32_t x, int32_t y, int32_t z) const;
+		block_t Get(const zm::ivec3& position) const;
+		void Set(int32_t x, int32_t y, int32_t z, block_t block);
+		void Set(const zm::ivec3& position, block_t block);
+		void Fill(block_t block);
+		void Unpack(block_t* out) const;
+		void Compact();
+		bool IsEmpty() const;
+
+		PaletteStorage& GetStorage() { return m_blocks; }
+		const PaletteStorage& GetStorage() const { return m_blocks; }
+
+		// Blocks are stored x-major, so consecutive indices walk along the x axis
+		static inline uint32_t Index(int32_t x, int32_t y, int32_t z) { return x | (y << SIZE_BITS) | (z << (SIZE_BITS * 2)); }
+
+	private:
+		PaletteStorage m_blocks;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "zore/voxel/mesher.hpp"
+#include "zore/utils/bits.hpp"
+#include "zore/debug/profiler.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace zore::voxel {
+
+	//========================================================================
+	//	Greedy Chunk Mesher
+	//========================================================================
+
+	static constexpr int32_t SIZE = Chunk::SIZE;
+	static constexpr uint32_t STRIDE[3] = { 1u, static_cast<uint32_t>(Chunk::SIZE), static_cast<uint32_t>(Chunk::AREA) };
+
+	// Columns run along an axis, and are padded by one bit on each end to hold the neighbouring chunks' boundary
+	static inline uint32_t ColumnIndex(int32_t axis, int32_t u, int32_t v) {
+		return (axis * Chunk::AREA) + (v * SIZE) + u;
+	}
+
+	// Face rows hold one bit per u coordinate, for a given face, depth along the face normal and v coordinate
+	static inline uint32_t FaceRowIndex(int32_t face, int32_t depth, int32_t v) {
+		return (face * Chunk::AREA) + (depth * SIZE) + v;
+	}
+
+	Mesher::Mesher() : m_blocks(Chunk::VOLUME), m_columns(3 * Chunk::AREA), m_faces(6 * Chunk::AREA) {}
+
+	void Mesher::Mesh(const Chunk& chunk, std::vector<Quad>& out, const Neighbours& neighbours) {
+		ZoneScoped;
+		if (chunk.IsEmpty())
+			return;
+
+		chunk.Unpack(m_blocks.data());
+		BuildColumns(neighbours);
+		BuildFaceMasks();
+		MergeFaces(out);
+	}
+
+	Mesher::Quad Mesher::Pack(int32_t x, int32_t y, int32_t z, Face face, int32_t width, int32_t height, block_t block) {
+		Quad quad = { 0u, static_cast<uint32_t>(block) };
+		PACK_BITS(quad.position, static_cast<uint32_t>(x), 0);
+		PACK_BITS(quad.position, static_cast<uint32_t>(y), 5);
+		PACK_BITS(quad.position, static_cast<uint32_t>(z), 10);
+		PACK_BITS(quad.position, static_cast<uint32_t>(face), 15);
+		PACK_BITS(quad.position, static_cast<uint32_t>(width - 1), 18);
+		PACK_BITS(quad.position, static_cast<uint32_t>(height - 1), 23);
+		return quad;
+	}
+
+	VertexElement Mesher::GetVertexElement(const std::string& name) {
+		return VertexElement(name, VertexElement::Type::INT_32, 2);
+	}
+
+	void Mesher::BuildColumns(const Neighbours& neighbours) {
+		std::fill(m_columns.begin(), m_columns.end(), 0ULL);
+
+		const block_t* block = m_blocks.data();
+		for (int32_t z = 0; z < SIZE; z++) {
+			for (int32_t y = 0; y < SIZE; y++) {
+				for (int32_t x = 0; x < SIZE; x++, block++) {
+					if (*block == AIR)
+						continue;
+					m_columns[ColumnIndex(0, y, z)] |= 1ULL << (x + 1);
+					m_columns[ColumnIndex(1, z, x)] |= 1ULL << (y + 1);
+					m_columns[ColumnIndex(2, x, y)] |= 1ULL << (z + 1);
+				}
+			}
+		}
+
+		for (int32_t axis = 0; axis < 3; axis++) {
+			const Chunk* positive = neighbours[axis * 2];
+			const Chunk* negative = neighbours[axis * 2 + 1];
+			if (!positive && !negative)
+				continue;
+
+			int32_t p[3];
+			for (int32_t v = 0; v < SIZE; v++) {
+				for (int32_t u = 0; u < SIZE; u++) {
+					p[(axis + 1) % 3] = u;
+					p[(axis + 2) % 3] = v;
+					uint64_t& column = m_columns[ColumnIndex(axis, u, v)];
+					if (negative) {
+						p[axis] = SIZE - 1;
+						if (negative->Get(p[0], p[1], p[2]) != AIR)
+							column |= 1ULL;
+					}
+					if (positive) {
+						p[axis] = 0;
+						if (positive->Get(p[0], p[1], p[2]) != AIR)
+							column |= 1ULL << (SIZE + 1);
+					}
+				}
+			}
+		}
+	}
+
+	void Mesher::BuildFaceMasks() {
+		std::fill(m_faces.begin(), m_faces.end(), 0u);
+
+		for (int32_t axis = 0; axis < 3; axis++) {
+			for (int32_t v = 0; v < SIZE; v++) {
+				for (int32_t u = 0; u < SIZE; u++) {
+					// A face is visible where a solid voxel is followed by an empty one along the column
+					uint64_t column = m_columns[ColumnIndex(axis, u, v)];
+					uint32_t visible[2] = {
+						static_cast<uint32_t>((column & ~(column >> 1)) >> 1),
+						static_cast<uint32_t>((column & ~(column << 1)) >> 1)
+					};
+
+					for (int32_t side = 0; side < 2; side++) {
+						int32_t face = axis * 2 + side;
+						for (uint32_t mask = visible[side]; mask; mask &= mask - 1)
+							m_faces[FaceRowIndex(face, std::countr_zero(mask), v)] |= 1u << u;
+					}
+				}
+			}
+		}
+	}
+
+	void Mesher::MergeFaces(std::vector<Quad>& out) {
+		for (int32_t face = 0; face < 6; face++) {
+			const int32_t axis = face >> 1;
+			const uint32_t stride_u = STRIDE[(axis + 1) % 3];
+			const uint32_t stride_v = STRIDE[(axis + 2) % 3];
+
+			for (int32_t depth = 0; depth < SIZE; depth++) {
+				uint32_t* rows = &m_faces[FaceRowIndex(face, depth, 0)];
+				const block_t* slice = m_blocks.data() + (depth * STRIDE[axis]);
+
+				auto matches = [&](int32_t u, int32_t v, int32_t width, block_t block) {
+					for (int32_t i = 0; i < width; i++)
+						if (slice[(u + i) * stride_u + v * stride_v] != block)
+							return false;
+					return true;
+				};
+
+				for (int32_t v = 0; v < SIZE; v++) {
+					while (rows[v]) {
+						int32_t u = std::countr_zero(rows[v]);
+						block_t block = slice[u * stride_u + v * stride_v];
+
+						// Grow along u while the face is visible and shares the same material
+						int32_t width = 1;
+						while (u + width < SIZE && ((rows[v] >> (u + width)) & 1u) && slice[(u + width) * stride_u + v * stride_v] == block)
+							width++;
+
+						// Grow along v while the entire span is visible and shares the same material
+						uint32_t span = (width == SIZE ? ~0u : ((1u << width) - 1u)) << u;
+						int32_t height = 1;
+						while (v + height < SIZE && (rows[v + height] & span) == span && matches(u, v + height, width, block))
+							height++;
+
+						for (int32_t i = 0; i < height; i++)
+							rows[v + i] &= ~span;
+
+						int32_t p[3];
+						p[axis] = depth;
+						p[(axis + 1) % 3] = u;
+						p[(axis + 2) % 3] = v;
+						out.push_back(Pack(p[0], p[1], p[2], static_cast<Face>(face), width, height, block));
+					}
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
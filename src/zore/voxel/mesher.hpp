@@ -0,0 +1,49 @@
+#pragma once
+
+#include "zore/voxel/chunk.hpp"
+#include "zore/graphics/vertex_layout.hpp"
+#include <array>
+#include <vector>
+
+namespace zore::voxel {
+
+	//========================================================================
+	//	Greedy Chunk Mesher
+	//========================================================================
+
+	class Mesher {
+	public:
+		enum class Face { POS_X, NEG_X, POS_Y, NEG_Y, POS_Z, NEG_Z };
+		using Neighbours = std::array<const Chunk*, 6>;
+
+		// A single merged face, consumed as one instance of an INT_32 x2 vertex attribute
+		// position: x[0:5] y[5:10] z[10:15] face[15:18] width-1[18:23] height-1[23:28]
+		// material: block[0:16]
+		struct Quad {
+			uint32_t position;
+			uint32_t material;
+		};
+
+	public:
+		Mesher();
+		Mesher(const Mesher&) = delete;
+		Mesher& operator=(const Mesher&) = delete;
+		~Mesher() = default;
+
+		// Appends the greedy meshed faces of chunk to out. Neighbours are indexed by Face, and missing neighbours are treated as air
+		void Mesh(const Chunk& chunk, std::vector<Quad>& out, const Neighbours& neighbours = {});
+
+		static Quad Pack(int32_t x, int32_t y, int32_t z, Face face, int32_t width, int32_t height, block_t block);
+		static VertexElement GetVertexElement(const std::string& name = "quad");
+
+	private:
+		void BuildColumns(const Neighbours& neighbours);
+		void BuildFaceMasks();
+		void MergeFaces(std::vector<Quad>& out);
+
+	private:
+		std::vector<block_t> m_blocks;
+		std::vector<uint64_t> m_columns;
+		std::vector<uint32_t> m_faces;
+	};
+}
\ No newline at end of file
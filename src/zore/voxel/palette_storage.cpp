@@ -0,0 +1,127 @@
+#include "zore/voxel/palette_storage.hpp"
+#include "zore/utils/bits.hpp"
+#include "zore/debug.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace zore::voxel {
+
+	//========================================================================
+	//	Palette Compressed Block Storage
+	//========================================================================
+
+	PaletteStorage::PaletteStorage(uint32_t size, block_t initial) : m_palette{ initial }, m_size(size), m_bits(0), m_shift(0) {
+		ENSURE(size > 0, "Palette storage must contain at least one entry");
+	}
+
+	block_t PaletteStorage::Get(uint32_t index) const {
+		DEBUG_ENSURE(index < m_size, "Palette storage index out of range");
+		return m_palette[GetPaletteIndex(index)];
+	}
+
+	void PaletteStorage::Set(uint32_t index, block_t block) {
+		DEBUG_ENSURE(index < m_size, "Palette storage index out of range");
+		if (m_bits == 0 && m_palette[0] == block)
+			return;
+		uint64_t palette_index = FindOrInsert(block);
+		uint32_t offset = (index & ((1u << m_shift) - 1)) * m_bits;
+		SET_N_BITS(m_words[index >> m_shift], palette_index, m_bits, offset);
+	}
+
+	void PaletteStorage::Fill(block_t block) {
+		m_palette.assign(1, block);
+		m_words.clear();
+		m_words.shrink_to_fit();
+		m_bits = 0;
+		m_shift = 0;
+	}
+
+	void PaletteStorage::Unpack(block_t* out) const {
+		if (m_bits == 0) {
+			std::fill(out, out + m_size, m_palette[0]);
+			return;
+		}
+
+		const uint32_t per_word = 1u << m_shift;
+		const uint64_t mask = ~(~0ULL << m_bits);
+		uint32_t index = 0;
+		for (uint64_t word : m_words) {
+			uint32_t count = std::min(per_word, m_size - index);
+			for (uint32_t i = 0; i < count; i++, word >>= m_bits)
+				out[index++] = m_palette[word & mask];
+		}
+	}
+
+	void PaletteStorage::Compact() {
+		if (m_bits == 0)
+			return;
+
+		std::vector<uint8_t> used(m_palette.size(), 0);
+		for (uint32_t i = 0; i < m_size; i++)
+			used[GetPaletteIndex(i)] = 1;
+
+		std::vector<block_t> palette;
+		std::vector<uint32_t> remap(m_palette.size(), 0);
+		for (size_t i = 0; i < m_palette.size(); i++) {
+			if (used[i]) {
+				remap[i] = static_cast<uint32_t>(palette.size());
+				palette.push_back(m_palette[i]);
+			}
+		}
+
+		if (palette.size() == m_palette.size())
+			return;
+		Repack(BitsFor(palette.size()), &remap);
+		m_palette = std::move(palette);
+	}
+
+	size_t PaletteStorage::GetMemoryUsage() const {
+		return sizeof(PaletteStorage) + (m_palette.capacity() * sizeof(block_t)) + (m_words.capacity() * sizeof(uint64_t));
+	}
+
+	uint32_t PaletteStorage::GetPaletteIndex(uint32_t index) const {
+		if (m_bits == 0)
+			return 0;
+		uint32_t offset = (index & ((1u << m_shift) - 1)) * m_bits;
+		return static_cast<uint32_t>(GET_N_BITS(m_words[index >> m_shift], m_bits, offset));
+	}
+
+	uint32_t PaletteStorage::FindOrInsert(block_t block) {
+		auto iter = std::find(m_palette.begin(), m_palette.end(), block);
+		if (iter != m_palette.end())
+			return static_cast<uint32_t>(iter - m_palette.begin());
+
+		m_palette.push_back(block);
+		uint32_t bits = BitsFor(m_palette.size());
+		if (bits != m_bits)
+			Repack(bits);
+		return static_cast<uint32_t>(m_palette.size() - 1);
+	}
+
+	void PaletteStorage::Repack(uint32_t bits, const std::vector<uint32_t>* remap) {
+		std::vector<uint64_t> words;
+		uint32_t shift = 0;
+		if (bits > 0) {
+			// Entries never straddle a word boundary, so the number of entries per word is always a power of two
+			shift = std::countr_zero(64u / bits);
+			words.assign(((m_size - 1) >> shift) + 1, 0);
+			for (uint32_t i = 0; i < m_size; i++) {
+				uint64_t value = GetPaletteIndex(i);
+				if (remap)
+					value = (*remap)[value];
+				uint32_t offset = (i & ((1u << shift) - 1)) * bits;
+				PACK_BITS(words[i >> shift], value, offset);
+			}
+		}
+		m_words = std::move(words);
+		m_bits = bits;
+		m_shift = shift;
+	}
+
+	uint32_t PaletteStorage::BitsFor(size_t palette_size) {
+		if (palette_size <= 1)
+			return 0;
+		uint32_t bits = std::bit_width(palette_size - 1);
+		return std::bit_ceil(bits);
+	}
+}
\ No newline at end of file
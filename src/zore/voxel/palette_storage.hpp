@@ -0,0 +1,50 @@
+#pragma once
+
+#include "zore/utils/sized_integer.hpp"
+#include <vector>
+
+namespace zore::voxel {
+
+	using block_t = uint16_t;
+	static constexpr block_t AIR = 0;
+
+	//========================================================================
+	//	Palette Compressed Block Storage
+	//========================================================================
+
+	class PaletteStorage {
+	public:
+		PaletteStorage(uint32_t size, block_t initial = AIR);
+		PaletteStorage(const PaletteStorage&) = default;
+		PaletteStorage(PaletteStorage&&) noexcept = default;
+		PaletteStorage& operator=(const PaletteStorage&) = default;
+		PaletteStorage& operator=(PaletteStorage&&) noexcept = default;
+		~PaletteStorage() = default;
+
+		block_t Get(uint32_t index) const;
+		void Set(uint32_t index, block_t block);
+		void Fill(block_t block);
+		// Decodes every entry into out, which must hold at least Size() blocks
+		void Unpack(block_t* out) const;
+		// Removes palette entries which are no longer referenced, and shrinks the index width to match
+		void Compact();
+
+		uint32_t Size() const { return m_size; }
+		uint32_t GetBitsPerIndex() const { return m_bits; }
+		const std::vector<block_t>& GetPalette() const { return m_palette; }
+		size_t GetMemoryUsage() const;
+
+	private:
+		uint32_t GetPaletteIndex(uint32_t index) const;
+		uint32_t FindOrInsert(block_t block);
+		void Repack(uint32_t bits, const std::vector<uint32_t>* remap = nullptr);
+		static uint32_t BitsFor(size_t palette_size);
+
+	private:
+		std::vector<block_t> m_palette;
+		std::vector<uint64_t> m_words;
+		uint32_t m_size;
+		uint32_t m_bits;
+		uint32_t m_shift;
+	};
+}
\ No newline at end of file
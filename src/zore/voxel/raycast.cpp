@@ -0,0 +1,218 @@
+#include "zore/voxel/raycast.hpp"
+#include "zore/math/simd.hpp"
+#include "zore/debug/profiler.hpp"
+#include "zore/debug.hpp"
+#include <bit>
+#include <cmath>
+
+namespace zore::voxel {
+
+	//========================================================================
+	//	Voxel Hit Buffer
+	//========================================================================
+
+	void VoxelHits::Reset(size_t count) {
+		distance.assign(count, std::numeric_limits<float>::infinity());
+		block.assign(count, AIR);
+		for (int i = 0; i < 3; i++) {
+			position[i].assign(count, 0);
+			normal[i].assign(count, 0);
+		}
+	}
+
+	VoxelHit VoxelHits::Get(uint32_t index) const {
+		return {
+			{ position[0][index], position[1][index], position[2][index] },
+			{ normal[0][index], normal[1][index], normal[2][index] },
+			distance[index],
+			block[index]
+		};
+	}
+
+	static void Record(VoxelHits& hits, uint32_t index, const VoxelHit& hit) {
+		hits.distance[index] = hit.distance;
+		hits.block[index] = hit.block;
+		for (int i = 0; i < 3; i++) {
+			hits.position[i][index] = hit.position[i];
+			hits.normal[i][index] = static_cast<int8_t>(hit.normal[i]);
+		}
+	}
+
+	//========================================================================
+	//	Voxel Ray Casting
+	//========================================================================
+
+	bool Raycast(const zm::vec3& origin, const zm::vec3& direction, float max_distance, const ChunkLookup& lookup, VoxelHit& hit) {
+		DEBUG_ENSURE(std::isfinite(max_distance), "Voxel ray casts need a finite max distance");
+		BlockSampler sampler(lookup);
+		zm::ivec3 cell = zm::ivec3(zm::Floor(origin));
+		zm::ivec3 step;
+		zm::vec3 t_delta, t_max;
+		for (int i = 0; i < 3; i++) {
+			// t_max is the distance along the ray to the next block boundary on each axis, and t_delta the distance between boundaries
+			step[i] = direction[i] > 0.f ? 1 : (direction[i] < 0.f ? -1 : 0);
+			t_delta[i] = std::abs(1.f / direction[i]);
+			if (step[i] > 0)
+				t_max[i] = (static_cast<float>(cell[i]) + 1.f - origin[i]) * t_delta[i];
+			else if (step[i] < 0)
+				t_max[i] = (origin[i] - static_cast<float>(cell[i])) * t_delta[i];
+			else
+				t_max[i] = std::numeric_limits<float>::infinity();
+		}
+
+		float t = 0.f;
+		int axis = -1;
+		while (t <= max_distance) {
+			block_t block = sampler.Get(cell);
+			if (block != AIR) {
+				zm::ivec3 normal(0);
+				if (axis >= 0)
+					normal[axis] = -step[axis];
+				hit = { cell, normal, t, block };
+				return true;
+			}
+			axis = t_max.x <= t_max.y && t_max.x <= t_max.z ? 0 : (t_max.y <= t_max.z ? 1 : 2);
+			t = t_max[axis];
+			cell[axis] += step[axis];
+			t_max[axis] += t_delta[axis];
+		}
+		return false;
+	}
+
+	void RaycastBatch(const RayBatch& rays, const ChunkLookup& lookup, VoxelHits& hits) {
+		ZoneScoped;
+		hits.Reset(rays.Size());
+#if SIMD_SSE >= ENCODE_VERSION(2, 0, 0)
+		using float4 = zm::simd<float, 4>;
+		const float4 zero(0.f), one(1.f), infinity(std::numeric_limits<float>::infinity());
+		alignas(16) float unloaded[4];
+		alignas(16) float distances[4];
+		BlockSampler samplers[4] = { BlockSampler(lookup), BlockSampler(lookup), BlockSampler(lookup), BlockSampler(lookup) };
+
+		for (size_t i = 0; i < rays.Size(); i += RayBatch::PACKET_SIZE) {
+			// Boundary distances are stepped in SIMD, while each lane keeps its block position as integers for sampling
+			float4 t_delta[3], t_max[3];
+			zm::ivec3 cells[4], steps[4];
+			for (int a = 0; a < 3; a++) {
+				const float4 origin(rays.GetOrigins(a) + i), direction(rays.GetDirections(a) + i);
+				const float4 positive = direction > zero, negative = direction < zero, moving = positive | negative;
+				const float4 cell = zm::floor(origin);
+				t_delta[a] = zm::abs(float4(rays.GetInvDirections(a) + i));
+				// Axes the ray does not move along never reach a boundary. Masking them out also discards the NaN of 0 * infinity
+				const float4 boundary = ((cell + one - origin) & positive) | ((origin - cell) & negative);
+				t_max[a] = ((boundary * t_delta[a]) & moving) | zm::and_not(moving, infinity);
+
+				cell.unload_aligned(unloaded);
+				uint32_t forward = zm::mask(positive), backward = zm::mask(negative);
+				for (int lane = 0; lane < 4; lane++) {
+					cells[lane][a] = static_cast<int32_t>(unloaded[lane]);
+					steps[lane][a] = ((forward >> lane) & 1) - static_cast<int32_t>((backward >> lane) & 1);
+				}
+			}
+			const float4 limit(rays.GetMaxDistances() + i);
+			float4 t = zero;
+			int axes[4] = { -1, -1, -1, -1 };
+			uint32_t active = (rays.Size() - i >= 4 ? 0xF : (1u << (rays.Size() - i)) - 1u) & zm::mask(t <= limit);
+
+			while (active) {
+				bool unloaded_distances = false;
+				for (uint32_t bits = active; bits; bits &= bits - 1) {
+					uint32_t lane = std::countr_zero(bits);
+					block_t block = samplers[lane].Get(cells[lane]);
+					if (block == AIR)
+						continue;
+					if (!unloaded_distances) {
+						t.unload_aligned(distances);
+						unloaded_distances = true;
+					}
+					zm::ivec3 normal(0);
+					if (axes[lane] >= 0)
+						normal[axes[lane]] = -steps[lane][axes[lane]];
+					Record(hits, static_cast<uint32_t>(i + lane), { cells[lane], normal, distances[lane], block });
+					active &= ~(1u << lane);
+				}
+
+				// Every lane steps across whichever of its boundaries is nearest
+				const float4 t_next = zm::min(t_max[0], zm::min(t_max[1], t_max[2]));
+				const float4 step_x = t_max[0] == t_next;
+				const float4 step_y = zm::and_not(step_x, t_max[1] == t_next);
+				const float4 step_z = zm::and_not(step_x | step_y, t_max[2] == t_next);
+				t_max[0] += t_delta[0] & step_x;
+				t_max[1] += t_delta[1] & step_y;
+				t_max[2] += t_delta[2] & step_z;
+				t = t_next;
+				active &= zm::mask(t <= limit);
+
+				const uint32_t x_bits = zm::mask(step_x), y_bits = zm::mask(step_y);
+				for (uint32_t bits = active; bits; bits &= bits - 1) {
+					uint32_t lane = std::countr_zero(bits);
+					int axis = (x_bits >> lane) & 1 ? 0 : ((y_bits >> lane) & 1 ? 1 : 2);
+					cells[lane][axis] += steps[lane][axis];
+					axes[lane] = axis;
+				}
+			}
+		}
+#else
+		for (uint32_t ray = 0; ray < rays.Size(); ray++) {
+			VoxelHit hit;
+			if (Raycast(rays.GetOrigin(ray), rays.GetDirection(ray), rays.GetMaxDistance(ray), lookup, hit))
+				Record(hits, ray, hit);
+		}
+#endif
+	}
+
+	bool Sweep(const AABB3D& box, const zm::vec3& displacement, const ChunkLookup& lookup, VoxelHit& hit) {
+		// Boxes that only touch a block face do not count as inside the block's layer
+		static constexpr float EPSILON = 1e-4f;
+		BlockSampler sampler(lookup);
+		zm::ivec3 step, lead;
+		zm::vec3 t_delta, t_max;
+		for (int i = 0; i < 3; i++) {
+			// Only the leading face of the box can enter new blocks. lead is the last layer of blocks it already covers
+			step[i] = displacement[i] > 0.f ? 1 : (displacement[i] < 0.f ? -1 : 0);
+			t_delta[i] = std::abs(1.f / displacement[i]);
+			if (step[i] > 0) {
+				lead[i] = static_cast<int32_t>(std::ceil(box.GetMax()[i] - EPSILON)) - 1;
+				t_max[i] = (static_cast<float>(lead[i] + 1) - box.GetMax()[i]) * t_delta[i];
+			}
+			else if (step[i] < 0) {
+				lead[i] = static_cast<int32_t>(std::floor(box.GetMin()[i] + EPSILON));
+				t_max[i] = (box.GetMin()[i] - static_cast<float>(lead[i])) * t_delta[i];
+			}
+			else {
+				t_max[i] = std::numeric_limits<float>::infinity();
+			}
+		}
+
+		while (true) {
+			int axis = t_max.x <= t_max.y && t_max.x <= t_max.z ? 0 : (t_max.y <= t_max.z ? 1 : 2);
+			float t = zm::Max(t_max[axis], 0.f);
+			if (t > 1.f)
+				return false;
+			lead[axis] += step[axis];
+			t_max[axis] += t_delta[axis];
+
+			// Test the new layer of blocks across the box's cross section at the time it is entered
+			const zm::vec3 offset = displacement * zm::vec3(t);
+			const int u = (axis + 1) % 3;
+			const int v = (axis + 2) % 3;
+			const int32_t min_u = static_cast<int32_t>(std::floor(box.GetMin()[u] + offset[u] + EPSILON));
+			const int32_t max_u = static_cast<int32_t>(std::ceil(box.GetMax()[u] + offset[u] - EPSILON)) - 1;
+			const int32_t min_v = static_cast<int32_t>(std::floor(box.GetMin()[v] + offset[v] + EPSILON));
+			const int32_t max_v = static_cast<int32_t>(std::ceil(box.GetMax()[v] + offset[v] - EPSILON)) - 1;
+			zm::ivec3 position;
+			position[axis] = lead[axis];
+			for (position[u] = min_u; position[u] <= max_u; position[u]++) {
+				for (position[v] = min_v; position[v] <= max_v; position[v]++) {
+					block_t block = sampler.Get(position);
+					if (block == AIR)
+						continue;
+					zm::ivec3 normal(0);
+					normal[axis] = -step[axis];
+					hit = { position, normal, t, block };
+					return true;
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "zore/voxel/chunk.hpp"
+#include "zore/physics/ray_batch.hpp"
+#include "zore/physics/aabb.hpp"
+#include <functional>
+
+namespace zore::voxel {
+
+	//========================================================================
+	//	Voxel Ray Casting
+	//========================================================================
+
+	// Returns the chunk at the given chunk coordinate, or nullptr if it is not loaded. Missing chunks are treated as air
+	using ChunkLookup = std::function<const Chunk*(const zm::ivec3&)>;
+
+	// Samples blocks by world position, caching the last chunk looked up since consecutive samples rarely leave it
+	class BlockSampler {
+	public:
+		explicit BlockSampler(const ChunkLookup& lookup) : m_lookup(lookup), m_chunk(nullptr), m_coord(0), m_valid(false) {}
+
+		block_t Get(const zm::ivec3& position) {
+			zm::ivec3 coord = position >> Chunk::SIZE_BITS;
+			if (!m_valid || coord != m_coord) {
+				m_chunk = m_lookup(coord);
+				m_coord = coord;
+				m_valid = true;
+			}
+			if (!m_chunk)
+				return AIR;
+			const int32_t mask = Chunk::SIZE - 1;
+			return m_chunk->GetStorage().Get(Chunk::Index(position.x & mask, position.y & mask, position.z & mask));
+		}
+
+	private:
+		const ChunkLookup& m_lookup;
+		const Chunk* m_chunk;
+		zm::ivec3 m_coord;
+		bool m_valid;
+	};
+
+	struct VoxelHit {
+		zm::ivec3 position;
+		// Points out of the face the ray entered through, and is zero if the ray started inside a solid block
+		zm::ivec3 normal;
+		float distance;
+		block_t block;
+	};
+
+	// The first solid block hit by each ray in a batch, stored as separate arrays. Misses have a block of AIR
+	struct VoxelHits {
+		std::vector<float> distance;
+		std::vector<block_t> block;
+		std::vector<int32_t> position[3];
+		std::vector<int8_t> normal[3];
+
+		// Resizes to {count} rays, and marks every ray as a miss
+		void Reset(size_t count);
+
+		size_t Size() const { return block.size(); }
+		bool IsHit(uint32_t index) const { return block[index] != AIR; }
+		VoxelHit Get(uint32_t index) const;
+	};
+
+	// Walks the blocks along the ray with a 3D DDA, and returns true once a solid block is hit within max_distance. Block coordinates
+	// are in world space, with chunk (0, 0, 0) covering blocks [0, Chunk::SIZE)
+	bool Raycast(const zm::vec3& origin, const zm::vec3& direction, float max_distance, const ChunkLookup& lookup, VoxelHit& hit);
+
+	// Casts a packet of four rays at a time, stepping every lane of the packet together
+	void RaycastBatch(const RayBatch& rays, const ChunkLookup& lookup, VoxelHits& hits);
+
+	// Sweeps box by {displacement}, walking the layers of blocks its leading faces cross, and returns true if it hits a solid block.
+	// The hit distance is the fraction of the displacement covered before contact. Blocks the box already overlaps are ignored
+	bool Sweep(const AABB3D& box, const zm::vec3& displacement, const ChunkLookup& lookup, VoxelHit& hit);
+}
\ No newline at end of file